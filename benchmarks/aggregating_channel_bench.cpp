@@ -0,0 +1,79 @@
+#include "bench.h"
+#include <channels/aggregating_channel.h>
+#include <channels/connection.h>
+#include <channels/continuation_status.h>
+#include <channels/future.h>
+#include <channels/transmitter.h>
+#include <channels/utility/executors.h>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace channels {
+namespace bench {
+namespace {
+
+class sum_aggregator {
+public:
+	continuation_status apply_result(const int result) noexcept
+	{
+		sum_ += result;
+		return continuation_status::to_continue;
+	}
+
+	continuation_status apply_exception(std::exception_ptr) noexcept // NOLINT(performance-unnecessary-value-param)
+	{
+		return continuation_status::to_continue;
+	}
+
+	int get_sum() const noexcept
+	{
+		return sum_;
+	}
+
+private:
+	int sum_ = 0;
+};
+
+constexpr std::size_t subscribers_number = 10;
+
+} // namespace
+
+void run_aggregating_channel_benchmarks(suite& s)
+{
+	using channel_type = aggregating_channel<int(int)>;
+
+	const std::string inline_name =
+		"aggregating_channel::send/inline_executor/subscribers:" + std::to_string(subscribers_number);
+	if (s.is_enabled(inline_name)) {
+		transmitter<channel_type> transmitter;
+		std::vector<connection> connections;
+		for (std::size_t i = 0; i < subscribers_number; ++i) {
+			connections.push_back(
+				transmitter.get_channel().connect(utility::inline_executor{}, [](const int value) { return value; }));
+		}
+
+		s.run(inline_name, [&transmitter] {
+			do_not_optimize(transmitter.send(sum_aggregator{}, 1, embedded_promise<sum_aggregator>{}).get().get_sum());
+		});
+	}
+
+	const std::string deferred_name =
+		"aggregating_channel::send/deferred_executor/subscribers:" + std::to_string(subscribers_number);
+	if (s.is_enabled(deferred_name)) {
+		transmitter<channel_type> transmitter;
+		queue_executor executor;
+		std::vector<connection> connections;
+		for (std::size_t i = 0; i < subscribers_number; ++i)
+			connections.push_back(transmitter.get_channel().connect(&executor, [](const int value) { return value; }));
+
+		s.run(deferred_name, [&transmitter, &executor] {
+			auto future = transmitter.send(sum_aggregator{}, 1, embedded_promise<sum_aggregator>{});
+			executor.run_all_tasks();
+			do_not_optimize(future.get().get_sum());
+		});
+	}
+}
+
+} // namespace bench
+} // namespace channels
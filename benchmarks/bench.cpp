@@ -0,0 +1,135 @@
+#include "bench.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace channels {
+namespace bench {
+namespace {
+
+thread_local std::size_t allocations_number = 0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+constexpr std::chrono::nanoseconds min_sample_duration = std::chrono::milliseconds{1};
+constexpr std::size_t samples_number = 50;
+
+double percentile(const std::vector<double>& sorted_values, const double p)
+{
+	const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted_values.size() - 1) + 0.5);
+	return sorted_values[index];
+}
+
+void print_json_string(const std::string& value)
+{
+	std::putchar('"');
+	for (const char c : value) {
+		if (c == '"' || c == '\\')
+			std::putchar('\\');
+		std::putchar(c);
+	}
+	std::putchar('"');
+}
+
+} // namespace
+
+std::size_t get_allocations_number() noexcept
+{
+	return allocations_number;
+}
+
+// suite
+
+suite::suite(std::string filter)
+	: filter_{std::move(filter)}
+{}
+
+bool suite::is_enabled(const std::string& name) const
+{
+	return name.find(filter_) != std::string::npos;
+}
+
+void suite::run_batches(const std::string& name, const batch_function_type& batch)
+{
+	using clock_type = std::chrono::steady_clock;
+
+	const auto measure = [&batch](const std::size_t iterations) {
+		const auto start = clock_type::now();
+		batch(iterations);
+		return clock_type::now() - start;
+	};
+
+	// warm up and choose the number of iterations per sample
+	std::size_t iterations_per_sample = 1;
+	while (measure(iterations_per_sample) < min_sample_duration)
+		iterations_per_sample *= 2;
+
+	// the samples are reserved before, so the measured loop doesn't allocate memory by itself
+	std::vector<double> samples;
+	samples.reserve(samples_number);
+	clock_type::duration total_duration{};
+	const std::size_t allocations_before = get_allocations_number();
+	for (std::size_t i = 0; i < samples_number; ++i) {
+		const auto duration = measure(iterations_per_sample);
+		total_duration += duration;
+		samples.push_back(
+			static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) /
+			static_cast<double>(iterations_per_sample));
+	}
+	const std::size_t allocations = get_allocations_number() - allocations_before;
+
+	std::sort(samples.begin(), samples.end());
+	const std::size_t iterations = iterations_per_sample * samples_number;
+	const double total_ns =
+		static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(total_duration).count());
+
+	std::fputs("{\"name\": ", stdout);
+	print_json_string(name);
+	std::printf(
+		", \"iterations\": %zu, \"ns_per_op\": %.2f, \"allocations_per_op\": %.3f"
+		", \"p50_ns\": %.2f, \"p90_ns\": %.2f, \"p99_ns\": %.2f}\n",
+		iterations,
+		total_ns / static_cast<double>(iterations),
+		static_cast<double>(allocations) / static_cast<double>(iterations),
+		percentile(samples, 0.5),
+		percentile(samples, 0.9),
+		percentile(samples, 0.99));
+	std::fflush(stdout);
+}
+
+// queue_executor
+
+void queue_executor::dispatch(task_type task)
+{
+	tasks_.push_back(std::move(task));
+}
+
+void queue_executor::run_all_tasks()
+{
+	for (const task_type& task : tasks_)
+		task();
+	tasks_.clear();
+}
+
+} // namespace bench
+} // namespace channels
+
+// allocations counting
+
+void* operator new(const std::size_t size)
+{
+	++channels::bench::allocations_number;
+	if (void* const memory = std::malloc(size == 0 ? 1 : size))
+		return memory;
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* const memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* const memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
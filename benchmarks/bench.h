@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace channels {
+namespace bench {
+
+// Returns the number of memory allocations made by the current thread (global operator new is replaced by the
+// benchmark executable).
+std::size_t get_allocations_number() noexcept;
+
+// Prevents the compiler from optimizing away the computation of the `value`.
+template<typename T>
+void do_not_optimize(const T& value) noexcept;
+
+// This class runs benchmarks and prints their results to the standard output in JSON Lines format (one JSON object
+// per benchmark):
+// {"name": "...", "iterations": N, "ns_per_op": X, "allocations_per_op": X, "p50_ns": X, "p90_ns": X, "p99_ns": X}
+// `ns_per_op` and `allocations_per_op` are averaged over all iterations. Percentiles are calculated over samples: each
+// sample is a batch of iterations that runs at least `min_sample_duration`.
+class suite {
+public:
+	// Runs only the benchmarks whose names contain `filter`.
+	explicit suite(std::string filter);
+
+	// Returns true if the benchmark with the `name` is selected by the filter. Use it to skip expensive preparation.
+	bool is_enabled(const std::string& name) const;
+
+	// Measures the `operation` (a function without arguments which performs one operation) and prints the result.
+	template<typename Operation>
+	void run(const std::string& name, Operation&& operation);
+
+private:
+	using batch_function_type = std::function<void(std::size_t iterations)>;
+
+	void run_batches(const std::string& name, const batch_function_type& batch);
+
+	std::string filter_;
+};
+
+// Executor that queues the tasks until `run_all_tasks` is called in the same thread.
+class queue_executor {
+public:
+	using task_type = std::function<void()>;
+
+	void dispatch(task_type task);
+	void run_all_tasks();
+
+private:
+	std::vector<task_type> tasks_;
+};
+
+template<typename Task>
+void execute(queue_executor* const executor, Task&& task)
+{
+	executor->dispatch(std::forward<Task>(task));
+}
+
+// benchmarks registration
+void run_channel_benchmarks(suite& s);
+void run_buffered_channel_benchmarks(suite& s);
+void run_keyed_channel_benchmarks(suite& s);
+void run_aggregating_channel_benchmarks(suite& s);
+void run_queue_channel_benchmarks(suite& s);
+void run_ring_channel_benchmarks(suite& s);
+void run_shm_buffered_channel_benchmarks(suite& s);
+void run_static_channel_benchmarks(suite& s);
+void run_recorder_benchmarks(suite& s);
+void run_transponder_benchmarks(suite& s);
+void run_sync_tracker_benchmarks(suite& s);
+
+// implementation
+
+template<typename T>
+void do_not_optimize(const T& value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__asm__ __volatile__("" : : "r,m"(value) : "memory");
+#else
+	static const void* volatile sink = nullptr;
+	sink = &value;
+#endif
+}
+
+template<typename Operation>
+void suite::run(const std::string& name, Operation&& operation)
+{
+	if (!is_enabled(name))
+		return;
+
+	run_batches(name, [&operation](const std::size_t iterations) {
+		for (std::size_t i = 0; i < iterations; ++i)
+			operation();
+	});
+}
+
+} // namespace bench
+} // namespace channels
@@ -0,0 +1,63 @@
+#include "bench.h"
+#include <channels/buffered_channel.h>
+#include <channels/transmitter.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace channels {
+namespace bench {
+
+namespace {
+
+using channel_type = buffered_channel<int>;
+
+template<typename Read>
+void run_reading_benchmark(suite& s, const std::string& prefix, const std::size_t readers_number, const Read& read)
+{
+	const std::string name = prefix + std::to_string(readers_number);
+	if (!s.is_enabled(name))
+		return;
+
+	transmitter<channel_type> transmitter;
+	const channel_type& channel = transmitter.get_channel();
+	transmitter.send(1);
+
+	// background readers contend with the measured thread
+	std::atomic<bool> stop{false};
+	std::vector<std::thread> readers;
+	for (std::size_t i = 0; i < readers_number; ++i) {
+		readers.emplace_back([&channel, &stop, &read] {
+			while (!stop.load(std::memory_order_relaxed))
+				read(channel);
+		});
+	}
+
+	s.run(name, [&channel, &read] { read(channel); });
+
+	stop = true;
+	for (std::thread& reader : readers)
+		reader.join();
+}
+
+} // namespace
+
+void run_buffered_channel_benchmarks(suite& s)
+{
+	const auto get_value = [](const channel_type& channel) { do_not_optimize(channel.get_value()); };
+	const auto read_value = [](const channel_type& channel) {
+		std::tuple<int> value;
+		do_not_optimize(channel.read_value(value));
+		do_not_optimize(value);
+	};
+
+	for (const std::size_t readers_number : {0u, 1u, 4u}) {
+		run_reading_benchmark(s, "buffered_channel::get_value/readers:", readers_number, get_value);
+		run_reading_benchmark(s, "buffered_channel::read_value/readers:", readers_number, read_value);
+	}
+}
+
+} // namespace bench
+} // namespace channels
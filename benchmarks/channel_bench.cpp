@@ -0,0 +1,134 @@
+#include "bench.h"
+#include <channels/channel.h>
+#include <channels/connection.h>
+#include <channels/error_policy.h>
+#include <channels/threading_policy.h>
+#include <channels/transmitter.h>
+#include <channels/utility/executors.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace channels {
+namespace bench {
+namespace {
+
+struct nothrow_value {
+	int value;
+};
+
+struct loop_value {
+	int value;
+};
+
+} // namespace
+} // namespace bench
+
+template<>
+struct error_policy_traits<channel<bench::nothrow_value>> {
+	using type = policy::nothrow;
+};
+
+template<>
+struct threading_policy_traits<channel<bench::loop_value>> {
+	using type = policy::single_thread;
+};
+
+namespace bench {
+
+void run_channel_benchmarks(suite& s)
+{
+	using channel_type = channel<int>;
+
+	for (const std::size_t subscribers_number : {0u, 1u, 10u, 1000u}) {
+		const std::string name = "channel::send/subscribers:" + std::to_string(subscribers_number);
+		if (!s.is_enabled(name))
+			continue;
+
+		transmitter<channel_type> transmitter;
+		int sum = 0;
+		std::vector<connection> connections;
+		for (std::size_t i = 0; i < subscribers_number; ++i)
+			connections.push_back(transmitter.get_channel().connect([&sum](const int value) { sum += value; }));
+
+		s.run(name, [&transmitter] { transmitter.send(1); });
+		do_not_optimize(sum);
+	}
+
+	const std::string nothrow_name = "channel::send/nothrow_policy/subscribers:10";
+	if (s.is_enabled(nothrow_name)) {
+		transmitter<channel<nothrow_value>> transmitter;
+		int sum = 0;
+		std::vector<connection> connections;
+		for (std::size_t i = 0; i < 10; ++i) {
+			connections.push_back(
+				transmitter.get_channel().connect([&sum](const nothrow_value& v) noexcept { sum += v.value; }));
+		}
+
+		s.run(nothrow_name, [&transmitter] { transmitter.send(nothrow_value{1}); });
+		do_not_optimize(sum);
+	}
+
+	const std::string single_thread_name = "channel::send/single_thread_policy/subscribers:10";
+	if (s.is_enabled(single_thread_name)) {
+		transmitter<channel<loop_value>> transmitter;
+		int sum = 0;
+		std::vector<connection> connections;
+		for (std::size_t i = 0; i < 10; ++i)
+			connections.push_back(transmitter.get_channel().connect([&sum](const loop_value& v) { sum += v.value; }));
+
+		s.run(single_thread_name, [&transmitter] { transmitter.send(loop_value{1}); });
+		do_not_optimize(sum);
+	}
+
+	const std::string thread_pool_name = "channel::send/thread_pool_executor/subscribers:10";
+	if (s.is_enabled(thread_pool_name)) {
+		transmitter<channel_type> transmitter;
+		std::atomic<int> sum{0};
+		// the measured thread isn't a worker, so only the wrapping and queueing of tasks is counted
+		thread_pool_executor executor{2};
+		std::vector<connection> connections;
+		for (std::size_t i = 0; i < 10; ++i) {
+			connections.push_back(transmitter.get_channel().connect(
+				&executor, [&sum](const int value) { sum.fetch_add(value, std::memory_order_relaxed); }));
+		}
+
+		s.run(thread_pool_name, [&transmitter] { transmitter.send(1); });
+		do_not_optimize(sum.load());
+	}
+
+	const std::string conflated_name = "channel::send/conflated/thread_pool_executor/subscribers:10";
+	if (s.is_enabled(conflated_name)) {
+		transmitter<channel_type> transmitter;
+		std::atomic<int> sum{0};
+		thread_pool_executor executor{2};
+		std::vector<connection> connections;
+		for (std::size_t i = 0; i < 10; ++i) {
+			connections.push_back(transmitter.get_channel().connect_conflated(
+				&executor, [&sum](const int value) { sum.fetch_add(value, std::memory_order_relaxed); }));
+		}
+
+		s.run(conflated_name, [&transmitter] { transmitter.send(1); });
+		do_not_optimize(sum.load());
+	}
+
+	for (const std::size_t subscribers_number : {0u, 10u}) {
+		const std::string name = "channel::connect+disconnect/subscribers:" + std::to_string(subscribers_number);
+		if (!s.is_enabled(name))
+			continue;
+
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		std::vector<connection> connections;
+		for (std::size_t i = 0; i < subscribers_number; ++i)
+			connections.push_back(channel.connect([](int) {}));
+
+		s.run(name, [&channel] {
+			connection connection = channel.connect([](int) {});
+			connection.disconnect();
+		});
+	}
+}
+
+} // namespace bench
+} // namespace channels
@@ -0,0 +1,61 @@
+#include "bench.h"
+#include <channels/channel.h>
+#include <channels/connection.h>
+#include <channels/keyed_channel.h>
+#include <channels/transmitter.h>
+#include <string>
+#include <vector>
+
+namespace channels {
+namespace bench {
+
+void run_keyed_channel_benchmarks(suite& s)
+{
+	for (const int keys_number : {10, 1000, 100000}) {
+		const std::string name = "keyed_channel::send/keys:" + std::to_string(keys_number);
+		if (!s.is_enabled(name))
+			continue;
+
+		transmitter<keyed_channel<int, int>> transmitter;
+		int sum = 0;
+		std::vector<connection> connections;
+		for (int key = 0; key < keys_number; ++key)
+			connections.push_back(transmitter.get_channel().connect(key, [&sum](const int value) { sum += value; }));
+
+		int key = 0;
+		s.run(name, [&transmitter, &key, keys_number] {
+			transmitter.send(key, 1);
+			if (++key == keys_number)
+				key = 0;
+		});
+		do_not_optimize(sum);
+	}
+
+	// the alternative to keyed_channel: each subscriber filters the values of its key
+	for (const int keys_number : {10, 1000}) {
+		const std::string name = "channel::send/filtered_keys:" + std::to_string(keys_number);
+		if (!s.is_enabled(name))
+			continue;
+
+		transmitter<channel<int, int>> transmitter;
+		int sum = 0;
+		std::vector<connection> connections;
+		for (int key = 0; key < keys_number; ++key) {
+			connections.push_back(transmitter.get_channel().connect([&sum, key](const int value_key, const int value) {
+				if (value_key == key)
+					sum += value;
+			}));
+		}
+
+		int key = 0;
+		s.run(name, [&transmitter, &key, keys_number] {
+			transmitter.send(key, 1);
+			if (++key == keys_number)
+				key = 0;
+		});
+		do_not_optimize(sum);
+	}
+}
+
+} // namespace bench
+} // namespace channels
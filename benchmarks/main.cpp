@@ -0,0 +1,21 @@
+#include "bench.h"
+#include <string>
+
+// Usage: channels_bench [filter]
+// Runs the benchmarks whose names contain the filter substring (all benchmarks by default).
+int main(const int argc, const char* const argv[])
+{
+	channels::bench::suite suite{argc > 1 ? argv[1] : ""}; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+	channels::bench::run_channel_benchmarks(suite);
+	channels::bench::run_buffered_channel_benchmarks(suite);
+	channels::bench::run_keyed_channel_benchmarks(suite);
+	channels::bench::run_aggregating_channel_benchmarks(suite);
+	channels::bench::run_queue_channel_benchmarks(suite);
+	channels::bench::run_ring_channel_benchmarks(suite);
+	channels::bench::run_shm_buffered_channel_benchmarks(suite);
+	channels::bench::run_static_channel_benchmarks(suite);
+	channels::bench::run_recorder_benchmarks(suite);
+	channels::bench::run_transponder_benchmarks(suite);
+	channels::bench::run_sync_tracker_benchmarks(suite);
+}
@@ -0,0 +1,66 @@
+#include "bench.h"
+#include <channels/queue_channel.h>
+#include <channels/transmitter.h>
+#include <atomic>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace channels {
+namespace bench {
+
+void run_queue_channel_benchmarks(suite& s)
+{
+	using channel_type = queue_channel<int>;
+
+	{
+		transmitter<channel_type> transmitter{1024u};
+		const channel_type& channel = transmitter.get_channel();
+
+		s.run("queue_channel::send+try_receive", [&transmitter, &channel] {
+			std::tuple<int> value;
+			do_not_optimize(transmitter.send(1));
+			do_not_optimize(channel.try_receive(value));
+			do_not_optimize(value);
+		});
+	}
+
+	const std::string consumer_name = "queue_channel::send/consumer:receive_batch";
+	if (s.is_enabled(consumer_name)) {
+		transmitter<channel_type> transmitter{1024u};
+		const channel_type& channel = transmitter.get_channel();
+
+		// the consumer drains the queue in batches, a negative value stops it
+		std::atomic<long long> sum{0};
+		std::thread consumer{[&channel, &sum] {
+			std::vector<std::tuple<int>> values;
+			long long local_sum = 0;
+			for (;;) {
+				values.clear();
+				channel.receive_batch(std::back_inserter(values), 64);
+				for (const std::tuple<int>& value : values) {
+					if (std::get<0>(value) < 0) {
+						sum.store(local_sum, std::memory_order_relaxed);
+						return;
+					}
+					local_sum += std::get<0>(value);
+				}
+			}
+		}};
+
+		s.run(consumer_name, [&transmitter] {
+			while (!transmitter.send(1))
+				std::this_thread::yield();
+		});
+
+		while (!transmitter.send(-1))
+			std::this_thread::yield();
+		consumer.join();
+		do_not_optimize(sum.load());
+	}
+}
+
+} // namespace bench
+} // namespace channels
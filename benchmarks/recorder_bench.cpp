@@ -0,0 +1,35 @@
+#include "bench.h"
+#include <channels/channel.h>
+#include <channels/transmitter.h>
+#include <channels/utility/recorder.h>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+namespace channels {
+namespace bench {
+
+void run_recorder_benchmarks(suite& s)
+{
+#ifdef CHANNELS_HAS_MMAP
+	using channel_type = channel<int, double>;
+
+	const std::string name = "channel::send/recorder";
+	if (s.is_enabled(name)) {
+		const std::string path = "/tmp/channels_bench_" + std::to_string(getpid()) + ".log";
+		{
+			transmitter<channel_type> transmitter;
+			// the values that don't fit in the file are dropped, so only the staging in the sender's thread is measured
+			const recorder<trivial_codec<int, double>> recorder{transmitter.get_channel(), path, 64u << 20u};
+
+			s.run(name, [&transmitter] { transmitter.send(1, 1.0); });
+		}
+		std::remove(path.c_str());
+	}
+#else
+	(void) s;
+#endif
+}
+
+} // namespace bench
+} // namespace channels
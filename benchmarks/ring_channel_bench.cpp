@@ -0,0 +1,60 @@
+#include "bench.h"
+#include <channels/ring_channel.h>
+#include <channels/transmitter.h>
+#include <atomic>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace channels {
+namespace bench {
+
+void run_ring_channel_benchmarks(suite& s)
+{
+	using channel_type = ring_channel<int, 1024>;
+
+	{
+		transmitter<channel_type> transmitter;
+		channel_type::reader reader = transmitter.get_channel().make_reader();
+
+		s.run("ring_channel::send+try_read", [&transmitter, &reader] {
+			int value = 0;
+			transmitter.send(1);
+			do_not_optimize(reader.try_read(value));
+			do_not_optimize(value);
+		});
+	}
+
+	const std::string reader_name = "ring_channel::send/reader:read_batch";
+	if (s.is_enabled(reader_name)) {
+		transmitter<channel_type> transmitter;
+
+		// the reader follows the transmitter in batches, a negative value stops it
+		std::atomic<long long> sum{0};
+		std::thread reader_thread{[reader = transmitter.get_channel().make_reader(), &sum]() mutable {
+			std::vector<int> values;
+			long long local_sum = 0;
+			for (;;) {
+				values.clear();
+				reader.read_batch(std::back_inserter(values), 64);
+				for (const int value : values) {
+					if (value < 0) {
+						sum.store(local_sum, std::memory_order_relaxed);
+						return;
+					}
+					local_sum += value;
+				}
+			}
+		}};
+
+		s.run(reader_name, [&transmitter] { transmitter.send(1); });
+
+		transmitter.send(-1);
+		reader_thread.join();
+		do_not_optimize(sum.load());
+	}
+}
+
+} // namespace bench
+} // namespace channels
@@ -0,0 +1,37 @@
+#include "bench.h"
+#include <channels/shm_buffered_channel.h>
+#include <channels/transmitter.h>
+#include <string>
+#include <unistd.h>
+
+namespace channels {
+namespace bench {
+
+void run_shm_buffered_channel_benchmarks(suite& s)
+{
+#ifdef CHANNELS_HAS_SHARED_MEMORY
+	struct snapshot {
+		long long id;
+		double values[6];
+	};
+	using channel_type = shm_buffered_channel<snapshot>;
+
+	const std::string name = "/channels_bench_" + std::to_string(getpid());
+	transmitter<channel_type> transmitter{name};
+	const channel_type channel{name};
+	transmitter.send(snapshot{});
+
+	s.run("shm_buffered_channel::send", [&transmitter] { transmitter.send(snapshot{1, {}}); });
+
+	s.run("shm_buffered_channel::read_value", [&channel] {
+		snapshot value{};
+		do_not_optimize(channel.read_value(value));
+		do_not_optimize(value);
+	});
+#else
+	(void) s;
+#endif
+}
+
+} // namespace bench
+} // namespace channels
@@ -0,0 +1,30 @@
+#include "bench.h"
+#include <channels/connection.h>
+#include <channels/static_channel.h>
+#include <channels/transmitter.h>
+#include <string>
+#include <vector>
+
+namespace channels {
+namespace bench {
+
+void run_static_channel_benchmarks(suite& s)
+{
+	for (const std::size_t subscribers_number : {1u, 10u}) {
+		const std::string name = "static_channel::send/subscribers:" + std::to_string(subscribers_number);
+		if (!s.is_enabled(name))
+			continue;
+
+		transmitter<static_channel<16, int>> transmitter;
+		int sum = 0;
+		std::vector<static_connection> connections;
+		for (std::size_t i = 0; i < subscribers_number; ++i)
+			connections.push_back(transmitter.get_channel().connect([&sum](const int value) { sum += value; }));
+
+		s.run(name, [&transmitter] { transmitter.send(1); });
+		do_not_optimize(sum);
+	}
+}
+
+} // namespace bench
+} // namespace channels
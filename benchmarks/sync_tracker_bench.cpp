@@ -0,0 +1,19 @@
+#include "bench.h"
+#include <channels/utility/sync_tracker.h>
+
+namespace channels {
+namespace bench {
+
+void run_sync_tracker_benchmarks(suite& s)
+{
+	const utility::sync_tracker tracker;
+	const utility::sync_tracker::tracked_object tracked_object = tracker.get_tracked_object();
+
+	s.run("sync_tracker::tracked_object::lock", [&tracked_object] {
+		const auto lock = tracked_object.lock();
+		do_not_optimize(static_cast<bool>(lock));
+	});
+}
+
+} // namespace bench
+} // namespace channels
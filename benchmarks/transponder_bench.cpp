@@ -0,0 +1,63 @@
+#include "bench.h"
+#include <channels/channel.h>
+#include <channels/connection.h>
+#include <channels/transmitter.h>
+#include <channels/utility/pipeline.h>
+#include <channels/utility/transponder.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace channels {
+namespace bench {
+
+void run_transponder_benchmarks(suite& s)
+{
+	using channel_type = channel<int>;
+	using transponder_type = transponder<channel_type>;
+
+	for (const std::size_t chain_length : {1u, 4u}) {
+		const std::string name = "transponder::send/chain:" + std::to_string(chain_length);
+		if (!s.is_enabled(name))
+			continue;
+
+		transmitter<channel_type> source;
+		// transponders are not movable after they are connected, so they are kept by pointers
+		std::vector<std::unique_ptr<transponder_type>> chain;
+		const channel_type* last_channel = &source.get_channel();
+		for (std::size_t i = 0; i < chain_length; ++i) {
+			chain.push_back(std::make_unique<transponder_type>(
+				*last_channel,
+				[](transponder_type::transmitter_type& transmitter, const int value) { transmitter.send(value + 1); }));
+			last_channel = &chain.back()->get_channel();
+		}
+
+		int sum = 0;
+		const connection connection = last_channel->connect([&sum](const int value) { sum += value; });
+
+		s.run(name, [&source] { source.send(1); });
+		do_not_optimize(sum);
+	}
+
+	// the same chain of 4 stages fused into one callback function
+	const std::string pipeline_name = "pipeline::send/stages:4";
+	if (s.is_enabled(pipeline_name)) {
+		transmitter<channel_type> source;
+		const auto increment = [](const int value) { return value + 1; };
+		const transponder_type destination = source.get_channel()
+			| transform(increment)
+			| transform(increment)
+			| transform(increment)
+			| transform(increment)
+			| into<channel_type>();
+
+		int sum = 0;
+		const connection connection = destination.get_channel().connect([&sum](const int value) { sum += value; });
+
+		s.run(pipeline_name, [&source] { source.send(1); });
+		do_not_optimize(sum);
+	}
+}
+
+} // namespace bench
+} // namespace channels
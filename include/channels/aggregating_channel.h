@@ -4,9 +4,12 @@
 #include "detail/compatibility/apply.h"
 #include "detail/compatibility/compile_features.h"
 #include "detail/future_shared_state.h"
+#include "future.h"
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <exception>
-#include <memory>
+#include <future>
 #include <mutex>
 #include <tuple>
 #include <type_traits>
@@ -19,6 +22,9 @@ namespace aggregating_channel_detail {
 template<typename R, typename... Ts>
 class execution_shared_state_interface;
 
+template<typename R, typename... Ts>
+class execution_reference;
+
 } // namespace aggregating_channel_detail
 
 #if __cpp_concepts
@@ -38,7 +44,7 @@ class aggregating_channel;
 /// \tparam Ts Types of parameters passed to callback functions.
 template<typename R, typename... Ts>
 class aggregating_channel<R(Ts...)>
-	: protected channel<std::shared_ptr<aggregating_channel_detail::execution_shared_state_interface<R, Ts...>>> {
+	: protected channel<aggregating_channel_detail::execution_reference<R, Ts...>> {
 
 	template<typename F>
 	friend bool operator==(const aggregating_channel<F>& lhs, const aggregating_channel<F>& rhs) noexcept; // NOLINT
@@ -46,7 +52,8 @@ class aggregating_channel<R(Ts...)>
 	friend bool operator!=(const aggregating_channel<F>& lhs, const aggregating_channel<F>& rhs) noexcept; // NOLINT
 
 	using execution_shared_state_interface = aggregating_channel_detail::execution_shared_state_interface<R, Ts...>;
-	using base_type = channel<std::shared_ptr<execution_shared_state_interface>>;
+	using execution_reference = aggregating_channel_detail::execution_reference<R, Ts...>;
+	using base_type = channel<execution_reference>;
 
 public:
 	/// Return value type of callback functions
@@ -81,13 +88,19 @@ protected:
 	/// \param aggregator Reference to the aggregator. Aggregator type must match the concept `ChannelAggregator`.
 	/// \param args Arguments to pass to the callback functions.
 	/// \param promise A std::promise like object that pass filled aggregator from the `aggregating_channel` to
-	///                the sender.
+	///                the sender. By default it is `std::promise` and the method returns `std::future`. Pass
+	///                `channels::embedded_promise` to keep the aggregator in the shared state of the sending: the
+	///                method returns `channels::future` and the sending requires one allocation.
 	/// \return Future to aggregator. When all callback functions in all executors are completed, the future will be
 	///         ready. If the aggregator throws an exception it will be returned to the future.
 	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
 	template<typename Aggregator, typename Promise = std::promise<std::decay_t<Aggregator>>>
 	CHANNELS_NODISCARD decltype(auto) send(Aggregator&& aggregator, Ts... args, Promise&& promise = {});
 
+	/// The aggregator collects the results of one sending, so the `aggregating_channel` doesn't support batches.
+	template<typename Range>
+	void send_batch(Range&& values) = delete;
+
 private:
 	template<typename Callback>
 	class aggregating_callback;
@@ -113,10 +126,31 @@ namespace aggregating_channel_detail {
 //                   |                                                     |                                              |
 // execution_shared_state<Aggregator, R, Ts...> -> execution_shared_state_result_base<Aggregator, R> -> execution_shared_state_base<Aggregator>
 
-struct execution_shared_state_interface_base {
-	virtual ~execution_shared_state_interface_base() = default;
+// The shared state is kept by intrusive references: each execution_reference (each copy of the sent value) and the
+// channels::future (if the promise is channels::embedded_promise) refer to it.
+struct execution_shared_state_interface_base : virtual detail::reference_counted {
 	virtual void apply_exception(std::exception_ptr callback_exception) = 0;
 	CHANNELS_NODISCARD virtual bool is_ready() const noexcept = 0;
+
+	void add_execution() noexcept
+	{
+		executions_number_.fetch_add(1, std::memory_order_relaxed);
+		add_reference();
+	}
+
+	void remove_execution() noexcept
+	{
+		if (executions_number_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			complete();
+		remove_reference();
+	}
+
+protected:
+	// It is called when all executions are completed (all callback functions are called or skipped).
+	virtual void complete() noexcept = 0;
+
+private:
+	std::atomic<std::size_t> executions_number_{0};
 };
 
 template<typename R>
@@ -149,8 +183,67 @@ protected:
 	{}
 };
 
+template<typename R, typename... Ts>
+class execution_reference {
+public:
+	explicit execution_reference(execution_shared_state_interface<R, Ts...>& shared_state) noexcept
+		: shared_state_{&shared_state}
+	{
+		shared_state_->add_execution();
+	}
+
+	execution_reference(const execution_reference& other) noexcept
+		: shared_state_{other.shared_state_}
+	{
+		if (shared_state_)
+			shared_state_->add_execution();
+	}
+
+	execution_reference(execution_reference&& other) noexcept
+		: shared_state_{std::exchange(other.shared_state_, nullptr)}
+	{}
+
+	execution_reference& operator=(const execution_reference& other) noexcept
+	{
+		execution_reference{other}.swap(*this);
+		return *this;
+	}
+
+	execution_reference& operator=(execution_reference&& other) noexcept
+	{
+		execution_reference{std::move(other)}.swap(*this);
+		return *this;
+	}
+
+	~execution_reference()
+	{
+		if (shared_state_)
+			shared_state_->remove_execution();
+	}
+
+	void swap(execution_reference& other) noexcept
+	{
+		std::swap(shared_state_, other.shared_state_);
+	}
+
+	CHANNELS_NODISCARD execution_shared_state_interface<R, Ts...>& operator*() const noexcept
+	{
+		assert(shared_state_); // NOLINT
+
+		return *shared_state_;
+	}
+
+private:
+	execution_shared_state_interface<R, Ts...>* shared_state_;
+};
+
 template<typename Aggregator, typename Promise>
-class execution_shared_state_base : public virtual execution_shared_state_interface_base {
+class execution_shared_state_base
+	: public virtual execution_shared_state_interface_base
+	, public detail::future_shared_state<Aggregator, Promise> {
+
+	using future_shared_state_type = detail::future_shared_state<Aggregator, Promise>;
+
 	static_assert(
 		std::is_nothrow_move_constructible<Aggregator>::value && std::is_nothrow_move_assignable<Aggregator>::value,
 		"Aggregator must be nothrow movable or copyable");
@@ -161,11 +254,7 @@ public:
 	execution_shared_state_base& operator=(const execution_shared_state_base&) = delete;
 	execution_shared_state_base& operator=(execution_shared_state_base&&) = delete;
 
-	~execution_shared_state_base() override
-	{
-		if (!is_ready())
-			future_shared_state_.make_ready();
-	}
+	~execution_shared_state_base() override = default;
 
 	void apply_exception(std::exception_ptr callback_exception) final
 	{
@@ -186,20 +275,26 @@ public:
 
 	CHANNELS_NODISCARD bool is_ready() const noexcept final
 	{
-		return future_shared_state_.is_ready();
+		return future_shared_state_type::is_ready();
 	}
 
 	CHANNELS_NODISCARD decltype(auto) get_future()
 	{
-		return future_shared_state_.get_future();
+		return future_shared_state_type::get_future();
 	}
 
 protected:
 	template<typename A, typename P>
 	explicit execution_shared_state_base(A&& aggregator, P&& promise)
-		: future_shared_state_{std::forward<A>(aggregator), std::forward<P>(promise)}
+		: future_shared_state_type{std::forward<A>(aggregator), std::forward<P>(promise)}
 	{}
 
+	void complete() noexcept final
+	{
+		if (!is_ready())
+			future_shared_state_type::make_ready();
+	}
+
 	CHANNELS_NODISCARD std::unique_lock<std::mutex> get_aggregator_lock()
 	{
 		if (is_ready())
@@ -218,7 +313,7 @@ protected:
 		assert(!is_ready()); // NOLINT
 
 		if (continuation == continuation_status::stop)
-			future_shared_state_.make_ready();
+			future_shared_state_type::make_ready();
 	}
 
 	void apply_aggregator_exception(std::exception_ptr exception)
@@ -226,19 +321,18 @@ protected:
 		assert(exception); // NOLINT
 		assert(!is_ready()); // NOLINT
 
-		future_shared_state_.make_ready(std::move(exception));
+		future_shared_state_type::make_ready(std::move(exception));
 	}
 
 	CHANNELS_NODISCARD Aggregator& get_aggregator() noexcept
 	{
 		assert(!is_ready()); // NOLINT
 
-		return future_shared_state_.get_value();
+		return future_shared_state_type::get_value();
 	}
 
 private:
 	std::mutex aggregator_mutex_;
-	detail::future_shared_state<Aggregator, Promise> future_shared_state_;
 };
 
 #ifdef _MSC_VER
@@ -352,18 +446,17 @@ public:
 		: binder_{std::forward<F>(callback)}
 	{}
 
-	void operator()(const std::shared_ptr<execution_shared_state_interface>& shared_state) const
+	void operator()(const execution_reference& execution) const
 	{
-		assert(shared_state); // NOLINT
-
-		if (shared_state->is_ready())
+		execution_shared_state_interface& shared_state = *execution;
+		if (shared_state.is_ready())
 			return;
 
 		try {
-			binder_(*shared_state);
+			binder_(shared_state);
 		}
 		catch (...) {
-			shared_state->apply_exception(std::current_exception());
+			shared_state.apply_exception(std::current_exception());
 		}
 	}
 
@@ -393,11 +486,13 @@ decltype(auto) aggregating_channel<R(Ts...)>::send(Aggregator&& aggregator, Ts..
 {
 	using execution_shared_state_type =
 		aggregating_channel_detail::execution_shared_state<std::decay_t<Aggregator>, std::decay_t<Promise>, R, Ts...>;
-	auto execution_shared_state = std::make_shared<execution_shared_state_type>(
-			std::forward<Aggregator>(aggregator), std::forward<Promise>(promise), std::forward<Ts>(args)...);
+	// the shared state is deleted by the last execution_reference or the last channels::future
+	auto* const execution_shared_state = new execution_shared_state_type{ // NOLINT(cppcoreguidelines-owning-memory)
+		std::forward<Aggregator>(aggregator), std::forward<Promise>(promise), std::forward<Ts>(args)...};
+	execution_reference execution{*execution_shared_state};
 	decltype(auto) future = execution_shared_state->get_future();
 
-	base_type::send(std::move(execution_shared_state));
+	base_type::send(std::move(execution));
 	return future;
 }
 
@@ -1,10 +1,18 @@
 #pragma once
+#include "channel_statistics.h"
 #include "connection.h"
+#include "mailbox.h"
 #include "detail/compatibility/compile_features.h"
 #include "detail/compatibility/shared_mutex.h"
+#include "detail/select_source.h"
+#include "detail/seqlock_value.h"
 #include "detail/shared_state.h"
 #include "detail/type_traits.h"
 #include "error.h"
+#include "error_policy.h"
+#include "threading_policy.h"
+#include <atomic>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <mutex>
@@ -29,6 +37,8 @@ class buffered_channel {
 	friend bool operator!=(const buffered_channel<Us...>& lhs, const buffered_channel<Us...>& rhs) noexcept; // NOLINT
 
 	class shared_state;
+	using error_policy = error_policy_t<buffered_channel>;
+	using threading_policy = threading_policy_t<buffered_channel>;
 
 public:
 	/// Looks like `std::optional<std::tuple<Ts...>>`
@@ -52,12 +62,53 @@ public:
 	template<typename Executor, typename Callback>
 	CHANNELS_NODISCARD connection connect(Executor&& executor, Callback&& callback) const;
 
+	/// This method is similar to method `channel::connect` with the priority but if the `buffered_channel` object has
+	/// a value then this method will call the callback function with buffered value.
+	/// \see get_value
+	template<typename Callback>
+	CHANNELS_NODISCARD connection connect(priority connection_priority, Callback&& callback) const;
+
+	/// This method is similar to method `channel::connect` with the priority and the executor but if the
+	/// `buffered_channel` object has a value then this method will call the callback function with buffered value.
+	/// \see get_value
+	template<typename Executor, typename Callback>
+	CHANNELS_NODISCARD connection connect(
+		priority connection_priority, Executor&& executor, Callback&& callback) const;
+
+	/// This method is similar to method `channel::connect_conflated` but if the `buffered_channel` object has a value
+	/// then this method will pass the buffered value to the callback function.
+	/// \see get_value
+	template<typename Executor, typename Callback>
+	CHANNELS_NODISCARD connection connect_conflated(Executor&& executor, Callback&& callback) const;
+
+	/// This method is similar to method `channel::connect_mailbox` but if the `buffered_channel` object has a value
+	/// then this method will pass the buffered value to the mailbox.
+	/// \see get_value
+	template<typename Executor, typename Callback>
+	CHANNELS_NODISCARD mailbox_connection connect_mailbox(
+		const mailbox_options& options, Executor&& executor, Callback&& callback) const;
+
 	/// Returns buffered value.
 	/// \note The `shared_value_type` is type like std::optional. If the `buffered_channel` object hasn't a value
 	///       then `static_cast<bool>(get_value()) == false` otherwise `static_cast<bool>(get_value()) == true`
 	/// \throw channel_error If `is_valid() == false`.
 	CHANNELS_NODISCARD shared_value_type get_value() const;
 
+	/// Copies buffered value to the `value`.
+	/// Unlike `get_value` this method doesn't take locks and doesn't write to the memory shared with other readers, so
+	/// any number of threads can read the value concurrently without contending with each other.
+	/// \note This method is available only if all types `Ts` are trivially copyable.
+	/// \return `false` if the `buffered_channel` object hasn't a value (the `value` isn't changed in this case).
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD bool read_value(std::tuple<Ts...>& value) const;
+
+	/// \see channels::channel::get_statistics
+	CHANNELS_NODISCARD channel_statistics get_statistics() const;
+
+public: // library private interface
+	// \see channels::selector
+	CHANNELS_NODISCARD std::shared_ptr<detail::select_source> get_select_source() const;
+
 protected:
 	struct make_shared_state_tag {};
 
@@ -69,9 +120,17 @@ protected:
 	///          stack.
 	void send(Ts... args);
 
+	/// This method is similar to method `channel::send_batch` but it also keeps the last element of the range in
+	/// the `buffered_channel` object.
+	/// \see get_value
+	/// \warning Calling this method from the callback function will deadlock. Except when the executor breaks the
+	///          stack.
+	template<typename Range>
+	void send_batch(Range&& values);
+
 private:
 	template<typename... Args>
-	CHANNELS_NODISCARD connection connect_impl(Args&&... args) const;
+	CHANNELS_NODISCARD connection connect_impl(priority connection_priority, Args&&... args) const;
 
 	std::shared_ptr<shared_state> shared_state_;
 };
@@ -87,14 +146,22 @@ struct channel_traits<buffered_channel<Ts...>> {
 };
 
 template<typename... Ts>
-class buffered_channel<Ts...>::shared_state : public detail::shared_state<Ts...> {
+class buffered_channel<Ts...>::shared_state final
+	: public detail::shared_state<Ts...>
+	, public detail::select_source {
 	struct emplace_in_place_tag {};
 	struct emplace_out_place_tag {};
 
 public:
+	explicit shared_state(const bool is_single_threaded)
+		: detail::shared_state<Ts...>{is_single_threaded}
+	{}
+
 	using typename detail::shared_state<Ts...>::shared_value_type;
 
-	using shared_value_mutex_type = detail::compatibility::shared_mutex;
+	using seqlock_value_type = detail::seqlock_value<Ts...>;
+
+	using shared_value_mutex_type = detail::policy_mutex_t<threading_policy, detail::compatibility::shared_mutex>;
 	using shared_value_unique_lock_type = std::unique_lock<shared_value_mutex_type>;
 	using shared_value_shared_lock_type = std::shared_lock<shared_value_mutex_type>;
 
@@ -108,6 +175,8 @@ public:
 			emplace_out_place_tag,
 			emplace_in_place_tag>;
 		emplace_value_impl(emplace_tag{}, std::forward<Args>(args)...);
+		store_seqlock_value(has_seqlock_value{});
+		version_.fetch_add(1, std::memory_order_seq_cst);
 
 		return {value_, std::move(value_lock)};
 	}
@@ -118,7 +187,38 @@ public:
 		return {value_, std::move(value_lock)};
 	}
 
+	CHANNELS_NODISCARD bool read_value(std::tuple<Ts...>& value) const noexcept
+	{
+		static_assert(has_seqlock_value::value, "read_value requires trivially copyable types");
+		return seqlock_value_.load(value);
+	}
+
+	bool is_ready(std::uint64_t& version) const noexcept override
+	{
+		const std::uint64_t current_version = version_.load(std::memory_order_seq_cst);
+		if (current_version == version)
+			return false;
+
+		version = current_version;
+		return true;
+	}
+
+	using detail::select_source::notify_selectors;
+
 private:
+	struct no_seqlock_value {};
+	// values of trivially copyable types are also published for lock-free readers
+	using has_seqlock_value = detail::is_trivially_copyable<Ts...>;
+
+	void store_seqlock_value(std::true_type)
+	{
+		const shared_value_type& value = value_;
+		seqlock_value_.store(*value);
+	}
+
+	void store_seqlock_value(std::false_type)
+	{}
+
 	template<typename... Args>
 	void emplace_value_impl(emplace_in_place_tag, Args&&... args)
 	{
@@ -133,20 +233,58 @@ private:
 
 	mutable shared_value_mutex_type value_mutex_;
 	shared_value_type value_;
+	std::conditional_t<has_seqlock_value::value, seqlock_value_type, no_seqlock_value> seqlock_value_;
+	// it is incremented after each change of the value, zero means there is no value
+	std::atomic<std::uint64_t> version_{0};
 };
 
 template<typename... Ts>
 template<typename Callback>
 connection buffered_channel<Ts...>::connect(Callback&& callback) const
 {
-	return connect_impl(std::forward<Callback>(callback));
+	return connect_impl(priority{}, std::forward<Callback>(callback));
 }
 
 template<typename... Ts>
 template<typename Executor, typename Callback>
 connection buffered_channel<Ts...>::connect(Executor&& executor, Callback&& callback) const
 {
-	return connect_impl(std::forward<Executor>(executor), std::forward<Callback>(callback));
+	return connect_impl(priority{}, std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Callback>
+connection buffered_channel<Ts...>::connect(const priority connection_priority, Callback&& callback) const
+{
+	return connect_impl(connection_priority, std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Executor, typename Callback>
+connection buffered_channel<Ts...>::connect(
+	const priority connection_priority, Executor&& executor, Callback&& callback) const
+{
+	return connect_impl(connection_priority, std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Executor, typename Callback>
+connection buffered_channel<Ts...>::connect_conflated(Executor&& executor, Callback&& callback) const
+{
+	return connect_impl(
+		priority{}, detail::conflated_tag{}, std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Executor, typename Callback>
+mailbox_connection buffered_channel<Ts...>::connect_mailbox(
+	const mailbox_options& options, Executor&& executor, Callback&& callback) const
+{
+	auto mailbox = std::make_shared<typename shared_state::mailbox_type>(options);
+	std::shared_ptr<const detail::mailbox_counters> counters = mailbox;
+	connection connection = connect_impl(
+		priority{}, std::move(mailbox), std::forward<Executor>(executor), std::forward<Callback>(callback));
+	return mailbox_connection{std::move(connection), std::move(counters)};
 }
 
 template<typename... Ts>
@@ -164,9 +302,36 @@ typename buffered_channel<Ts...>::shared_value_type buffered_channel<Ts...>::get
 	return shared_state_->get_value().first;
 }
 
+template<typename... Ts>
+bool buffered_channel<Ts...>::read_value(std::tuple<Ts...>& value) const
+{
+	if (!is_valid())
+		throw channel_error{"buffered_channel: has no state"};
+
+	return shared_state_->read_value(value);
+}
+
+template<typename... Ts>
+channel_statistics buffered_channel<Ts...>::get_statistics() const
+{
+	if (!is_valid())
+		throw channel_error{"buffered_channel: has no state"};
+
+	return shared_state_->get_statistics_snapshot();
+}
+
+template<typename... Ts>
+std::shared_ptr<detail::select_source> buffered_channel<Ts...>::get_select_source() const
+{
+	if (!is_valid())
+		throw channel_error{"buffered_channel: has no state"};
+
+	return shared_state_;
+}
+
 template<typename... Ts>
 buffered_channel<Ts...>::buffered_channel(make_shared_state_tag)
-	: shared_state_{std::make_shared<shared_state>()}
+	: shared_state_{std::make_shared<shared_state>(detail::is_single_threaded<threading_policy>::value)}
 {}
 
 template<typename... Ts>
@@ -183,17 +348,42 @@ void buffered_channel<Ts...>::send(Ts... args)
 		// when it is called from the connect method
 		sockets_view = shared_state_->get_sockets();
 	}
+	shared_state_->notify_selectors();
 
 	callbacks_exception::exceptions_type exceptions;
+	typename shared_state::value_reference value{std::move(shared_value)};
+	shared_state_->deliver(error_policy{}, std::move(sockets_view), value, exceptions);
+
+	if (!exceptions.empty())
+		throw callbacks_exception{std::move(exceptions)};
+}
+
+template<typename... Ts>
+template<typename Range>
+void buffered_channel<Ts...>::send_batch(Range&& values)
+{
+	typename shared_state::batch_type batch;
+	for (auto&& value : values)
+		batch.emplace_back(std::forward<decltype(value)>(value));
+
+	if (batch.empty())
+		return;
 
-	for (typename shared_state::invocable_socket& socket : sockets_view) {
-		try {
-			socket(shared_value);
-		}
-		catch (...) {
-			exceptions.push_back(std::current_exception());
-		}
+	typename shared_state::invocable_sockets_shared_view sockets_view;
+
+	{
+		typename shared_state::shared_value_unique_lock_type shared_value_lock;
+
+		std::tie(std::ignore, shared_value_lock) = shared_state_->emplace_value(batch.back());
+		// get sockets under the shared_value_lock in order to avoid duplication of the message in the callback function
+		// when it is called from the connect method
+		sockets_view = shared_state_->get_sockets();
 	}
+	shared_state_->notify_selectors();
+
+	callbacks_exception::exceptions_type exceptions;
+	typename shared_state::batch_reference batch_values{batch};
+	shared_state_->deliver(error_policy{}, std::move(sockets_view), batch_values, exceptions);
 
 	if (!exceptions.empty())
 		throw callbacks_exception{std::move(exceptions)};
@@ -201,8 +391,13 @@ void buffered_channel<Ts...>::send(Ts... args)
 
 template<typename... Ts>
 template<typename... Args>
-connection buffered_channel<Ts...>::connect_impl(Args&&... args) const
+connection buffered_channel<Ts...>::connect_impl(const priority connection_priority, Args&&... args) const
 {
+	using callback_type = std::tuple_element_t<sizeof...(Args) - 1, std::tuple<Args...>>;
+	static_assert(
+		detail::is_allowed_callback<error_policy, callback_type, Ts...>::value,
+		"Callback must be noexcept for buffered_channel with policy::nothrow");
+
 	if (!is_valid())
 		throw channel_error{"buffered_channel: has no state"};
 
@@ -213,13 +408,13 @@ connection buffered_channel<Ts...>::connect_impl(Args&&... args) const
 		// shared lock allows calling the connect method from the callback
 		typename shared_state::shared_value_shared_lock_type shared_value_lock;
 		std::tie(shared_value, shared_value_lock) = shared_state_->get_value();
-		socket = &shared_state_->connect(std::forward<Args>(args)...);
+		socket = &shared_state_->connect(connection_priority.value, std::forward<Args>(args)...);
 
 		if (shared_value)
 			(*socket)(std::move(shared_value));
 	}
 
-	return connection{shared_state_, *socket};
+	return connection{*shared_state_, *socket};
 }
 
 template<typename... Us>
@@ -1,11 +1,16 @@
 #pragma once
+#include "channel_statistics.h"
 #include "connection.h"
+#include "mailbox.h"
 #include "detail/compatibility/compile_features.h"
 #include "detail/shared_state.h"
 #include "error.h"
+#include "error_policy.h"
+#include "threading_policy.h"
 #include <cassert>
 #include <exception>
 #include <memory>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -66,7 +71,8 @@ class channel {
 	friend bool operator!=(const channel<Us...>& lhs, const channel<Us...>& rhs) noexcept; // NOLINT
 
 	using shared_state_type = detail::shared_state<Ts...>;
-	using shared_value_type = typename shared_state_type::shared_value_type;
+	using error_policy = error_policy_t<channel>;
+	using threading_policy = threading_policy_t<channel>;
 
 public:
 	/// Constructs a `channel` object with no shared state.
@@ -82,7 +88,11 @@ public:
 	///                 Callback type must match the concept `std::Invocable<Callback, Ts...>`.
 	/// \return A `channels::connection` object that controls the current connection.
 	/// \warning When connection object is destroyed the connection will be disconnected.
-	/// \note Callback function will be destroyed only when the connection is disconnected.
+	/// \note Callback function is destroyed when the connection is disconnected or when the channel is destroyed,
+	///       whichever comes first. The `connection` object doesn't keep the callback function alive.
+	/// \note After the disconnection the callback function is destroyed as soon as no sender of this channel can call
+	///       it: by `disconnect`, by the next connection or disconnection or by the last of these senders, so it can be
+	///       destroyed in another thread. The senders of other channels don't delay it.
 	/// \throw channel_error If `is_valid() == false`.
 	/// \throws Any exception thrown by the copy or move constructors of callback.
 	/// \pre `is_valid() == true`.
@@ -106,6 +116,58 @@ public:
 	template<typename Executor, typename Callback>
 	CHANNELS_NODISCARD connection connect(Executor&& executor, Callback&& callback) const;
 
+	/// Same as method `connect` but the callback function is called before the callback functions with lower
+	/// `connection_priority` and after the ones with higher `connection_priority`.
+	/// So under load the important subscribers are served first, and the subscribers placed last can be connected with
+	/// an executor that defers them.
+	/// \see channels::priority
+	/// \throw channel_error If `is_valid() == false`.
+	/// \throws Any exception from method `connect`.
+	template<typename Callback>
+	CHANNELS_NODISCARD connection connect(priority connection_priority, Callback&& callback) const;
+
+	/// Same as method `connect` with the executor but it takes the `connection_priority` of the callback function.
+	/// The priority orders the calls of `execute`.
+	/// \see channels::priority
+	/// \throw channel_error If `is_valid() == false`.
+	/// \throws Any exception from method `connect`.
+	template<typename Executor, typename Callback>
+	CHANNELS_NODISCARD connection connect(
+		priority connection_priority, Executor&& executor, Callback&& callback) const;
+
+	/// Same as method `connect` with the executor but only the latest value is passed to the callback function.
+	/// At most one task of the callback function is scheduled to the executor at a time. If new values are sent before
+	/// the task calls the callback function, they replace the pending value, so a slow callback function skips the
+	/// stale values and the load of the executor doesn't depend on the rate of sending.
+	/// \param executor See method `connect`.
+	/// \param callback See method `connect`.
+	/// \return A `channels::connection` object that controls the current connection.
+	/// \throw channel_error If `is_valid() == false`.
+	/// \throws Any exception from method `connect`.
+	template<typename Executor, typename Callback>
+	CHANNELS_NODISCARD connection connect_conflated(Executor&& executor, Callback&& callback) const;
+
+	/// Same as method `connect` with the executor but the values are passed to the callback function through the
+	/// bounded mailbox. The mailbox schedules at most one task to the executor at a time, and this task calls the
+	/// callback function with all pending values in order. When the mailbox is full, the `options.policy` is applied.
+	/// \see channels::mailbox_options
+	/// \param options Capacity and overflow policy of the mailbox.
+	/// \param executor See method `connect`.
+	/// \param callback See method `connect`.
+	/// \return A `channels::mailbox_connection` object that controls the current connection and provides the counters
+	///         of the mailbox.
+	/// \throw channel_error If `is_valid() == false`.
+	/// \throws Any exception from method `connect`.
+	template<typename Executor, typename Callback>
+	CHANNELS_NODISCARD mailbox_connection connect_mailbox(
+		const mailbox_options& options, Executor&& executor, Callback&& callback) const;
+
+	/// Returns the snapshot of the runtime statistics of the channel.
+	/// \note This method is thread safe.
+	/// \see channels::channel_statistics
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD channel_statistics get_statistics() const;
+
 protected:
 	struct make_shared_state_tag {};
 
@@ -118,13 +180,27 @@ protected:
 	/// \param args Arguments to pass to the callback functions.
 	/// \throw callbacks_exception If one or more either callback function or `execute` function threw exceptions.
 	/// \note If the callback function or the `execute` function throws an exception this method doesn't stop executing
-	///       but calls the remaining callback functions and throws the `callbacks_exception`.
+	///       but calls the remaining callback functions and throws the `callbacks_exception`. This behavior can be
+	///       changed by the error policy of the channel (see `channels::error_policy_traits`).
 	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
 	void send(Ts... args);
 
+	/// Calls all connected callback functions and passes each element of the range to them.
+	/// It works like calling `send` for each element but takes the list of callback functions once: each callback
+	/// function is called with all values of the batch in order before the next callback function is called, and each
+	/// callback function connected with an executor gets one task for the whole batch.
+	/// \note This method is thread safe.
+	/// \param values Range of values to send. Each element must be convertible to `std::tuple<Ts...>` (if the channel has
+	///               one parameter, the element can also be a value of this parameter type).
+	/// \throw callbacks_exception If one or more either callback function or `execute` function threw exceptions.
+	/// \note If the callback function throws an exception this method continues with the next value.
+	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
+	template<typename Range>
+	void send_batch(Range&& values);
+
 private:
 	template<typename... Args>
-	CHANNELS_NODISCARD connection connect_impl(Args&& ... args) const;
+	CHANNELS_NODISCARD connection connect_impl(priority connection_priority, Args&&... args) const;
 
 	std::shared_ptr<shared_state_type> shared_state_;
 };
@@ -143,14 +219,29 @@ template<typename... Ts>
 template<typename Callback>
 connection channel<Ts...>::connect(Callback&& callback) const
 {
-	return connect_impl(std::forward<Callback>(callback));
+	return connect_impl(priority{}, std::forward<Callback>(callback));
 }
 
 template<typename... Ts>
 template<typename Executor, typename Callback>
 connection channel<Ts...>::connect(Executor&& executor, Callback&& callback) const
 {
-	return connect_impl(std::forward<Executor>(executor), std::forward<Callback>(callback));
+	return connect_impl(priority{}, std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Callback>
+connection channel<Ts...>::connect(const priority connection_priority, Callback&& callback) const
+{
+	return connect_impl(connection_priority, std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Executor, typename Callback>
+connection channel<Ts...>::connect(
+	const priority connection_priority, Executor&& executor, Callback&& callback) const
+{
+	return connect_impl(connection_priority, std::forward<Executor>(executor), std::forward<Callback>(callback));
 }
 
 template<typename... Ts>
@@ -159,9 +250,18 @@ bool channel<Ts...>::is_valid() const noexcept
 	return static_cast<bool>(shared_state_);
 }
 
+template<typename... Ts>
+channel_statistics channel<Ts...>::get_statistics() const
+{
+	if (!is_valid())
+		throw channel_error{"channel: has no state"};
+
+	return shared_state_->get_statistics_snapshot();
+}
+
 template<typename... Ts>
 channel<Ts...>::channel(make_shared_state_tag)
-	: shared_state_{std::make_shared<shared_state_type>()}
+	: shared_state_{std::make_shared<shared_state_type>(detail::is_single_threaded<threading_policy>::value)}
 {}
 
 template<typename... Ts>
@@ -169,30 +269,72 @@ void channel<Ts...>::send(Ts... args)
 {
 	assert(shared_state_); // NOLINT
 
+	// an empty vector doesn't allocate memory until some callback throws
+	callbacks_exception::exceptions_type exceptions;
+	// the arguments stay on the stack unless some deferred socket needs the shared value
+	std::tuple<Ts...> arguments{std::forward<Ts>(args)...};
+	typename shared_state_type::value_reference value{arguments};
+	shared_state_->deliver(error_policy{}, shared_state_->get_sockets(), value, exceptions);
+
+	if (!exceptions.empty())
+		throw callbacks_exception{std::move(exceptions)};
+}
+
+template<typename... Ts>
+template<typename Range>
+void channel<Ts...>::send_batch(Range&& values)
+{
+	assert(shared_state_); // NOLINT
+
+	typename shared_state_type::batch_type batch;
+	for (auto&& value : values)
+		batch.emplace_back(std::forward<decltype(value)>(value));
+
+	if (batch.empty())
+		return;
+
 	callbacks_exception::exceptions_type exceptions;
-	const shared_value_type shared_value{cow::in_place, std::forward<Ts>(args)...};
-	for (typename shared_state_type::invocable_socket& socket : shared_state_->get_sockets()) {
-		try {
-			socket(shared_value);
-		}
-		catch (...) {
-			exceptions.push_back(std::current_exception());
-		}
-	}
+	typename shared_state_type::batch_reference batch_values{batch};
+	shared_state_->deliver(error_policy{}, shared_state_->get_sockets(), batch_values, exceptions);
 
 	if (!exceptions.empty())
 		throw callbacks_exception{std::move(exceptions)};
 }
 
+template<typename... Ts>
+template<typename Executor, typename Callback>
+connection channel<Ts...>::connect_conflated(Executor&& executor, Callback&& callback) const
+{
+	return connect_impl(
+		priority{}, detail::conflated_tag{}, std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Executor, typename Callback>
+mailbox_connection channel<Ts...>::connect_mailbox(
+	const mailbox_options& options, Executor&& executor, Callback&& callback) const
+{
+	auto mailbox = std::make_shared<typename shared_state_type::mailbox_type>(options);
+	std::shared_ptr<const detail::mailbox_counters> counters = mailbox;
+	connection connection = connect_impl(
+		priority{}, std::move(mailbox), std::forward<Executor>(executor), std::forward<Callback>(callback));
+	return mailbox_connection{std::move(connection), std::move(counters)};
+}
+
 template<typename... Ts>
 template<typename... Args>
-connection channel<Ts...>::connect_impl(Args&&... args) const
+connection channel<Ts...>::connect_impl(const priority connection_priority, Args&&... args) const
 {
+	using callback_type = std::tuple_element_t<sizeof...(Args) - 1, std::tuple<Args...>>;
+	static_assert(
+		detail::is_allowed_callback<error_policy, callback_type, Ts...>::value,
+		"Callback must be noexcept for channel with policy::nothrow");
+
 	if (!is_valid())
 		throw channel_error{"channel: has no state"};
 
-	auto& socket = shared_state_->connect(std::forward<Args>(args)...);
-	return connection{shared_state_, socket};
+	auto& socket = shared_state_->connect(connection_priority.value, std::forward<Args>(args)...);
+	return connection{*shared_state_, socket};
 }
 
 template<typename... Us>
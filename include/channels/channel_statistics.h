@@ -0,0 +1,40 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace channels {
+
+/// The structure `channel_statistics` is a snapshot of the runtime statistics of a channel.
+/// \note The counters are collected only if the library is built with the CMake option `ENABLE_STATISTICS` (it
+///       defines the macro `CHANNELS_STATISTICS`). Otherwise collecting costs nothing and all fields except
+///       `subscribers_number` are always zero.
+/// \see channels::channel::get_statistics
+struct channel_statistics {
+	/// Number of buckets in the histogram of send durations.
+	static constexpr std::size_t histogram_size = 16;
+
+	/// Returns the upper bound (exclusive) of the send duration histogram bucket in nanoseconds.
+	/// The lower bound of a bucket is the upper bound of the previous one (or zero). The last bucket is unbounded.
+	static constexpr std::uint64_t get_histogram_bucket_bound_ns(const std::size_t index) noexcept
+	{
+		return std::uint64_t{128} << index;
+	}
+
+	/// Number of sent values (each element of a batch is counted).
+	std::uint64_t sends_number = 0;
+	/// Number of times a value or a batch was passed to a callback function or to its executor.
+	std::uint64_t deliveries_number = 0;
+	/// Number of exceptions thrown by callback functions or `execute` functions during sending.
+	std::uint64_t exceptions_number = 0;
+	/// Number of times a disconnected callback function was skipped by a sending that started before disconnection.
+	std::uint64_t blocked_skips_number = 0;
+	/// Number of connected callback functions.
+	std::size_t subscribers_number = 0;
+	/// Maximum number of callback functions that have been connected at the same time.
+	std::size_t peak_subscribers_number = 0;
+	/// Histogram of durations of `send` and `send_batch` calls.
+	std::array<std::uint64_t, histogram_size> send_durations_histogram{};
+};
+
+} // namespace channels
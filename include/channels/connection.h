@@ -1,17 +1,31 @@
 #pragma once
 #include "detail/compatibility/compile_features.h"
+#include <cstdint>
 #include <memory>
 
 namespace channels {
 
 namespace detail {
 
+class connection_table;
 class shared_state_base;
 class socket_base;
+class static_socket_base;
 
 } // namespace detail
 
+/// The structure `priority` orders the callback functions of one channel: the callback functions with higher priority
+/// are called first and the callback functions with equal priority are called in order of connection.
+/// The callback functions connected without a priority have priority 0.
+/// The order is established by `connect`, so it costs nothing when values are sent.
+/// \see channels::channel::connect
+struct priority {
+	int value = 0;
+};
+
 /// A handler of channel connection.
+/// It is a compact handle (an index and a generation of the entry in the connection table of the channel) that doesn't
+/// keep the channel alive: after the channel is destroyed, `disconnect` only releases the handle.
 class CHANNELS_NODISCARD connection {
 public:
 	/// Constructs a disconnected `connection` object.
@@ -34,11 +48,44 @@ public:
 	CHANNELS_NODISCARD bool is_connected() const noexcept;
 
 public: // library private interface
-	connection(std::shared_ptr<detail::shared_state_base> shared_state, detail::socket_base& socket) noexcept;
+	connection(detail::shared_state_base& shared_state, const detail::socket_base& socket) noexcept;
+
+private:
+	detail::connection_table* table_{nullptr}; // owns one reference to the table
+	std::uint32_t index_{0};
+	std::uint32_t generation_{0};
+};
+
+/// A handler of the connection to `channels::static_channel`.
+/// It has the same interface as `channels::connection` but refers to the slot of the channel without owning it.
+/// \warning The `static_connection` object must be disconnected or destroyed before the channel is destroyed.
+class CHANNELS_NODISCARD static_connection {
+public:
+	/// Constructs a disconnected `static_connection` object.
+	/// \post `is_connected() == false`.
+	static_connection() = default;
+
+	static_connection(const static_connection&) = delete;
+	static_connection(static_connection&& other) noexcept;
+	static_connection& operator=(const static_connection&) = delete;
+	static_connection& operator=(static_connection&& other) noexcept;
+
+	/// Breaks the connection and destructs this object.
+	~static_connection() noexcept;
+
+	/// Breaks the connection. The callback function is destroyed now or, if it is being called, when the last call
+	/// returns. The slot of the channel can be reused after that.
+	/// \post `is_connected() == false`.
+	void disconnect() noexcept;
+
+	/// Checks if the connection is connected.
+	CHANNELS_NODISCARD bool is_connected() const noexcept;
+
+public: // library private interface
+	explicit static_connection(detail::static_socket_base& socket) noexcept;
 
 private:
-	std::shared_ptr<detail::shared_state_base> shared_state_;
-	detail::socket_base* socket_{nullptr};
+	detail::static_socket_base* socket_{nullptr};
 };
 
 } // namespace channels
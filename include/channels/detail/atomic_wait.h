@@ -0,0 +1,34 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace channels {
+namespace detail {
+
+// Blocks the calling thread while `value == expected` (like `std::atomic::wait` from C++20).
+// On Linux the thread waits on the futex of the `value`; on other systems it waits on a condition variable chosen by the
+// address of the `value`. The function can return spuriously, so the caller has to check its condition again.
+// \param deadline The thread waits without a limit if it is null.
+// \return `false` if the `deadline` is reached.
+bool atomic_wait(
+	const std::atomic<std::uint32_t>& value,
+	std::uint32_t expected,
+	const std::chrono::steady_clock::time_point* deadline) noexcept;
+
+// Wakes all threads blocked in `atomic_wait` on the `value`.
+// The caller must change the `value` before calling this function.
+void atomic_notify_all(std::atomic<std::uint32_t>& value) noexcept;
+
+// Same as `atomic_wait` but the `value` can be placed in memory shared between processes.
+// On systems without futexes the thread polls the `value` with short sleeps.
+bool atomic_wait_shared(
+	const std::atomic<std::uint32_t>& value,
+	std::uint32_t expected,
+	const std::chrono::steady_clock::time_point* deadline) noexcept;
+
+// Wakes all threads of all processes blocked in `atomic_wait_shared` on the `value`.
+void atomic_notify_all_shared(std::atomic<std::uint32_t>& value) noexcept;
+
+} // namespace detail
+} // namespace channels
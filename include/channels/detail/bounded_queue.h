@@ -0,0 +1,156 @@
+#pragma once
+#include "compatibility/compile_features.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+namespace detail {
+
+// Lock-free bounded multi-producer multi-consumer queue (D. Vyukov's algorithm).
+// Each cell has a sequence number that tells the producers and the consumers whose turn it is, so they only contend
+// on the cell they claim. The capacity is rounded up to a power of two (at least 2).
+// Values are moved into and out of the cells after the cell is claimed, so the moves must not throw.
+template<typename T>
+class bounded_queue {
+	static_assert(
+		std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+		"bounded_queue requires nothrow movable values");
+
+public:
+	using value_type = T;
+
+	explicit bounded_queue(std::size_t capacity);
+
+	bounded_queue(const bounded_queue&) = delete;
+	bounded_queue(bounded_queue&&) = delete;
+	bounded_queue& operator=(const bounded_queue&) = delete;
+	bounded_queue& operator=(bounded_queue&&) = delete;
+
+	~bounded_queue();
+
+	CHANNELS_NODISCARD std::size_t get_capacity() const noexcept;
+	// The result can be outdated immediately if other threads use the queue.
+	CHANNELS_NODISCARD bool is_empty() const noexcept;
+
+	// \return `false` if the queue is full (the `value` isn't moved in this case).
+	CHANNELS_NODISCARD bool try_push(value_type& value) noexcept;
+	// \return `false` if the queue is empty.
+	CHANNELS_NODISCARD bool try_pop(value_type& value) noexcept;
+
+private:
+	struct cell {
+		std::atomic<std::size_t> sequence;
+		std::aligned_storage_t<sizeof(value_type), alignof(value_type)> storage;
+
+		value_type* get() noexcept
+		{
+			return reinterpret_cast<value_type*>(&storage); // NOLINT
+		}
+	};
+
+	static std::size_t get_buffer_size(std::size_t capacity) noexcept;
+
+	std::size_t buffer_mask_;
+	std::unique_ptr<cell[]> buffer_; // NOLINT(cppcoreguidelines-avoid-c-arrays)
+	std::atomic<std::size_t> enqueue_position_{0};
+	std::atomic<std::size_t> dequeue_position_{0};
+};
+
+// implementation
+
+template<typename T>
+bounded_queue<T>::bounded_queue(const std::size_t capacity)
+	: buffer_mask_{get_buffer_size(capacity) - 1}
+	, buffer_{std::make_unique<cell[]>(buffer_mask_ + 1)} // NOLINT(cppcoreguidelines-avoid-c-arrays)
+{
+	for (std::size_t i = 0; i <= buffer_mask_; ++i)
+		buffer_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+bounded_queue<T>::~bounded_queue()
+{
+	const std::size_t end = enqueue_position_.load(std::memory_order_relaxed);
+	for (std::size_t i = dequeue_position_.load(std::memory_order_relaxed); i != end; ++i)
+		buffer_[i & buffer_mask_].get()->~value_type();
+}
+
+template<typename T>
+std::size_t bounded_queue<T>::get_capacity() const noexcept
+{
+	return buffer_mask_ + 1;
+}
+
+template<typename T>
+bool bounded_queue<T>::is_empty() const noexcept
+{
+	const std::size_t position = dequeue_position_.load(std::memory_order_acquire);
+	const std::size_t sequence = buffer_[position & buffer_mask_].sequence.load(std::memory_order_acquire);
+	return static_cast<std::ptrdiff_t>(sequence - (position + 1)) < 0;
+}
+
+template<typename T>
+bool bounded_queue<T>::try_push(value_type& value) noexcept
+{
+	std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+	for (;;) {
+		cell& current_cell = buffer_[position & buffer_mask_];
+		const std::size_t sequence = current_cell.sequence.load(std::memory_order_acquire);
+		const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+		if (difference == 0) {
+			if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				new (&current_cell.storage) value_type(std::move(value));
+				current_cell.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0) {
+			return false; // full
+		}
+		else {
+			position = enqueue_position_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<typename T>
+bool bounded_queue<T>::try_pop(value_type& value) noexcept
+{
+	std::size_t position = dequeue_position_.load(std::memory_order_relaxed);
+	for (;;) {
+		cell& current_cell = buffer_[position & buffer_mask_];
+		const std::size_t sequence = current_cell.sequence.load(std::memory_order_acquire);
+		const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+		if (difference == 0) {
+			if (dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				value_type* const cell_value = current_cell.get();
+				value = std::move(*cell_value);
+				cell_value->~value_type();
+				current_cell.sequence.store(position + buffer_mask_ + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0) {
+			return false; // empty
+		}
+		else {
+			position = dequeue_position_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<typename T>
+std::size_t bounded_queue<T>::get_buffer_size(const std::size_t capacity) noexcept
+{
+	std::size_t size = 2;
+	while (size < capacity)
+		size *= 2;
+	return size;
+}
+
+} // namespace detail
+} // namespace channels
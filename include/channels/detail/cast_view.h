@@ -1,6 +1,5 @@
 #pragma once
 #include "compatibility/compile_features.h"
-#include <cassert>
 #include <iterator>
 #include <type_traits>
 #include <utility>
@@ -13,7 +12,7 @@ class cast_iterator;
 
 // This class casts values from Base::value_type to T.
 // It is designed to restore the types of objects returned by erase-types containers
-// (like channels::detail::intrusive_list).
+// (like channels::detail::sockets_snapshot).
 template<typename Base, typename T>
 class CHANNELS_NODISCARD cast_view {
 public:
@@ -85,13 +84,7 @@ private:
 template<typename Base, typename T>
 constexpr cast_view<Base, T>::cast_view(Base base)
 	: base_{std::move(base)}
-{
-#ifndef NDEBUG
-	for (auto& item : base_) {
-		assert(dynamic_cast<T*>(std::addressof(item)));
-	}
-#endif
-}
+{}
 
 template<typename Base, typename T>
 constexpr typename cast_view<Base, T>::iterator cast_view<Base, T>::begin()
@@ -38,3 +38,13 @@
 #if (defined(__cpp_lib_shared_mutex) && __cpp_lib_shared_mutex >= 201505) || __cplusplus >= 201703L
 #	define CHANNELS_CPP_LIB_SHARED_MUTEX
 #endif
+
+// POSIX shared memory objects (shm_open)
+#if defined(__unix__) || defined(__APPLE__)
+#	define CHANNELS_HAS_SHARED_MEMORY
+#endif
+
+// memory-mapped files (mmap)
+#if defined(__unix__) || defined(__APPLE__)
+#	define CHANNELS_HAS_MMAP
+#endif
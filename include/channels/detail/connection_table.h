@@ -0,0 +1,82 @@
+#pragma once
+#include "compatibility/compile_features.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace channels {
+namespace detail {
+
+class shared_state_base;
+class socket_base;
+
+// This class maps the handles of `channels::connection` objects to the sockets of one shared state (a slot map).
+// A handle is an index of an entry and the generation of this entry: the generation is incremented when the entry is
+// freed, so a stale handle is never mistaken for the connection that reuses the entry.
+// The mutex of the table is also the mutex of the socket lists of the shared state, so a socket gets its entry and
+// loses it under the lock that `connect` and `disconnect` take anyway.
+// The table has an intrusive reference counter: the shared state owns one reference and every handle owns another,
+// so the connections don't keep the shared state alive. The shared state detaches itself from the table when it is
+// destroyed, after that the handles only release their entries.
+// The table of a single-threaded shared state is used only by the thread of its channel (the connections can't be
+// disconnected in other threads), so it doesn't lock its mutex and changes the counter with plain loads and stores.
+class connection_table {
+public:
+	struct handle {
+		std::uint32_t index;
+		std::uint32_t generation;
+	};
+
+	using mutex_type = std::mutex;
+	using unique_lock_type = std::unique_lock<mutex_type>;
+
+	// Creates a table with one reference that is owned by the `shared_state`.
+	CHANNELS_NODISCARD static connection_table* create(shared_state_base& shared_state, bool is_single_threaded);
+
+	connection_table(const connection_table&) = delete;
+	connection_table(connection_table&&) = delete;
+	connection_table& operator=(const connection_table&) = delete;
+	connection_table& operator=(connection_table&&) = delete;
+
+	void add_reference() noexcept;
+	void remove_reference() noexcept;
+
+	CHANNELS_NODISCARD unique_lock_type lock();
+	CHANNELS_NODISCARD unique_lock_type try_lock();
+
+	// Adds the entry of the `socket`. The caller adds a reference to the table for the returned handle.
+	// \throw std::bad_alloc If the table can't grow.
+	CHANNELS_NODISCARD handle insert(socket_base& socket, const unique_lock_type& lock);
+
+	// Frees the entry of the `connection`, removes its socket from the shared state if it is still attached and
+	// releases the reference of the handle.
+	void erase(handle connection) noexcept;
+
+	// Detaches the shared state that is being destroyed.
+	void detach(const unique_lock_type& lock) noexcept;
+
+private:
+	struct entry {
+		socket_base* socket;
+		std::uint32_t generation;
+		std::uint32_t next_free; // index of the next free entry if this entry is free
+	};
+
+	static constexpr std::uint32_t no_entry = UINT32_MAX;
+
+	connection_table(shared_state_base& shared_state, bool is_single_threaded) noexcept;
+	~connection_table() = default;
+
+	mutex_type mutex_;
+	const bool is_single_threaded_;
+	// the entries and the pointer are guarded by the mutex
+	shared_state_base* shared_state_;
+	std::vector<entry> entries_;
+	std::uint32_t free_entries_{no_entry};
+	std::atomic<std::size_t> references_count_{1};
+};
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,118 @@
+#pragma once
+#include "compatibility/compile_features.h"
+#include <atomic>
+#include <cstdint>
+
+namespace channels {
+namespace detail {
+
+// Epoch-based memory reclamation domain.
+// A reader pins itself in the domain before it loads a pointer to a shared object and unpins itself when it doesn't use
+// the object anymore. A writer that has unlinked an object retires it with the current epoch of the domain, and the
+// object is reclaimed when the epoch has been advanced twice: the epoch is advanced only when all pinned readers have
+// observed it, so no reader can access an object retired two epochs ago.
+// Each channel has its own domain, so a reader that stays pinned (a callback function that blocks) delays the
+// reclamation only of the objects of its channel.
+// A pin is a record of the domain that is claimed by a compare-and-swap and released by a store. Every thread keeps the
+// records it has claimed last in a small thread-local cache and claims them again, so the readers of different threads
+// don't write to the same memory. Nested pins (a callback function that sends to the same channel) claim other records.
+class epoch_domain {
+public:
+	struct record;
+
+	epoch_domain() noexcept;
+
+	epoch_domain(const epoch_domain&) = delete;
+	epoch_domain(epoch_domain&&) = delete;
+	epoch_domain& operator=(const epoch_domain&) = delete;
+	epoch_domain& operator=(epoch_domain&&) = delete;
+
+	// \pre There are no pins.
+	~epoch_domain() noexcept;
+
+	// \note If all records are claimed the pin allocates a new one, so it can throw `std::bad_alloc`. The records are
+	// deleted with the domain.
+	CHANNELS_NODISCARD record& pin();
+	static void unpin(record& pin) noexcept;
+
+	// Returns the epoch for the objects that have just been unlinked.
+	CHANNELS_NODISCARD std::uint64_t get_epoch() const noexcept;
+
+	// Advances the epoch if all pinned readers have observed the current one.
+	// \return The current epoch.
+	std::uint64_t try_advance() noexcept;
+
+	// Checks if the objects retired in the `retire_epoch` can't be accessed by readers in the `epoch`.
+	CHANNELS_NODISCARD static constexpr bool is_reclaimable(std::uint64_t retire_epoch, std::uint64_t epoch) noexcept
+	{
+		return retire_epoch + 2 <= epoch;
+	}
+
+private:
+	CHANNELS_NODISCARD bool try_claim(record& pin) noexcept;
+	CHANNELS_NODISCARD record& acquire_record();
+
+	// identifies the domain in the thread-local caches, it isn't reused by other domains
+	const std::uint64_t id_;
+	std::atomic<std::uint64_t> epoch_{0};
+	std::atomic<record*> records_{nullptr};
+};
+
+// Base class of the objects that can be retired. It is intrusive, so retiring doesn't allocate memory.
+class retired_node {
+	friend class retired_list;
+
+public:
+	retired_node(const retired_node&) = delete;
+	retired_node(retired_node&&) = delete;
+	retired_node& operator=(const retired_node&) = delete;
+	retired_node& operator=(retired_node&&) = delete;
+
+protected:
+	// The function destroys the object of the derived type and frees its memory.
+	using reclaim_function_type = void (*)(retired_node& node);
+
+	explicit retired_node(reclaim_function_type reclaim) noexcept;
+	~retired_node() = default;
+
+private:
+	reclaim_function_type reclaim_;
+	retired_node* next_{nullptr};
+	std::uint64_t retire_epoch_{0};
+};
+
+// List of retired objects in order of retirement. It isn't thread safe, so its owner guards it.
+// The objects left in the list are reclaimed by its destructor.
+class retired_list {
+public:
+	retired_list() = default;
+
+	retired_list(const retired_list&) = delete;
+	retired_list(retired_list&& other) noexcept;
+	retired_list& operator=(const retired_list&) = delete;
+	retired_list& operator=(retired_list&& other) noexcept;
+
+	~retired_list() noexcept;
+
+	CHANNELS_NODISCARD bool empty() const noexcept;
+
+	// Takes the ownership of the `node`.
+	// \pre The `epoch` isn't less than the epochs of the nodes in the list.
+	void push(retired_node& node, std::uint64_t epoch) noexcept;
+
+	// Moves the objects that can't be accessed by readers in the `epoch` to the returned list.
+	CHANNELS_NODISCARD retired_list take_reclaimable(std::uint64_t epoch) noexcept;
+
+	// Moves all objects to the returned list.
+	CHANNELS_NODISCARD retired_list take_all() noexcept;
+
+	// Reclaims all objects in the list.
+	void clear() noexcept;
+
+private:
+	retired_node* first_{nullptr};
+	retired_node* last_{nullptr};
+};
+
+} // namespace detail
+} // namespace channels
@@ -2,12 +2,25 @@
 #include "compatibility/compile_features.h"
 #include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <exception>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <type_traits>
 #include <utility>
 
 namespace channels {
+
+template<typename T>
+class future;
+
+template<typename T>
+struct embedded_promise;
+
 namespace detail {
 
 // Problem:
@@ -26,25 +39,11 @@ namespace detail {
 // | callback 1 | ... | callback n |         | std::future |
 // |____________|     |____________|         |_____________|
 //
-// The idea is to merge execution_shared_state and future_shared_state into one object:
-// template<typename T, ...
-// class execution_shared_state : public future_shared_state<T> {
-// ...
-// };
-// ...
-// template<typename T, ...
-// class callback {
-// 	callback(std::shared_ptr<execution_shared_state> shared_steate);
-// ...
-// };
-// ...
-// template<typename T>
-// class future {
-// 	explicit future(std::shared_ptr<future_shared_state<T>> shared_state);
-// ...
-// };
-// ...
-// It will look like this:
+// Solution:
+// If the promise is `channels::embedded_promise` then execution_shared_state is derived from
+// future_shared_state_interface and `channels::future` refers to the execution_shared_state itself. Both the callbacks
+// and the future keep intrusive references to the same object (see `reference_counted`), so the whole sending requires
+// one allocation. It looks like this:
 //              ________________________
 //             | execution_shared_state |
 //             |________________________|
@@ -54,6 +53,77 @@ namespace detail {
 // | callback 1 | ... | callback n |     | future |
 // |____________|     |____________|     |________|
 
+// This class is a base of objects which are shared between the owners by intrusive references.
+// The object is deleted when the last reference is removed. Classes that share one object must derive from it
+// virtually.
+class reference_counted {
+public:
+	reference_counted(const reference_counted&) = delete;
+	reference_counted(reference_counted&&) = delete;
+	reference_counted& operator=(const reference_counted&) = delete;
+	reference_counted& operator=(reference_counted&&) = delete;
+
+	void add_reference() noexcept;
+	void remove_reference() noexcept;
+
+protected:
+	reference_counted() = default;
+	virtual ~reference_counted() = default;
+
+private:
+	std::atomic<std::size_t> references_number_{0};
+};
+
+// The part of the shared state which is used by `channels::future`.
+template<typename T>
+class future_shared_state_interface : public virtual reference_counted {
+public:
+	using value_type = T;
+
+	CHANNELS_NODISCARD bool is_ready() const noexcept;
+	void wait() const;
+	template<typename Rep, typename Period>
+	CHANNELS_NODISCARD bool wait_for(const std::chrono::duration<Rep, Period>& timeout_duration) const;
+
+	// Waits until the shared state is ready and moves the value out of it (or rethrows the stored exception).
+	CHANNELS_NODISCARD value_type take_value();
+	// Calls the continuation when the shared state becomes ready. The continuation is called in the thread that makes
+	// the shared state ready, or immediately if the shared state is ready already. It mustn't throw exceptions because
+	// the shared state is made ready by `noexcept` functions.
+	// The continuation is kept in the storage of the shared state if it fits there, otherwise it is allocated. If the
+	// function throws, the continuation is neither kept nor called.
+	template<typename Continuation>
+	void set_continuation(Continuation&& continuation);
+
+protected:
+	template<typename U>
+	explicit future_shared_state_interface(U&& value) noexcept(std::is_nothrow_constructible<T, U>::value);
+	~future_shared_state_interface() override;
+
+	void make_ready(std::exception_ptr exception);
+	CHANNELS_NODISCARD value_type& get_value() noexcept;
+
+private:
+	// continuations that don't fit into the storage are allocated and the storage keeps the pointer to them
+	static constexpr std::size_t continuation_storage_size = 4 * sizeof(void*);
+
+	template<typename Continuation>
+	void store_continuation(Continuation&& continuation, std::true_type is_inline);
+	template<typename Continuation>
+	void store_continuation(Continuation&& continuation, std::false_type is_inline);
+
+	value_type value_;
+	std::exception_ptr exception_;
+	std::atomic<bool> ready_{false};
+	mutable std::mutex ready_mutex_;
+	mutable std::condition_variable ready_condition_;
+	// the stored continuation is called and destroyed by `call_continuation_` or only destroyed by
+	// `destroy_continuation_` (both are null if there is no continuation)
+	void (*call_continuation_)(void*) = nullptr;
+	void (*destroy_continuation_)(void*) = nullptr;
+	alignas(std::max_align_t) unsigned char continuation_storage_[continuation_storage_size]{}; // NOLINT
+};
+
 template<typename T, typename Promise>
 class future_shared_state {
 public:
@@ -83,8 +153,179 @@ private:
 	Promise promise_;
 };
 
+// This specialization keeps the value itself and passes it to `channels::future`.
+// \note The class that derives from it must be allocated by `new` and be kept by intrusive references.
+template<typename T>
+class future_shared_state<T, embedded_promise<T>> : public future_shared_state_interface<T> {
+public:
+	using value_type = T;
+
+	template<typename U>
+	future_shared_state(U&& value, const embedded_promise<T>& promise)
+		noexcept(std::is_nothrow_constructible<T, U>::value);
+
+	using future_shared_state_interface<T>::is_ready;
+
+	void make_ready(std::exception_ptr exception = nullptr);
+
+	CHANNELS_NODISCARD future<T> get_future();
+
+	CHANNELS_NODISCARD value_type& get_value() noexcept;
+};
+
 // implementation
 
+// reference_counted
+
+inline void reference_counted::add_reference() noexcept
+{
+	references_number_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void reference_counted::remove_reference() noexcept
+{
+	if (references_number_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete this; // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+// future_shared_state_interface
+
+template<typename T>
+template<typename U>
+future_shared_state_interface<T>::future_shared_state_interface(U&& value)
+	noexcept(std::is_nothrow_constructible<T, U>::value)
+	: value_{std::forward<U>(value)}
+{}
+
+template<typename T>
+bool future_shared_state_interface<T>::is_ready() const noexcept
+{
+	return ready_.load(std::memory_order_acquire);
+}
+
+template<typename T>
+void future_shared_state_interface<T>::wait() const
+{
+	if (is_ready())
+		return;
+
+	std::unique_lock<std::mutex> ready_lock{ready_mutex_};
+	ready_condition_.wait(ready_lock, [this] { return is_ready(); });
+}
+
+template<typename T>
+template<typename Rep, typename Period>
+bool future_shared_state_interface<T>::wait_for(const std::chrono::duration<Rep, Period>& timeout_duration) const
+{
+	if (is_ready())
+		return true;
+
+	std::unique_lock<std::mutex> ready_lock{ready_mutex_};
+	return ready_condition_.wait_for(ready_lock, timeout_duration, [this] { return is_ready(); });
+}
+
+template<typename T>
+typename future_shared_state_interface<T>::value_type future_shared_state_interface<T>::take_value()
+{
+	wait();
+
+	if (exception_)
+		std::rethrow_exception(exception_);
+
+	return std::move(value_);
+}
+
+template<typename T>
+template<typename Continuation>
+void future_shared_state_interface<T>::set_continuation(Continuation&& continuation)
+{
+	using continuation_type = std::decay_t<Continuation>;
+	using is_inline = std::integral_constant<
+		bool,
+		sizeof(continuation_type) <= continuation_storage_size &&
+			alignof(continuation_type) <= alignof(std::max_align_t)>;
+
+	{
+		const std::lock_guard<std::mutex> ready_lock{ready_mutex_};
+		if (!is_ready()) {
+			assert(!call_continuation_); // NOLINT
+			store_continuation(std::forward<Continuation>(continuation), is_inline{});
+			return;
+		}
+	}
+
+	continuation();
+}
+
+template<typename T>
+template<typename Continuation>
+void future_shared_state_interface<T>::store_continuation(Continuation&& continuation, std::true_type)
+{
+	using continuation_type = std::decay_t<Continuation>;
+
+	::new (static_cast<void*>(continuation_storage_)) continuation_type(std::forward<Continuation>(continuation));
+	call_continuation_ = [](void* const storage) {
+		continuation_type& stored = *static_cast<continuation_type*>(storage);
+		stored();
+		stored.~continuation_type();
+	};
+	destroy_continuation_ = [](void* const storage) { static_cast<continuation_type*>(storage)->~continuation_type(); };
+}
+
+template<typename T>
+template<typename Continuation>
+void future_shared_state_interface<T>::store_continuation(Continuation&& continuation, std::false_type)
+{
+	using continuation_type = std::decay_t<Continuation>;
+
+	::new (static_cast<void*>(continuation_storage_))
+		continuation_type*(new continuation_type(std::forward<Continuation>(continuation)));
+	call_continuation_ = [](void* const storage) {
+		const std::unique_ptr<continuation_type> stored{*static_cast<continuation_type**>(storage)};
+		(*stored)();
+	};
+	destroy_continuation_ = [](void* const storage) { delete *static_cast<continuation_type**>(storage); };
+}
+
+template<typename T>
+future_shared_state_interface<T>::~future_shared_state_interface()
+{
+	if (destroy_continuation_)
+		destroy_continuation_(continuation_storage_);
+}
+
+template<typename T>
+void future_shared_state_interface<T>::make_ready(std::exception_ptr exception)
+{
+	void (*call_continuation)(void*) = nullptr;
+	{
+		const std::lock_guard<std::mutex> ready_lock{ready_mutex_};
+		if (is_ready())
+			throw std::future_error{std::future_errc::promise_already_satisfied};
+
+		exception_ = std::move(exception);
+		ready_.store(true, std::memory_order_release);
+		call_continuation = call_continuation_;
+		call_continuation_ = nullptr;
+		destroy_continuation_ = nullptr;
+	}
+	ready_condition_.notify_all();
+
+	// the storage isn't changed after the shared state is ready
+	if (call_continuation)
+		call_continuation(continuation_storage_);
+}
+
+template<typename T>
+typename future_shared_state_interface<T>::value_type& future_shared_state_interface<T>::get_value() noexcept
+{
+	assert(!is_ready()); // NOLINT
+
+	return value_;
+}
+
+// future_shared_state
+
 template<typename T, typename Promise>
 template<typename U, typename P>
 future_shared_state<T, Promise>::future_shared_state(U&& value, P&& promise)
@@ -127,5 +368,33 @@ typename future_shared_state<T, Promise>::value_type& future_shared_state<T, Pro
 	return value_;
 }
 
+// future_shared_state<T, embedded_promise<T>>
+
+template<typename T>
+template<typename U>
+future_shared_state<T, embedded_promise<T>>::future_shared_state(U&& value, const embedded_promise<T>&)
+	noexcept(std::is_nothrow_constructible<T, U>::value)
+	: future_shared_state_interface<T>{std::forward<U>(value)}
+{}
+
+template<typename T>
+void future_shared_state<T, embedded_promise<T>>::make_ready(std::exception_ptr exception)
+{
+	future_shared_state_interface<T>::make_ready(std::move(exception));
+}
+
+template<typename T>
+future<T> future_shared_state<T, embedded_promise<T>>::get_future()
+{
+	return future<T>{*this};
+}
+
+template<typename T>
+typename future_shared_state<T, embedded_promise<T>>::value_type&
+future_shared_state<T, embedded_promise<T>>::get_value() noexcept
+{
+	return future_shared_state_interface<T>::get_value();
+}
+
 } // namespace detail
 } // namespace channels
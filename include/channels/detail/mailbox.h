@@ -0,0 +1,212 @@
+#pragma once
+#include "../mailbox.h"
+#include "atomic_wait.h"
+#include "bounded_queue.h"
+#include "compatibility/compile_features.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace channels {
+namespace detail {
+
+// Counters of a mailbox that are independent of the type of values.
+class mailbox_counters {
+public:
+	CHANNELS_NODISCARD mailbox_statistics get_statistics() const noexcept;
+
+protected:
+	mailbox_counters() = default;
+	~mailbox_counters() = default;
+
+	// the depth can be negative for a moment because a value can be taken before the sender has counted it
+	std::atomic<std::ptrdiff_t> depth_{0};
+	std::atomic<std::uint64_t> dropped_number_{0};
+};
+
+// Bounded queue of values of one callback function connected with an executor.
+// The values are kept in a lock-free multi-producer multi-consumer queue: the senders push the values, the task of the
+// callback function pops them, and the senders can also pop values to apply the overflow policy.
+// The mailbox also tracks if the task is scheduled, so at most one task of the callback function exists at a time:
+// `push` calls the schedule function only if the task isn't scheduled, and the task calls `finish_draining` when the
+// mailbox is empty (or when the callback function throws) to check if it has to continue.
+// With the `block_sender` policy a sender of a full mailbox sleeps on the counter of popped values until the task
+// takes a value.
+template<typename T>
+class mailbox : public mailbox_counters {
+public:
+	using value_type = T;
+
+	explicit mailbox(const mailbox_options& options);
+
+	mailbox(const mailbox&) = delete;
+	mailbox(mailbox&&) = delete;
+	mailbox& operator=(const mailbox&) = delete;
+	mailbox& operator=(mailbox&&) = delete;
+
+	~mailbox() = default;
+
+	// Pushes the value according to the overflow policy. The `is_cancelled` function is checked while the sender is
+	// blocked, the value is dropped if it returns `true`.
+	// The `schedule` function is called if the task that drains the mailbox isn't scheduled: after the value is pushed,
+	// and also if the mailbox is full, because the values left by an interrupted task have to be drained by somebody.
+	template<typename IsCancelled, typename Schedule>
+	void push(value_type value, const IsCancelled& is_cancelled, const Schedule& schedule);
+
+	CHANNELS_NODISCARD bool pop(value_type& value) noexcept;
+
+	// It is called by the task when the mailbox is empty or the callback function has thrown.
+	// \return `true` if the task must continue draining the mailbox or schedule a new task.
+	CHANNELS_NODISCARD bool finish_draining() noexcept;
+	// It is called if the task can't be scheduled.
+	void cancel_draining() noexcept;
+
+private:
+	// Disconnecting the callback function doesn't wake up the blocked sender, so it checks `is_cancelled` that often.
+	static constexpr std::chrono::milliseconds cancellation_check_interval{10};
+
+	// Tries to push the value again and sleeps until the task pops a value if the mailbox is still full.
+	// \return `true` if the value is pushed.
+	CHANNELS_NODISCARD bool wait_push(value_type& value) noexcept;
+
+	void drop_one() noexcept;
+
+	overflow_policy policy_;
+	bounded_queue<value_type> queue_;
+	std::atomic<bool> draining_scheduled_{false};
+	// it is changed after each `pop` with the `block_sender` policy, the blocked senders sleep on it
+	std::atomic<std::uint32_t> popped_sequence_{0};
+	std::atomic<std::uint32_t> blocked_senders_number_{0};
+};
+
+// implementation
+
+// mailbox_counters
+
+inline mailbox_statistics mailbox_counters::get_statistics() const noexcept
+{
+	mailbox_statistics result;
+	const std::ptrdiff_t depth = depth_.load(std::memory_order_relaxed);
+	result.depth = depth > 0 ? static_cast<std::size_t>(depth) : 0;
+	result.dropped_number = dropped_number_.load(std::memory_order_relaxed);
+	return result;
+}
+
+// mailbox
+
+template<typename T>
+mailbox<T>::mailbox(const mailbox_options& options)
+	: policy_{options.policy}
+	, queue_{options.capacity}
+{}
+
+template<typename T>
+template<typename IsCancelled, typename Schedule>
+void mailbox<T>::push(value_type value, const IsCancelled& is_cancelled, const Schedule& schedule)
+{
+	if (policy_ == overflow_policy::conflate) {
+		// only the latest value is kept
+		value_type dropped;
+		while (pop(dropped))
+			dropped_number_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool pushed = queue_.try_push(value);
+	while (!pushed) {
+		switch (policy_) {
+		case overflow_policy::drop_oldest:
+			drop_one();
+			break;
+		case overflow_policy::drop_newest:
+			dropped_number_.fetch_add(1, std::memory_order_relaxed);
+			if (!draining_scheduled_.exchange(true, std::memory_order_seq_cst))
+				schedule();
+			return;
+		case overflow_policy::block_sender:
+			if (is_cancelled()) {
+				dropped_number_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			// otherwise nobody would pop a value for the sender
+			if (!draining_scheduled_.exchange(true, std::memory_order_seq_cst))
+				schedule();
+			if (wait_push(value))
+				pushed = true;
+			continue;
+		case overflow_policy::conflate:
+			drop_one();
+			break;
+		}
+		pushed = queue_.try_push(value);
+	}
+
+	depth_.fetch_add(1, std::memory_order_seq_cst);
+	if (!draining_scheduled_.exchange(true, std::memory_order_seq_cst))
+		schedule();
+}
+
+template<typename T>
+bool mailbox<T>::pop(value_type& value) noexcept
+{
+	if (!queue_.try_pop(value))
+		return false;
+
+	depth_.fetch_sub(1, std::memory_order_relaxed);
+
+	if (policy_ == overflow_policy::block_sender) {
+		// a sender that has counted itself before this increment sees the new sequence and doesn't sleep, otherwise it
+		// is counted here and gets woken up
+		popped_sequence_.fetch_add(1, std::memory_order_seq_cst);
+		if (blocked_senders_number_.load(std::memory_order_seq_cst) != 0)
+			atomic_notify_all(popped_sequence_);
+	}
+	return true;
+}
+
+template<typename T>
+bool mailbox<T>::finish_draining() noexcept
+{
+	draining_scheduled_.store(false, std::memory_order_seq_cst);
+	// a sender that has pushed a value after the last `pop` either sees that the task isn't scheduled (and schedules
+	// a new one) or its value is counted here
+	if (depth_.load(std::memory_order_seq_cst) <= 0)
+		return false;
+
+	return !draining_scheduled_.exchange(true, std::memory_order_seq_cst);
+}
+
+template<typename T>
+void mailbox<T>::cancel_draining() noexcept
+{
+	draining_scheduled_.store(false, std::memory_order_seq_cst);
+}
+
+template<typename T>
+constexpr std::chrono::milliseconds mailbox<T>::cancellation_check_interval;
+
+template<typename T>
+bool mailbox<T>::wait_push(value_type& value) noexcept
+{
+	blocked_senders_number_.fetch_add(1, std::memory_order_seq_cst);
+	const std::uint32_t sequence = popped_sequence_.load(std::memory_order_seq_cst);
+	const bool pushed = queue_.try_push(value);
+	if (!pushed) {
+		const auto deadline = std::chrono::steady_clock::now() + cancellation_check_interval;
+		atomic_wait(popped_sequence_, sequence, &deadline);
+	}
+	blocked_senders_number_.fetch_sub(1, std::memory_order_relaxed);
+	return pushed;
+}
+
+template<typename T>
+void mailbox<T>::drop_one() noexcept
+{
+	value_type dropped;
+	if (pop(dropped))
+		dropped_number_.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,42 @@
+#pragma once
+#include "wake_signal.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace channels {
+namespace detail {
+
+// Base class of the shared states of channels that can be waited by `channels::selector`.
+// The source must increment its version with a sequentially consistent operation after it publishes an event and
+// before it calls `notify_selectors`, and `is_ready` must read the version the same way. So either the source sees the
+// registered selector or the selector sees the event.
+class select_source {
+public:
+	// Checks if the source has an event that the selector hasn't seen yet.
+	// \param version The version of the source last seen by the selector. It is updated if the event is reported.
+	virtual bool is_ready(std::uint64_t& version) const noexcept = 0;
+
+	void add_selector(wake_signal& notifier);
+	void remove_selector(wake_signal& notifier) noexcept;
+
+protected:
+	select_source() = default;
+	select_source(const select_source&) = delete;
+	select_source(select_source&&) = delete;
+	select_source& operator=(const select_source&) = delete;
+	select_source& operator=(select_source&&) = delete;
+	~select_source() = default;
+
+	void notify_selectors() noexcept;
+
+private:
+	std::atomic<std::size_t> selectors_number_{0};
+	std::mutex selectors_mutex_;
+	std::vector<wake_signal*> selectors_;
+};
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,159 @@
+#pragma once
+#include "compatibility/compile_features.h"
+#include "type_traits.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+namespace detail {
+
+// Returns the offset of the element number `index` in the packed (without padding) representation of `Ts...`.
+template<typename... Ts>
+constexpr std::size_t get_packed_offset(const std::size_t index) noexcept
+{
+	const std::size_t sizes[] = {sizeof(Ts)..., 0};
+	std::size_t offset = 0;
+	for (std::size_t i = 0; i < index; ++i)
+		offset += sizes[i]; // NOLINT
+	return offset;
+}
+
+enum class seqlock_load_status {
+	loaded,
+	empty, // the value has never been stored
+	busy, // a writer has held the lock during all attempts
+};
+
+// This class keeps a copy of a value of trivially copyable types `Ts...` protected by a sequence lock.
+// The writers (which must be serialized by the caller) make the sequence number odd while they are copying the value.
+// The readers copy the value and retry if the sequence number was odd or has changed, so they never write to the shared
+// memory and don't contend with each other. The value is stored in atomic words, so a torn read is not a data race: it
+// is detected and discarded.
+template<typename... Ts>
+class seqlock_value {
+	static_assert(is_trivially_copyable<Ts...>::value, "seqlock_value requires trivially copyable types");
+
+public:
+	using value_type = std::tuple<Ts...>;
+
+	void store(const value_type& value) noexcept;
+
+	// \return `false` if the value has never been stored.
+	CHANNELS_NODISCARD bool load(value_type& value) const noexcept;
+
+	// Same as `load` but it gives up after `attempts` checks of the lock held by a writer. The writer can be another
+	// process that has died while copying the value, so the reader of the shared memory mustn't wait for it forever.
+	CHANNELS_NODISCARD seqlock_load_status try_load(value_type& value, std::size_t attempts) const noexcept;
+
+private:
+	using word_type = std::uintptr_t;
+
+	static constexpr std::size_t size = get_packed_offset<Ts...>(sizeof...(Ts));
+	static constexpr std::size_t words_number = (size + sizeof(word_type) - 1) / sizeof(word_type);
+	using buffer_type = std::array<word_type, words_number>;
+
+	template<std::size_t... Is>
+	static void serialize(const value_type& value, unsigned char* bytes, std::index_sequence<Is...>) noexcept;
+	template<std::size_t... Is>
+	static value_type deserialize(const unsigned char* bytes, std::index_sequence<Is...>) noexcept;
+	template<typename T>
+	static T read(const unsigned char* bytes) noexcept;
+
+	// even: the value is stable, odd: a writer is copying the value, zero: there is no value
+	std::atomic<std::size_t> sequence_{0};
+	std::array<std::atomic<word_type>, words_number> words_{};
+};
+
+// implementation
+
+template<typename... Ts>
+void seqlock_value<Ts...>::store(const value_type& value) noexcept
+{
+	buffer_type buffer{};
+	serialize(value, reinterpret_cast<unsigned char*>(buffer.data()), std::index_sequence_for<Ts...>{}); // NOLINT
+
+	const std::size_t sequence = sequence_.load(std::memory_order_relaxed);
+	sequence_.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (std::size_t i = 0; i < words_number; ++i)
+		words_[i].store(buffer[i], std::memory_order_relaxed); // NOLINT
+
+	sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+template<typename... Ts>
+bool seqlock_value<Ts...>::load(value_type& value) const noexcept
+{
+	// the writers of this process can't die without this reader, so it waits for them without a limit
+	return try_load(value, std::numeric_limits<std::size_t>::max()) == seqlock_load_status::loaded;
+}
+
+template<typename... Ts>
+seqlock_load_status seqlock_value<Ts...>::try_load(value_type& value, std::size_t attempts) const noexcept
+{
+	buffer_type buffer{};
+	for (;;) {
+		const std::size_t sequence = sequence_.load(std::memory_order_acquire);
+		if (sequence == 0)
+			return seqlock_load_status::empty;
+		if (sequence % 2 != 0) {
+			if (--attempts == 0)
+				return seqlock_load_status::busy;
+
+			std::this_thread::yield();
+			continue;
+		}
+
+		for (std::size_t i = 0; i < words_number; ++i)
+			buffer[i] = words_[i].load(std::memory_order_relaxed); // NOLINT
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence_.load(std::memory_order_relaxed) == sequence)
+			break;
+	}
+
+	value = deserialize(reinterpret_cast<const unsigned char*>(buffer.data()), std::index_sequence_for<Ts...>{}); // NOLINT
+	return seqlock_load_status::loaded;
+}
+
+template<typename... Ts>
+template<std::size_t... Is>
+void seqlock_value<Ts...>::serialize(
+	const value_type& value, unsigned char* bytes, std::index_sequence<Is...>) noexcept
+{
+	(void) value;
+	(void) bytes;
+	// the elements are packed without padding in order of declaration
+	const int dummy[] = {0, (std::memcpy(bytes, &std::get<Is>(value), sizeof(Ts)), bytes += sizeof(Ts), 0)...};
+	(void) dummy;
+}
+
+template<typename... Ts>
+template<std::size_t... Is>
+typename seqlock_value<Ts...>::value_type
+seqlock_value<Ts...>::deserialize(const unsigned char* bytes, std::index_sequence<Is...>) noexcept
+{
+	(void) bytes;
+	return value_type{read<Ts>(bytes + get_packed_offset<Ts...>(Is))...}; // NOLINT
+}
+
+template<typename... Ts>
+template<typename T>
+T seqlock_value<Ts...>::read(const unsigned char* const bytes) noexcept
+{
+	std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+	std::memcpy(&storage, bytes, sizeof(T));
+	return *reinterpret_cast<const T*>(&storage); // NOLINT
+}
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,61 @@
+#pragma once
+#include "compatibility/compile_features.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef CHANNELS_HAS_SHARED_MEMORY
+
+namespace channels {
+namespace detail {
+
+// Named POSIX shared memory object mapped to the address space of the process.
+class shared_memory {
+public:
+	struct create_tag {};
+
+	// Creates a zero-filled object of `size` bytes. An existing object with the same `name` is replaced: the processes
+	// that have mapped it keep the old object. The object is removed when this instance is destroyed unless it has been
+	// replaced by another creator.
+	// \throw channel_error If the object can't be created.
+	shared_memory(create_tag, std::string name, std::size_t size);
+
+	// Opens the existing object.
+	// \throw channel_error If there is no object with the `name` or it is smaller than `size` bytes.
+	shared_memory(std::string name, std::size_t size);
+
+	shared_memory(const shared_memory&) = delete;
+	shared_memory(shared_memory&&) = delete;
+	shared_memory& operator=(const shared_memory&) = delete;
+	shared_memory& operator=(shared_memory&&) = delete;
+
+	~shared_memory() noexcept;
+
+	CHANNELS_NODISCARD void* get_address() const noexcept;
+
+private:
+	void map(int descriptor);
+	// Removes the name if it still refers to the created object. POSIX can't remove the name of a descriptor, so an
+	// object that replaces this one between the check and the removal is removed instead.
+	void unlink() const noexcept;
+
+	std::string name_;
+	std::size_t size_;
+	void* address_ = nullptr;
+	bool is_owner_;
+	// identity of the created object (`st_dev` and `st_ino`)
+	std::uint64_t device_ = 0;
+	std::uint64_t inode_ = 0;
+};
+
+// Returns the identifier of the current process.
+CHANNELS_NODISCARD std::int64_t get_process_id() noexcept;
+
+// Checks if the process with the `id` exists.
+// \note An identifier reused by the system for a new process is mistaken for the old process.
+CHANNELS_NODISCARD bool is_process_alive(std::int64_t id) noexcept;
+
+} // namespace detail
+} // namespace channels
+
+#endif
@@ -1,55 +1,212 @@
 #pragma once
+#include "../error.h"
+#include "../error_policy.h"
 #include "cast_view.h"
 #include "compatibility/apply.h"
 #include "compatibility/compile_features.h"
+#include "mailbox.h"
 #include "shared_state_base.h"
 #include <cassert>
+#include <cstddef>
 #include <cow/optional.h>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace channels {
 namespace detail {
 
+// This class refers to the value that is sent to the sockets.
+// The value is either an object on the sender stack or an already shared value. Immediately invocable sockets read
+// the value by reference, so sending to them doesn't allocate memory. The shared value is created (by moving the
+// object) only when the first deferred socket needs to pass it to its task.
+template<typename T>
+class shared_reference {
+public:
+	using value_type = T;
+	using shared_value_type = cow::optional<T>;
+
+	// The `value` must outlive this object and must not be used after the shared value is created.
+	explicit shared_reference(value_type& value) noexcept
+		: value_{&value}
+	{}
+
+	explicit shared_reference(shared_value_type shared_value) noexcept
+		: shared_value_{std::move(shared_value)}
+	{}
+
+	shared_reference(const shared_reference&) = delete;
+	shared_reference(shared_reference&&) = delete;
+	shared_reference& operator=(const shared_reference&) = delete;
+	shared_reference& operator=(shared_reference&&) = delete;
+
+	~shared_reference() = default;
+
+	CHANNELS_NODISCARD const value_type& get() const noexcept;
+
+	// Returns the shared value. Creates it on the first call if the object refers to the value on the stack.
+	CHANNELS_NODISCARD const shared_value_type& get_shared();
+
+private:
+	value_type* value_{nullptr};
+	shared_value_type shared_value_;
+};
+
+// Tag of the connection that delivers only the latest pending value to the callback function.
+struct conflated_tag {};
+
 // This class keeps resources that are shared between all copies of the channel object (for example callbacks).
 template<typename... Ts>
 struct shared_state : shared_state_base {
 	using shared_value_type = cow::optional<std::tuple<Ts...>>;
+	using value_reference = shared_reference<std::tuple<Ts...>>;
+	using batch_type = std::vector<std::tuple<Ts...>>;
+	using batch_reference = shared_reference<batch_type>;
+	using mailbox_type = mailbox<shared_value_type>;
+
+	using exceptions_type = callbacks_exception::exceptions_type;
 
 	struct connection_result;
 	class invocable_socket;
 	using invocable_sockets_shared_view = cast_view<sockets_shared_view, invocable_socket>;
 
+	explicit shared_state(const bool is_single_threaded = false)
+		: shared_state_base{is_single_threaded}
+	{}
+
+	// Makes the socket by one of the `make_invocable_socket` overloads and adds it with the `priority`.
+	template<typename... Args>
+	invocable_socket& connect(int priority, Args&&... args);
+
 	template<typename Callback>
-	invocable_socket& connect(Callback&& callback);
+	socket_pointer<invocable_socket> make_invocable_socket(Callback&& callback);
+
+	template<typename Executor, typename Callback>
+	socket_pointer<invocable_socket> make_invocable_socket(Executor&& executor, Callback&& callback);
+
+	template<typename Executor, typename Callback>
+	socket_pointer<invocable_socket> make_invocable_socket(
+		std::shared_ptr<mailbox_type> mailbox, Executor&& executor, Callback&& callback);
 
 	template<typename Executor, typename Callback>
-	invocable_socket& connect(Executor&& executor, Callback&& callback);
+	socket_pointer<invocable_socket> make_invocable_socket(conflated_tag, Executor&& executor, Callback&& callback);
 
 	invocable_sockets_shared_view get_sockets();
+
+	// Passes the value to the sockets and handles the exceptions they throw according to the error policy.
+	template<typename Policy>
+	void deliver(Policy, invocable_sockets_shared_view sockets, value_reference& value, exceptions_type& exceptions)
+		noexcept(std::is_same<Policy, policy::nothrow>::value);
+	// Same as previous method `deliver` but adds to the `counters` instead of recording the sending in the statistics,
+	// so a sending to several lists of sockets is recorded once.
+	// \return `false` if the sending is stopped by the error policy.
+	template<typename Policy>
+	bool deliver(
+		Policy,
+		invocable_sockets_shared_view sockets,
+		value_reference& value,
+		statistics::send_counters& counters,
+		exceptions_type& exceptions) noexcept(std::is_same<Policy, policy::nothrow>::value);
+	// Passes all values of the batch to each socket and handles the exceptions they throw according to the error
+	// policy.
+	template<typename Policy>
+	void deliver(Policy, invocable_sockets_shared_view sockets, batch_reference& values, exceptions_type& exceptions)
+		noexcept(std::is_same<Policy, policy::nothrow>::value);
+
+private:
+	// Call the socket and handle its exception according to the error policy.
+	// \return `false` if the sending must be stopped.
+	template<typename Call>
+	static bool call_socket(
+		policy::collect_exceptions, Call&& call, statistics::send_counters& counters, exceptions_type& exceptions);
+	template<typename Call>
+	static bool call_socket(
+		policy::fail_fast, Call&& call, statistics::send_counters& counters, exceptions_type& exceptions);
+	template<typename Call>
+	static bool call_socket(
+		policy::nothrow, Call&& call, statistics::send_counters& counters, exceptions_type& exceptions) noexcept;
 };
 
 // implementation
 
+// shared_reference
+
+template<typename T>
+const typename shared_reference<T>::value_type& shared_reference<T>::get() const noexcept
+{
+	assert(shared_value_ || value_); // NOLINT
+	return shared_value_ ? *shared_value_ : *value_;
+}
+
+template<typename T>
+const typename shared_reference<T>::shared_value_type& shared_reference<T>::get_shared()
+{
+	if (!shared_value_) {
+		assert(value_); // NOLINT
+		shared_value_ = shared_value_type{cow::in_place, std::move(*value_)};
+	}
+	return shared_value_;
+}
+
 // shared_state
 
 template<typename... Ts>
 class shared_state<Ts...>::invocable_socket : public socket_base {
 public:
-	void operator()(const shared_value_type& shared_value)
+	void operator()(value_reference& value)
+	{
+		invoke_(*this, value);
+	}
+
+	void operator()(shared_value_type shared_value)
+	{
+		value_reference value{std::move(shared_value)};
+		invoke_(*this, value);
+	}
+
+	// Passes the values of the batch starting from `position` to the socket.
+	// If the callback throws an exception, `position` is left at the value that caused it, so the caller can continue
+	// from the next value. Otherwise `position` is set to the batch size.
+	void operator()(batch_reference& values, std::size_t& position)
 	{
-		invoke(shared_value);
+		invoke_batch_(*this, values, position);
 	}
 
 protected:
-	virtual void invoke(const shared_value_type& shared_value) = 0;
+	using invoke_function_type = void (*)(invocable_socket& socket, value_reference& value);
+	using invoke_batch_function_type =
+		void (*)(invocable_socket& socket, batch_reference& values, std::size_t& position);
+
+	invocable_socket(const invoke_function_type invoke, const invoke_batch_function_type invoke_batch) noexcept
+		: invoke_{invoke}
+		, invoke_batch_{invoke_batch}
+	{}
+
+	~invocable_socket() = default;
+
+private:
+	invoke_function_type invoke_;
+	invoke_batch_function_type invoke_batch_;
 };
 
+template<typename... Ts>
+template<typename... Args>
+typename shared_state<Ts...>::invocable_socket& shared_state<Ts...>::connect(const int priority, Args&&... args)
+{
+	socket_pointer<invocable_socket> socket_ptr = make_invocable_socket(std::forward<Args>(args)...);
+	invocable_socket& socket = *socket_ptr;
+	add(std::move(socket_ptr), priority);
+	return socket;
+}
+
 template<typename... Ts>
 template<typename Callback>
-typename shared_state<Ts...>::invocable_socket& shared_state<Ts...>::connect(Callback&& callback)
+socket_pointer<typename shared_state<Ts...>::invocable_socket> shared_state<Ts...>::make_invocable_socket(
+	Callback&& callback)
 {
 #ifdef CHANNELS_CPP_LIB_IS_INVOCABLE
 	static_assert(std::is_invocable_v<Callback, Ts...>, "Callback must be invocable with channel parameters");
@@ -58,52 +215,64 @@ typename shared_state<Ts...>::invocable_socket& shared_state<Ts...>::connect(Cal
 	class immediately_invocable_socket final : public invocable_socket {
 	public:
 		explicit immediately_invocable_socket(Callback&& callback)
-			: callback_{std::forward<Callback>(callback)}
+			: invocable_socket{&immediately_invocable_socket::invoke, &immediately_invocable_socket::invoke_batch}
+			, callback_{std::forward<Callback>(callback)}
 		{}
 
 	private:
-		void invoke(const shared_value_type& shared_value) override
+		static void invoke(invocable_socket& socket, value_reference& value)
 		{
-			assert(shared_value); // NOLINT
-
-			if (this->is_blocked())
+			auto& self = static_cast<immediately_invocable_socket&>(socket);
+			if (self.is_blocked())
 				return;
 
-			compatibility::apply(callback_, *shared_value);
+			compatibility::apply(self.callback_, value.get());
+		}
+
+		static void invoke_batch(invocable_socket& socket, batch_reference& values, std::size_t& position)
+		{
+			auto& self = static_cast<immediately_invocable_socket&>(socket);
+			const batch_type& batch = values.get();
+			for (; position < batch.size(); ++position) {
+				if (self.is_blocked()) {
+					position = batch.size();
+					return;
+				}
+
+				compatibility::apply(self.callback_, batch[position]);
+			}
 		}
 
 		std::decay_t<Callback> callback_;
 	};
 
-	auto socket_ptr = std::make_shared<immediately_invocable_socket>(std::forward<Callback>(callback));
-	invocable_socket& socket = *socket_ptr;
-	add(std::move(socket_ptr));
-	return socket;
+	return make_socket<immediately_invocable_socket>(std::forward<Callback>(callback));
 }
 
 template<typename... Ts>
 template<typename Executor, typename Callback>
-typename shared_state<Ts...>::invocable_socket& shared_state<Ts...>::connect(Executor&& executor, Callback&& callback)
+socket_pointer<typename shared_state<Ts...>::invocable_socket> shared_state<Ts...>::make_invocable_socket(
+	Executor&& executor, Callback&& callback)
 {
 #ifdef CHANNELS_CPP_LIB_IS_INVOCABLE
 	static_assert(std::is_invocable_v<Callback, const Ts&...>, "Callback must be invocable with channel parameters");
 #endif
 
-	class deferred_invocable_socket final
-		: public invocable_socket
-		, public std::enable_shared_from_this<deferred_invocable_socket> {
+	class deferred_invocable_socket final : public invocable_socket {
 	public:
 		deferred_invocable_socket(Executor&& executor, Callback&& callback)
-			: executor_{std::forward<Executor>(executor)}
+			: invocable_socket{&deferred_invocable_socket::invoke, &deferred_invocable_socket::invoke_batch}
+			, executor_{std::forward<Executor>(executor)}
 			, callback_{std::forward<Callback>(callback)}
 		{}
 
 	private:
-		void invoke(const shared_value_type& shared_value) override
+		static void invoke(invocable_socket& socket, value_reference& value_ref)
 		{
-			assert(shared_value); // NOLINT
-
-			auto task = [self = this->shared_from_this(), value = shared_value]() mutable
+			auto& this_socket = static_cast<deferred_invocable_socket&>(socket);
+			auto task = [
+				self = socket_pointer<deferred_invocable_socket>{this_socket},
+				value = value_ref.get_shared()]() mutable
 			{
 				if (!self || !value)
 					return; // executor call the task more than once
@@ -120,18 +289,251 @@ typename shared_state<Ts...>::invocable_socket& shared_state<Ts...>::connect(Exe
 
 			// if the current proposals for "Uniform function call" and "Execution support library" are accepted,
 			// then it will work with system executors
-			execute(executor_, std::move(task));
+			execute(this_socket.executor_, std::move(task));
+		}
+
+		static void invoke_batch(invocable_socket& socket, batch_reference& values, std::size_t& position)
+		{
+			auto& this_socket = static_cast<deferred_invocable_socket&>(socket);
+			// the rest of the batch is passed to one task, so it is never retried even if `execute` throws
+			const std::size_t first = position;
+			position = values.get().size();
+
+			auto task = [
+				self = socket_pointer<deferred_invocable_socket>{this_socket},
+				batch = values.get_shared(),
+				first]() mutable
+			{
+				if (!self || !batch)
+					return; // executor call the task more than once
+
+				const auto local_self = std::move(self);
+				const auto local_batch = std::move(batch);
+
+				assert(local_batch); // NOLINT
+				for (std::size_t i = first; i < local_batch->size(); ++i) {
+					if (local_self->is_blocked())
+						return;
+
+					compatibility::apply(local_self->callback_, (*local_batch)[i]);
+				}
+			};
+
+			execute(this_socket.executor_, std::move(task));
 		}
 
 		std::decay_t<Executor> executor_;
 		std::decay_t<Callback> callback_;
 	};
 
-	auto socket_ptr =
-		std::make_shared<deferred_invocable_socket>(std::forward<Executor>(executor), std::forward<Callback>(callback));
-	invocable_socket& socket = *socket_ptr;
-	add(std::move(socket_ptr));
-	return socket;
+	return make_socket<deferred_invocable_socket>(
+		std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Executor, typename Callback>
+socket_pointer<typename shared_state<Ts...>::invocable_socket> shared_state<Ts...>::make_invocable_socket(
+	std::shared_ptr<mailbox_type> mailbox, Executor&& executor, Callback&& callback)
+{
+#ifdef CHANNELS_CPP_LIB_IS_INVOCABLE
+	static_assert(std::is_invocable_v<Callback, const Ts&...>, "Callback must be invocable with channel parameters");
+#endif
+
+	// The values are pushed to the mailbox and one task at a time calls the callback function with all of them.
+	class mailbox_invocable_socket final : public invocable_socket {
+	public:
+		mailbox_invocable_socket(std::shared_ptr<mailbox_type> mailbox, Executor&& executor, Callback&& callback)
+			: invocable_socket{&mailbox_invocable_socket::invoke, &mailbox_invocable_socket::invoke_batch}
+			, mailbox_{std::move(mailbox)}
+			, executor_{std::forward<Executor>(executor)}
+			, callback_{std::forward<Callback>(callback)}
+		{}
+
+	private:
+		static void invoke(invocable_socket& socket, value_reference& value_ref)
+		{
+			auto& this_socket = static_cast<mailbox_invocable_socket&>(socket);
+			this_socket.push(value_ref.get_shared());
+		}
+
+		static void invoke_batch(invocable_socket& socket, batch_reference& values, std::size_t& position)
+		{
+			auto& this_socket = static_cast<mailbox_invocable_socket&>(socket);
+			const batch_type& batch = values.get();
+			// the task is scheduled by the first pushed value, otherwise a sender blocked by a later value of the batch
+			// would wait for a task that doesn't exist
+			for (; position < batch.size(); ++position)
+				this_socket.push(shared_value_type{cow::in_place, batch[position]});
+		}
+
+		void push(shared_value_type value)
+		{
+			mailbox_->push(
+				std::move(value), [this] { return this->is_blocked(); }, [this] { this->schedule(); });
+		}
+
+		void schedule()
+		{
+			auto task = [self = socket_pointer<mailbox_invocable_socket>{*this}]() mutable {
+				if (!self)
+					return; // executor call the task more than once
+
+				const auto local_self = std::move(self);
+				local_self->drain();
+			};
+
+			try {
+				execute(executor_, std::move(task));
+			}
+			catch (...) {
+				// the values stay in the mailbox and the next sending schedules a new task
+				mailbox_->cancel_draining();
+				throw;
+			}
+		}
+
+		void drain()
+		{
+			try {
+				shared_value_type value;
+				do {
+					while (mailbox_->pop(value)) {
+						const shared_value_type local_value = std::move(value);
+						if (!this->is_blocked())
+							compatibility::apply(callback_, *local_value);
+					}
+				} while (mailbox_->finish_draining());
+			}
+			catch (...) {
+				// the rest of the values and the values sent by the callback function are passed to a new task
+				if (mailbox_->finish_draining())
+					schedule();
+				throw;
+			}
+		}
+
+		std::shared_ptr<mailbox_type> mailbox_;
+		std::decay_t<Executor> executor_;
+		std::decay_t<Callback> callback_;
+	};
+
+	return make_socket<mailbox_invocable_socket>(
+		std::move(mailbox), std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename... Ts>
+template<typename Executor, typename Callback>
+socket_pointer<typename shared_state<Ts...>::invocable_socket> shared_state<Ts...>::make_invocable_socket(
+	conflated_tag, Executor&& executor, Callback&& callback)
+{
+#ifdef CHANNELS_CPP_LIB_IS_INVOCABLE
+	static_assert(std::is_invocable_v<Callback, const Ts&...>, "Callback must be invocable with channel parameters");
+#endif
+
+	// The socket keeps only the latest value that isn't passed to the callback function yet. At most one task is
+	// scheduled at a time, and it calls the callback function while there is a pending value.
+	class conflated_invocable_socket final : public invocable_socket {
+	public:
+		conflated_invocable_socket(Executor&& executor, Callback&& callback)
+			: invocable_socket{&conflated_invocable_socket::invoke, &conflated_invocable_socket::invoke_batch}
+			, executor_{std::forward<Executor>(executor)}
+			, callback_{std::forward<Callback>(callback)}
+		{}
+
+	private:
+		static void invoke(invocable_socket& socket, value_reference& value_ref)
+		{
+			auto& this_socket = static_cast<conflated_invocable_socket&>(socket);
+			this_socket.replace(value_ref.get_shared());
+		}
+
+		static void invoke_batch(invocable_socket& socket, batch_reference& values, std::size_t& position)
+		{
+			auto& this_socket = static_cast<conflated_invocable_socket&>(socket);
+			const batch_type& batch = values.get();
+			if (position >= batch.size())
+				return;
+
+			// the previous values of the batch would be replaced anyway
+			position = batch.size();
+			this_socket.replace(shared_value_type{cow::in_place, batch.back()});
+		}
+
+		void replace(shared_value_type value)
+		{
+			{
+				const std::lock_guard<std::mutex> lock{mutex_};
+				pending_value_ = std::move(value);
+				if (is_scheduled_)
+					return;
+
+				is_scheduled_ = true;
+			}
+
+			schedule();
+		}
+
+		void schedule()
+		{
+			auto task = [self = socket_pointer<conflated_invocable_socket>{*this}]() mutable {
+				if (!self)
+					return; // executor call the task more than once
+
+				const auto local_self = std::move(self);
+				local_self->drain();
+			};
+
+			try {
+				execute(executor_, std::move(task));
+			}
+			catch (...) {
+				// the value stays pending and the next sending schedules a new task
+				const std::lock_guard<std::mutex> lock{mutex_};
+				is_scheduled_ = false;
+				throw;
+			}
+		}
+
+		void drain()
+		{
+			for (;;) {
+				std::unique_lock<std::mutex> lock{mutex_};
+				if (!pending_value_ || this->is_blocked()) {
+					pending_value_ = shared_value_type{};
+					is_scheduled_ = false;
+					return;
+				}
+
+				const shared_value_type value = std::move(pending_value_);
+				pending_value_ = shared_value_type{};
+				lock.unlock();
+				assert(value); // NOLINT
+
+				try {
+					compatibility::apply(callback_, *value);
+				}
+				catch (...) {
+					// a value sent while the callback function was called is passed to a new task
+					lock.lock();
+					const bool must_schedule = pending_value_ && !this->is_blocked();
+					is_scheduled_ = must_schedule;
+					lock.unlock();
+					if (must_schedule)
+						schedule();
+					throw;
+				}
+			}
+		}
+
+		std::decay_t<Executor> executor_;
+		std::decay_t<Callback> callback_;
+		std::mutex mutex_;
+		shared_value_type pending_value_;
+		bool is_scheduled_ = false;
+	};
+
+	return make_socket<conflated_invocable_socket>(
+		std::forward<Executor>(executor), std::forward<Callback>(callback));
 }
 
 template<typename... Ts>
@@ -140,5 +542,110 @@ typename shared_state<Ts...>::invocable_sockets_shared_view shared_state<Ts...>:
 	return invocable_sockets_shared_view{shared_state_base::get_sockets()};
 }
 
+template<typename... Ts>
+template<typename Policy>
+void shared_state<Ts...>::deliver(
+	const Policy error_policy,
+	invocable_sockets_shared_view sockets,
+	value_reference& value,
+	exceptions_type& exceptions) noexcept(std::is_same<Policy, policy::nothrow>::value)
+{
+	const statistics::time_point start = statistics::now();
+	statistics::send_counters counters{1, 0, 0, 0};
+	deliver(error_policy, std::move(sockets), value, counters, exceptions);
+	get_statistics().add_send(start, counters);
+}
+
+template<typename... Ts>
+template<typename Policy>
+bool shared_state<Ts...>::deliver(
+	const Policy error_policy,
+	invocable_sockets_shared_view sockets,
+	value_reference& value,
+	statistics::send_counters& counters,
+	exceptions_type& exceptions) noexcept(std::is_same<Policy, policy::nothrow>::value)
+{
+	for (invocable_socket& socket : sockets) {
+		if (socket.is_blocked()) {
+			++counters.blocked_skips_number;
+			continue;
+		}
+
+		++counters.deliveries_number;
+		if (!call_socket(error_policy, [&socket, &value] { socket(value); }, counters, exceptions))
+			return false;
+	}
+	return true;
+}
+
+template<typename... Ts>
+template<typename Policy>
+void shared_state<Ts...>::deliver(
+	const Policy error_policy,
+	invocable_sockets_shared_view sockets,
+	batch_reference& values,
+	exceptions_type& exceptions) noexcept(std::is_same<Policy, policy::nothrow>::value)
+{
+	const statistics::time_point start = statistics::now();
+	const std::size_t values_number = values.get().size();
+	statistics::send_counters counters{values_number, 0, 0, 0};
+
+	bool is_stopped = false;
+	for (auto socket = sockets.begin(); !is_stopped && socket != sockets.end(); ++socket) {
+		if (socket->is_blocked()) {
+			++counters.blocked_skips_number;
+			continue;
+		}
+
+		++counters.deliveries_number;
+		for (std::size_t position = 0; !is_stopped && position < values_number; ++position) {
+			is_stopped = !call_socket(
+				error_policy, [&socket, &values, &position] { (*socket)(values, position); }, counters, exceptions);
+		}
+	}
+
+	get_statistics().add_send(start, counters);
+}
+
+template<typename... Ts>
+template<typename Call>
+bool shared_state<Ts...>::call_socket(
+	policy::collect_exceptions, Call&& call, statistics::send_counters& counters, exceptions_type& exceptions)
+{
+	try {
+		call();
+	}
+	catch (...) {
+		++counters.exceptions_number;
+		exceptions.push_back(std::current_exception());
+	}
+	return true;
+}
+
+template<typename... Ts>
+template<typename Call>
+bool shared_state<Ts...>::call_socket(
+	policy::fail_fast, Call&& call, statistics::send_counters& counters, exceptions_type& exceptions)
+{
+	try {
+		call();
+	}
+	catch (...) {
+		++counters.exceptions_number;
+		exceptions.push_back(std::current_exception());
+		return false;
+	}
+	return true;
+}
+
+template<typename... Ts>
+template<typename Call>
+bool shared_state<Ts...>::call_socket(
+	policy::nothrow, Call&& call, statistics::send_counters&, exceptions_type&) noexcept
+{
+	call();
+	return true;
+}
+
 } // namespace detail
 } // namespace channels
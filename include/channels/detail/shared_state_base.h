@@ -1,28 +1,248 @@
 #pragma once
 #include "compatibility/compile_features.h"
-#include "intrusive_list.h"
-#include "range_view.h"
+#include "connection_table.h"
+#include "epoch_reclamation.h"
+#include "socket_pool.h"
+#include "statistics.h"
 #include <atomic>
 #include <cstddef>
+#include <iterator>
 #include <memory>
-#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace channels {
 namespace detail {
 
-class socket_base : public intrusive_list::node {
+template<typename T>
+class socket_pointer;
+
+class shared_state_base;
+class sockets_snapshot;
+
+// Atomic pointer to the published snapshot of one list of sockets.
+using sockets_slot = std::atomic<sockets_snapshot*>;
+
+// Base class for all sockets.
+// The socket is owned by the shared state while it is connected and by the tasks that are scheduled for it, so it has
+// an intrusive reference counter instead of a separately allocated control block. A disconnected socket is retired in
+// the epoch domain of the shared state (the node is intrusive, so disconnection doesn't allocate memory) and the shared
+// state releases its reference when no sender can access the socket anymore.
+// Sockets have no virtual functions: the socket is created by `shared_state_base::make_socket` that stores a pointer
+// to the function destroying the socket of the concrete type and returning its memory to the place it was taken from.
+class socket_base : public retired_node {
+	template<typename>
+	friend class socket_pointer;
 	friend class shared_state_base;
 
 public:
+	socket_base(const socket_base&) = delete;
+	socket_base(socket_base&&) = delete;
+	socket_base& operator=(const socket_base&) = delete;
+	socket_base& operator=(socket_base&&) = delete;
+
 	void set_blocked(bool blocked) noexcept;
 	CHANNELS_NODISCARD bool is_blocked() const noexcept;
 
+	// The senders call the sockets with higher priority first. It is set before the socket is added to the shared
+	// state and isn't changed after that.
+	CHANNELS_NODISCARD int get_priority() const noexcept;
+
+	// Returns the handle of the entry in the connection table. It is set when the socket is added to the shared state.
+	CHANNELS_NODISCARD connection_table::handle get_connection() const noexcept;
+
+protected:
+	socket_base() noexcept;
+	~socket_base() = default;
+
 private:
+	using destroy_function_type = void (*)(socket_base& socket);
+
+	template<typename Socket>
+	static void destroy(socket_base& socket) noexcept;
+
+	static void reclaim(retired_node& node);
+
 	void add_reference() noexcept;
-	CHANNELS_NODISCARD std::size_t remove_reference() noexcept;
+	void remove_reference() noexcept;
 
+	destroy_function_type destroy_{nullptr};
+	socket_pool* pool_{nullptr}; // null if the socket is allocated by the global allocator
+	sockets_slot* slot_{nullptr}; // the list to which the socket is added
+	std::atomic<std::size_t> references_count_{1};
+	connection_table::handle connection_{};
+	int priority_{0};
 	std::atomic<bool> blocked_{false};
-	std::size_t references_count_{1};
+};
+
+// Smart pointer that shares ownership of a socket through its intrusive reference counter.
+template<typename T>
+class socket_pointer {
+	template<typename>
+	friend class socket_pointer;
+
+public:
+	socket_pointer() = default;
+
+	// Takes the ownership of the reference that `socket` already has (for example the initial one).
+	static socket_pointer adopt(T* socket) noexcept;
+
+	// Adds a new reference to the `socket`.
+	explicit socket_pointer(T& socket) noexcept;
+
+	socket_pointer(const socket_pointer& other) noexcept;
+	socket_pointer(socket_pointer&& other) noexcept;
+	template<typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+	socket_pointer(socket_pointer<U>&& other) noexcept; // NOLINT: Allow implicit conversion
+
+	socket_pointer& operator=(const socket_pointer& other) noexcept;
+	socket_pointer& operator=(socket_pointer&& other) noexcept;
+
+	~socket_pointer() noexcept;
+
+	// Returns the pointer and the ownership of its reference to the caller.
+	CHANNELS_NODISCARD T* release() noexcept;
+	void reset() noexcept;
+
+	CHANNELS_NODISCARD T* get() const noexcept;
+	CHANNELS_NODISCARD T* operator->() const noexcept;
+	CHANNELS_NODISCARD T& operator*() const noexcept;
+	explicit operator bool() const noexcept;
+
+private:
+	T* socket_{nullptr};
+};
+
+// Array of sockets allocated in one block together with its header.
+// Every `connect` publishes a new copy of this array, so the senders can iterate over it without locks
+// (read-copy-update). `disconnect` doesn't allocate memory: it stamps the entry of the socket in the current array with
+// the number of the erasure, and the next `connect` doesn't copy the erased entries. An iterator skips the entries
+// erased before it was created, so only the sendings that have started before the disconnection see the (blocked)
+// socket. The array doesn't own the sockets: they are owned by the shared state.
+class sockets_snapshot : public retired_node {
+public:
+	struct entry {
+		explicit entry(socket_base& socket) noexcept
+			: socket{&socket}
+		{}
+
+		socket_base* const socket;
+		// number of the erasure of the entry, zero while the socket is connected
+		std::atomic<std::size_t> erasure{0};
+	};
+
+	using value_type = entry;
+	using size_type = std::size_t;
+
+	class iterator;
+	struct deleter {
+		void operator()(sockets_snapshot* snapshot) const noexcept;
+	};
+	using pointer = std::unique_ptr<sockets_snapshot, deleter>;
+
+	// Makes a copy of `sockets` (which may be null) with `added` socket inserted and the erased entries dropped.
+	// The sockets are ordered by descending priority; the `added` socket is inserted after the sockets with the same
+	// priority, so the sockets of one priority keep the order of connection.
+	CHANNELS_NODISCARD static pointer make(const sockets_snapshot* sockets, socket_base& added);
+
+	sockets_snapshot(const sockets_snapshot&) = delete;
+	sockets_snapshot(sockets_snapshot&&) = delete;
+	sockets_snapshot& operator=(const sockets_snapshot&) = delete;
+	sockets_snapshot& operator=(sockets_snapshot&&) = delete;
+
+	CHANNELS_NODISCARD size_type size() const noexcept;
+	CHANNELS_NODISCARD const value_type* data() const noexcept;
+	CHANNELS_NODISCARD iterator begin() const noexcept;
+	CHANNELS_NODISCARD iterator end() const noexcept;
+
+	// Erases the entry of the `socket`. It is called by the writers, which are serialized.
+	void erase(const socket_base& socket) noexcept;
+
+private:
+	explicit sockets_snapshot(size_type size) noexcept;
+	~sockets_snapshot() = default;
+
+	static void reclaim(retired_node& node);
+
+	CHANNELS_NODISCARD value_type* mutable_data() noexcept;
+
+	size_type size_;
+	std::atomic<size_type> erasures_number_{0};
+};
+
+class sockets_snapshot::iterator { // NOLINT(cppcoreguidelines-special-member-functions)
+	friend bool operator==(iterator lhs, iterator rhs) noexcept // NOLINT
+	{
+		return lhs.item_ == rhs.item_;
+	}
+
+	friend bool operator!=(iterator lhs, iterator rhs) noexcept // NOLINT
+	{
+		return !(lhs == rhs);
+	}
+
+public:
+	using value_type = socket_base;
+	using pointer = socket_base*;
+	using reference = socket_base&;
+	using difference_type = std::ptrdiff_t;
+	using iterator_category = std::forward_iterator_tag;
+
+	iterator() = default;
+
+	iterator(
+		const sockets_snapshot::value_type* const item,
+		const sockets_snapshot::value_type* const end,
+		const size_type erasures_number) noexcept
+		: item_{item}
+		, end_{end}
+		, erasures_number_{erasures_number}
+	{
+		skip_erased();
+	}
+
+	iterator& operator++() noexcept
+	{
+		++item_; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		skip_erased();
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		const iterator tmp = *this;
+		++(*this);
+		return tmp;
+	}
+
+	CHANNELS_NODISCARD pointer operator->() const noexcept
+	{
+		return item_->socket;
+	}
+
+	CHANNELS_NODISCARD reference operator*() const noexcept
+	{
+		return *item_->socket;
+	}
+
+private:
+	// An entry erased after the iterator was created is kept: the socket can't be reclaimed while the reader that has
+	// created the iterator is pinned.
+	void skip_erased() noexcept
+	{
+		while (item_ != end_) {
+			const size_type erasure = item_->erasure.load(std::memory_order_acquire);
+			if (erasure == 0 || erasure > erasures_number_)
+				return;
+			++item_; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		}
+	}
+
+	const sockets_snapshot::value_type* item_{nullptr};
+	const sockets_snapshot::value_type* end_{nullptr};
+	size_type erasures_number_{0};
 };
 
 class sockets_shared_view;
@@ -30,6 +250,20 @@ class sockets_shared_view;
 // This class is a part of the channels shared state that is independent of the channel template parameters.
 // It provides resources for objects of type `channels::connection` (which are also independent of the channel template
 // parameters) and for `channels::detail::shared_state`.
+//
+// Sockets are kept in a `sockets_snapshot` published through an atomic pointer. Writers (`add` and `remove`) are
+// serialized by a mutex. `add` copies the current snapshot, publishes the modified copy and retires the old one.
+// `remove` is called by `noexcept` functions of the connections, so it doesn't allocate a new snapshot: it erases the
+// entry of the socket in the current one and retires the socket itself. Readers (`get_sockets`) don't take the mutex
+// and don't touch the reference counters of the sockets: they only pin themselves in the `epoch_domain` of the shared
+// state, so a retired snapshot or socket isn't reclaimed while some sender still can access it. Writers never wait
+// for readers: the reclamation is deferred to the next writer or to a reader that leaves while there are retired
+// objects. A sender that is blocked in a callback function delays the reclamation only of this shared state.
+// The single-threaded shared state (of channels with policy `single_thread`) doesn't take the mutex, doesn't pin the
+// thread and doesn't use the atomic flag of retired snapshots: it counts its nested readers and reclaims the retired
+// snapshots when there are none. Its thread is the one that uses it first, so the channel can be created by one thread
+// and handed to the event loop of another one. The class isn't a template, so the policy is a runtime flag and the
+// reference counters and the published pointers are atomic for both policies.
 class shared_state_base {
 public:
 	shared_state_base(const shared_state_base&) = delete;
@@ -37,36 +271,94 @@ public:
 	shared_state_base& operator=(const shared_state_base&) = delete;
 	shared_state_base& operator=(shared_state_base&&) = delete;
 
-	void remove(socket_base& socket);
+	CHANNELS_NODISCARD connection_table& get_connection_table() noexcept;
+
+	CHANNELS_NODISCARD statistics& get_statistics() noexcept;
+	CHANNELS_NODISCARD channel_statistics get_statistics_snapshot();
 
 protected:
+	friend class connection_table;
 	friend class sockets_shared_view;
 
-	shared_state_base() = default;
-	~shared_state_base() = default;
+	explicit shared_state_base(bool is_single_threaded = false);
+	~shared_state_base() noexcept;
+
+	// Creates a socket of type `Socket`. Sockets that fit into a block of the channel socket pool are allocated from
+	// the pool, the others are allocated by the global allocator.
+	template<typename Socket, typename... Args>
+	CHANNELS_NODISCARD socket_pointer<Socket> make_socket(Args&&... args);
 
-	void add(std::shared_ptr<socket_base> socket);
+	void add(socket_pointer<socket_base> socket, int priority);
 	sockets_shared_view get_sockets();
 
+	// The derived classes can keep several lists of sockets (like `channels::keyed_channel` with a list per key).
+	// These lists are published and reclaimed in the same way as the main list. The slot of the list mustn't move
+	// while it has sockets and it must be cleared by the derived class destructor. The first `clear` detaches the
+	// connections, so they don't remove sockets from the lists that are being destroyed.
+	void add(sockets_slot& sockets, socket_pointer<socket_base> socket, int priority);
+	sockets_shared_view get_sockets(const sockets_slot& sockets);
+	void clear(sockets_slot& sockets) noexcept;
+
+	// The derived classes can also publish their own immutable objects (like the key index of
+	// `channels::keyed_channel`) that are read by the senders. `publish` replaces the object in the `slot` and retires
+	// the old one in the epoch domain of the shared state. It returns the reclaimed objects, which can be disconnected
+	// sockets, so the caller must delete them after it unlocks its own mutexes. `find_sockets` pins the sender, calls
+	// `find` that reads these objects and returns a pointer to the slot of the list (or null), and keeps the pin in the
+	// returned view.
+	// \tparam T Type derived from `retired_node`.
+	template<typename T>
+	CHANNELS_NODISCARD retired_list publish(std::atomic<T*>& slot, std::unique_ptr<T> object);
+	template<typename Find>
+	sockets_shared_view find_sockets(const Find& find);
+
 private:
-	using sockets_container_type = intrusive_list;
-	using sockets_mutex_type = std::mutex;
-	using sockets_unique_lock_type = std::lock_guard<sockets_mutex_type>;
-	using sockets_shared_lock_type = sockets_unique_lock_type;
+	using snapshot_pointer = sockets_snapshot::pointer;
+	using sockets_unique_lock_type = connection_table::unique_lock_type;
 
-	void remove_reference(socket_base& socket, const sockets_unique_lock_type& lock) noexcept;
+	// Removes the socket of the connection that is being disconnected by the connection table. It doesn't allocate
+	// memory.
+	// \return The retired snapshots that must be deleted after the mutex is unlocked.
+	CHANNELS_NODISCARD retired_list remove(socket_base& socket, const sockets_unique_lock_type& lock);
 
-	mutable sockets_mutex_type sockets_mutex_;
-	sockets_container_type sockets_;
-};
+	CHANNELS_NODISCARD sockets_unique_lock_type lock_sockets();
+	void check_thread() noexcept;
+
+	// \return The pin of the reader or null if the shared state is single-threaded.
+	CHANNELS_NODISCARD epoch_domain::record* lock_shared();
+	void unlock_shared(epoch_domain::record* pin) noexcept;
 
-class CHANNELS_NODISCARD sockets_shared_view : public range_view<shared_state_base::sockets_container_type::iterator> {
-	using base_type = range_view<shared_state_base::sockets_container_type::iterator>;
+	void publish(sockets_slot& slot, snapshot_pointer sockets, const sockets_unique_lock_type& lock) noexcept;
+	void retire(retired_node& node, const sockets_unique_lock_type& lock) noexcept;
+	CHANNELS_NODISCARD retired_list collect_retired(const sockets_unique_lock_type& lock) noexcept;
 
+	socket_pool* socket_pool_; // owns one reference to the pool
+	// owns one reference to the table, its mutex guards the lists of sockets
+	connection_table* connection_table_;
+	const bool is_single_threaded_;
+	// the thread of the single-threaded shared state, it is set by the first connection or sending (checked in debug)
+	std::thread::id owner_thread_;
+	statistics statistics_;
+	sockets_slot sockets_{nullptr};
+	// number of sockets in all lists (guarded by the mutex of the connection table)
+	std::size_t sockets_number_{0};
+	// number of nested readers of the single-threaded shared state
+	std::size_t readers_number_{0};
+	// whether there are retired snapshots, it is used only by the multi-threaded shared state
+	std::atomic<bool> has_retired_{false};
+	epoch_domain epoch_domain_;
+	// retired snapshots and sockets in order of retirement (guarded by the mutex of the connection table)
+	retired_list retired_;
+};
+
+// Range of the sockets of one snapshot that keeps the reader pinned.
+class CHANNELS_NODISCARD sockets_shared_view {
 public:
+	using iterator = sockets_snapshot::iterator;
+	using difference_type = std::ptrdiff_t;
+
 	sockets_shared_view() = default;
 	sockets_shared_view(
-		shared_state_base& shared_state,  base_type::base_iterator_type first_item, base_type::size_type size);
+		shared_state_base& shared_state, const sockets_snapshot* sockets, epoch_domain::record* pin) noexcept;
 
 	sockets_shared_view(const sockets_shared_view&) = delete;
 	sockets_shared_view(sockets_shared_view&& other) noexcept;
@@ -76,11 +368,193 @@ public:
 
 	~sockets_shared_view() noexcept;
 
+	CHANNELS_NODISCARD iterator begin() const noexcept;
+	CHANNELS_NODISCARD iterator end() const noexcept;
+	CHANNELS_NODISCARD iterator cbegin() const noexcept;
+	CHANNELS_NODISCARD iterator cend() const noexcept;
+	CHANNELS_NODISCARD bool empty() const noexcept;
+
 private:
 	void reset() noexcept;
 
+	const sockets_snapshot* sockets_{};
 	shared_state_base* shared_state_{};
+	epoch_domain::record* pin_{};
 };
 
+// implementation
+
+// socket_base
+
+template<typename Socket>
+void socket_base::destroy(socket_base& socket) noexcept
+{
+	auto* const concrete_socket = static_cast<Socket*>(&socket);
+	socket_pool* const pool = socket.pool_;
+	if (pool) {
+		concrete_socket->~Socket();
+		pool->deallocate(concrete_socket);
+	}
+	else {
+		delete concrete_socket; // NOLINT(cppcoreguidelines-owning-memory)
+	}
+}
+
+// socket_pointer
+
+template<typename T>
+socket_pointer<T> socket_pointer<T>::adopt(T* const socket) noexcept
+{
+	socket_pointer result;
+	result.socket_ = socket;
+	return result;
+}
+
+template<typename T>
+socket_pointer<T>::socket_pointer(T& socket) noexcept
+	: socket_{&socket}
+{
+	static_cast<socket_base*>(socket_)->add_reference();
+}
+
+template<typename T>
+socket_pointer<T>::socket_pointer(const socket_pointer& other) noexcept
+	: socket_{other.socket_}
+{
+	if (socket_)
+		static_cast<socket_base*>(socket_)->add_reference();
+}
+
+template<typename T>
+socket_pointer<T>::socket_pointer(socket_pointer&& other) noexcept
+	: socket_{other.release()}
+{}
+
+template<typename T>
+template<typename U, typename>
+socket_pointer<T>::socket_pointer(socket_pointer<U>&& other) noexcept
+	: socket_{other.release()}
+{}
+
+template<typename T>
+socket_pointer<T>& socket_pointer<T>::operator=(const socket_pointer& other) noexcept
+{
+	socket_pointer copy{other};
+	return *this = std::move(copy);
+}
+
+template<typename T>
+socket_pointer<T>& socket_pointer<T>::operator=(socket_pointer&& other) noexcept
+{
+	if (this != &other) {
+		reset();
+		socket_ = other.release();
+	}
+	return *this;
+}
+
+template<typename T>
+socket_pointer<T>::~socket_pointer() noexcept
+{
+	reset();
+}
+
+template<typename T>
+T* socket_pointer<T>::release() noexcept
+{
+	T* const socket = socket_;
+	socket_ = nullptr;
+	return socket;
+}
+
+template<typename T>
+void socket_pointer<T>::reset() noexcept
+{
+	if (T* const socket = release())
+		static_cast<socket_base*>(socket)->remove_reference();
+}
+
+template<typename T>
+T* socket_pointer<T>::get() const noexcept
+{
+	return socket_;
+}
+
+template<typename T>
+T* socket_pointer<T>::operator->() const noexcept
+{
+	return socket_;
+}
+
+template<typename T>
+T& socket_pointer<T>::operator*() const noexcept
+{
+	return *socket_;
+}
+
+template<typename T>
+socket_pointer<T>::operator bool() const noexcept
+{
+	return socket_ != nullptr;
+}
+
+// shared_state_base
+
+template<typename Socket, typename... Args>
+socket_pointer<Socket> shared_state_base::make_socket(Args&&... args)
+{
+	static_assert(std::is_base_of<socket_base, Socket>::value, "Socket must be derived from socket_base");
+
+	Socket* socket = nullptr;
+	socket_pool* pool = nullptr;
+	if (sizeof(Socket) <= socket_pool::block_size && alignof(Socket) <= socket_pool::block_alignment) {
+		pool = socket_pool_;
+		void* const memory = pool->allocate();
+		try {
+			socket = new (memory) Socket{std::forward<Args>(args)...};
+		}
+		catch (...) {
+			pool->deallocate(memory);
+			throw;
+		}
+	}
+	else {
+		socket = new Socket{std::forward<Args>(args)...}; // NOLINT(cppcoreguidelines-owning-memory)
+	}
+
+	socket_base& base = *socket;
+	base.destroy_ = &socket_base::destroy<Socket>;
+	base.pool_ = pool;
+	return socket_pointer<Socket>::adopt(socket);
+}
+
+template<typename T>
+retired_list shared_state_base::publish(std::atomic<T*>& slot, std::unique_ptr<T> object)
+{
+	static_assert(std::is_base_of<retired_node, T>::value, "T must be derived from retired_node");
+
+	const sockets_unique_lock_type sockets_lock = lock_sockets();
+
+	T* const old_object = slot.exchange(object.release());
+	if (old_object)
+		retire(*old_object, sockets_lock);
+	return collect_retired(sockets_lock);
+}
+
+template<typename Find>
+sockets_shared_view shared_state_base::find_sockets(const Find& find)
+{
+	epoch_domain::record* const pin = lock_shared();
+	const sockets_slot* sockets = nullptr;
+	try {
+		sockets = find();
+	}
+	catch (...) {
+		unlock_shared(pin);
+		throw;
+	}
+	return sockets_shared_view{*this, sockets ? sockets->load() : nullptr, pin};
+}
+
 } // namespace detail
 } // namespace channels
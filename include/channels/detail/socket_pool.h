@@ -0,0 +1,64 @@
+#pragma once
+#include "compatibility/compile_features.h"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace channels {
+namespace detail {
+
+// This class allocates memory blocks of the same size for the sockets of one channel.
+// Freed blocks are kept in a free list and reused by the next connections, so connect/disconnect churn doesn't hit the
+// global allocator. Memory is requested from the global allocator in chunks of several blocks.
+// The pool has an intrusive reference counter: the shared state owns one reference and every allocated block owns
+// another, so the pool lives until both the channel and all its sockets (which can be kept by executor tasks) are
+// destroyed.
+// The pool of a single-threaded channel is allocated from only by the thread of the channel, so it doesn't lock the
+// mutex. Its sockets can still be destroyed by executor tasks in other threads, so the freed blocks are pushed to a
+// lock-free list that the allocating thread takes when its own free list is empty.
+class socket_pool {
+public:
+	// Maximum size of an object that can be allocated from the pool.
+	static constexpr std::size_t block_size = 160;
+	// Maximum alignment of an object that can be allocated from the pool.
+	static constexpr std::size_t block_alignment = alignof(std::max_align_t);
+
+	// Creates a pool with one reference that is owned by the caller.
+	CHANNELS_NODISCARD static socket_pool* create(bool is_single_threaded);
+
+	socket_pool(const socket_pool&) = delete;
+	socket_pool(socket_pool&&) = delete;
+	socket_pool& operator=(const socket_pool&) = delete;
+	socket_pool& operator=(socket_pool&&) = delete;
+
+	void add_reference() noexcept;
+	void remove_reference() noexcept;
+
+	// Returns a memory block of size `block_size`. The block owns one reference to the pool.
+	// \throw std::bad_alloc If there are no free blocks and the global allocator fails.
+	CHANNELS_NODISCARD void* allocate();
+	// Returns the memory block to the pool and releases its reference to the pool.
+	void deallocate(void* block) noexcept;
+
+private:
+	union block;
+	struct chunk;
+
+	explicit socket_pool(bool is_single_threaded) noexcept;
+	~socket_pool() noexcept;
+
+	CHANNELS_NODISCARD block* take_block();
+
+	std::mutex mutex_;
+	const bool is_single_threaded_;
+	// guarded by the mutex (or owned by the thread of the single-threaded channel)
+	block* free_blocks_{nullptr};
+	// blocks freed by the single-threaded pool, they are moved to the free list by the allocating thread
+	std::atomic<block*> released_blocks_{nullptr};
+	chunk* chunks_{nullptr};
+	std::size_t next_chunk_blocks_number_{4};
+	std::atomic<std::size_t> references_count_{1};
+};
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,137 @@
+#pragma once
+#include "compatibility/compile_features.h"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+namespace detail {
+
+// Slot of `channels::static_channel` that keeps one callback function in its own storage.
+// The slot is shared by the senders and the connection without locks. Its state word contains the flags of the slot
+// and the number of senders that are calling the callback function:
+// - the connection reserves a free slot, constructs the callback function and marks the slot as connected;
+// - a sender counts itself before calling the callback function and checks the flag `connected` it has counted with;
+// - the disconnection marks the slot as retired, and the callback function is destroyed by the disconnection or by the
+//   last sender that leaves the slot, so it isn't destroyed while it is called (even by itself).
+// The slot can be reused when the callback function is destroyed and all senders have left it.
+class static_socket_base {
+public:
+	// callback functions that don't fit into the storage aren't allowed
+	static constexpr std::size_t storage_size = 4 * sizeof(void*);
+
+	constexpr static_socket_base() noexcept = default;
+
+	static_socket_base(const static_socket_base&) = delete;
+	static_socket_base& operator=(const static_socket_base&) = delete;
+
+	// Reserves the free slot for the construction of a callback function.
+	CHANNELS_NODISCARD bool try_reserve() noexcept
+	{
+		std::uint32_t expected = 0;
+		return state_.compare_exchange_strong(expected, owned_flag, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	// Marks the reserved slot as connected. The constructed callback function becomes visible to the senders.
+	void publish() noexcept
+	{
+		state_.fetch_sub(owned_flag - connected_flag, std::memory_order_release);
+	}
+
+	// Returns the reserved slot without a callback function.
+	void cancel() noexcept
+	{
+		state_.fetch_sub(owned_flag, std::memory_order_release);
+	}
+
+	// Counts the sender in the slot if a callback function is connected to it.
+	// The sender must call `leave` if this method returns `true`.
+	CHANNELS_NODISCARD bool try_enter() noexcept
+	{
+		if ((state_.load(std::memory_order_relaxed) & connected_flag) == 0)
+			return false;
+
+		if ((state_.fetch_add(sender_unit, std::memory_order_acquire) & connected_flag) != 0)
+			return true;
+
+		leave();
+		return false;
+	}
+
+	void leave() noexcept
+	{
+		if (state_.fetch_sub(sender_unit, std::memory_order_acq_rel) - sender_unit == retired_flag)
+			try_reclaim();
+	}
+
+	// Disconnects the callback function. It is destroyed now or when the last sender leaves the slot.
+	// \pre The slot is connected.
+	void retire() noexcept;
+
+	// Destroys the connected callback function without synchronization.
+	// \pre There are no senders and connections.
+	void destroy() noexcept;
+
+protected:
+	template<typename Callback>
+	void construct(Callback&& callback)
+	{
+		using callback_type = std::decay_t<Callback>;
+		static_assert(sizeof(callback_type) <= storage_size, "callback function is too large for static_channel");
+		static_assert(
+			alignof(callback_type) <= alignof(std::max_align_t), "callback function is over-aligned for static_channel");
+
+		::new (static_cast<void*>(storage_)) callback_type(std::forward<Callback>(callback));
+		destroy_ = [](void* const callback) noexcept { static_cast<callback_type*>(callback)->~callback_type(); };
+	}
+
+	CHANNELS_NODISCARD void* get_storage() noexcept
+	{
+		return storage_;
+	}
+
+private:
+	static constexpr std::uint32_t connected_flag = 1;
+	static constexpr std::uint32_t retired_flag = 2;
+	static constexpr std::uint32_t owned_flag = 4;
+	static constexpr std::uint32_t sender_unit = 8;
+
+	void try_reclaim() noexcept;
+
+	std::atomic<std::uint32_t> state_{0};
+	void (*destroy_)(void*) = nullptr;
+	alignas(std::max_align_t) unsigned char storage_[storage_size]{}; // NOLINT(cppcoreguidelines-avoid-c-arrays)
+};
+
+// Slot of `channels::static_channel` that calls its callback function with the values of type `Ts...`.
+template<typename... Ts>
+class static_socket : public static_socket_base {
+public:
+	constexpr static_socket() noexcept = default;
+
+	// \pre The slot is reserved by `try_reserve`.
+	template<typename Callback>
+	void construct(Callback&& callback)
+	{
+		using callback_type = std::decay_t<Callback>;
+		static_socket_base::construct(std::forward<Callback>(callback));
+		invoke_ = [](void* const callback, const Ts&... args) { (*static_cast<callback_type*>(callback))(args...); };
+	}
+
+	// \pre The sender is counted in the slot by `try_enter`.
+	void operator()(const Ts&... args)
+	{
+		assert(invoke_); // NOLINT
+		invoke_(get_storage(), args...);
+	}
+
+private:
+	void (*invoke_)(void*, const Ts&...) = nullptr;
+};
+
+} // namespace detail
+} // namespace channels
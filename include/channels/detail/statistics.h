@@ -0,0 +1,113 @@
+#pragma once
+#include "../channel_statistics.h"
+#include "compatibility/compile_features.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace channels {
+namespace detail {
+
+// This class collects the runtime statistics of one channel.
+// Counters are lock-free and updated with relaxed atomic operations, so concurrent senders don't synchronize with each
+// other. If the macro `CHANNELS_STATISTICS` isn't defined, the class is empty and all its methods do nothing, so the
+// compiler removes the statistics code from the send path.
+class statistics {
+public:
+#ifdef CHANNELS_STATISTICS
+	using time_point = std::chrono::steady_clock::time_point;
+#else
+	struct time_point {};
+#endif
+
+	// Counters of one call of `send` or `send_batch`.
+	struct send_counters {
+		std::size_t values_number;
+		std::size_t deliveries_number;
+		std::size_t exceptions_number;
+		std::size_t blocked_skips_number;
+	};
+
+	CHANNELS_NODISCARD static time_point now() noexcept;
+
+	void add_send(time_point start, const send_counters& counters) noexcept;
+	// Must be called only by the writers of sockets (which are serialized).
+	void update_subscribers_number(std::size_t subscribers_number) noexcept;
+	void fill(channel_statistics& result) const noexcept;
+
+#ifdef CHANNELS_STATISTICS
+private:
+	std::atomic<std::uint64_t> sends_number_{0};
+	std::atomic<std::uint64_t> deliveries_number_{0};
+	std::atomic<std::uint64_t> exceptions_number_{0};
+	std::atomic<std::uint64_t> blocked_skips_number_{0};
+	std::atomic<std::size_t> peak_subscribers_number_{0};
+	std::array<std::atomic<std::uint64_t>, channel_statistics::histogram_size> send_durations_histogram_{};
+#endif
+};
+
+// implementation
+
+inline statistics::time_point statistics::now() noexcept
+{
+#ifdef CHANNELS_STATISTICS
+	return std::chrono::steady_clock::now();
+#else
+	return {};
+#endif
+}
+
+inline void statistics::add_send(const time_point start, const send_counters& counters) noexcept
+{
+#ifdef CHANNELS_STATISTICS
+	const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now() - start).count();
+	const auto duration_ns = static_cast<std::uint64_t>(duration > 0 ? duration : 0);
+
+	std::size_t bucket = 0;
+	while (bucket + 1 < send_durations_histogram_.size() &&
+		duration_ns >= channel_statistics::get_histogram_bucket_bound_ns(bucket)) {
+		++bucket;
+	}
+	send_durations_histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+	sends_number_.fetch_add(counters.values_number, std::memory_order_relaxed);
+	deliveries_number_.fetch_add(counters.deliveries_number, std::memory_order_relaxed);
+	if (counters.exceptions_number != 0)
+		exceptions_number_.fetch_add(counters.exceptions_number, std::memory_order_relaxed);
+	if (counters.blocked_skips_number != 0)
+		blocked_skips_number_.fetch_add(counters.blocked_skips_number, std::memory_order_relaxed);
+#else
+	(void) start;
+	(void) counters;
+#endif
+}
+
+inline void statistics::update_subscribers_number(const std::size_t subscribers_number) noexcept
+{
+#ifdef CHANNELS_STATISTICS
+	if (subscribers_number > peak_subscribers_number_.load(std::memory_order_relaxed))
+		peak_subscribers_number_.store(subscribers_number, std::memory_order_relaxed);
+#else
+	(void) subscribers_number;
+#endif
+}
+
+inline void statistics::fill(channel_statistics& result) const noexcept
+{
+#ifdef CHANNELS_STATISTICS
+	result.sends_number = sends_number_.load(std::memory_order_relaxed);
+	result.deliveries_number = deliveries_number_.load(std::memory_order_relaxed);
+	result.exceptions_number = exceptions_number_.load(std::memory_order_relaxed);
+	result.blocked_skips_number = blocked_skips_number_.load(std::memory_order_relaxed);
+	result.peak_subscribers_number = peak_subscribers_number_.load(std::memory_order_relaxed);
+	for (std::size_t i = 0; i < send_durations_histogram_.size(); ++i)
+		result.send_durations_histogram[i] = send_durations_histogram_[i].load(std::memory_order_relaxed); // NOLINT
+#else
+	(void) result;
+#endif
+}
+
+} // namespace detail
+} // namespace channels
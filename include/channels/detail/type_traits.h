@@ -19,5 +19,16 @@ struct is_move_assignable<T, Ts...>
 template<typename... Ts>
 struct is_move_assignable<std::tuple<Ts...>> : is_move_assignable<Ts...> {};
 
+// is_trivially_copyable
+template<typename...>
+struct is_trivially_copyable;
+
+template<>
+struct is_trivially_copyable<> : std::true_type {};
+
+template<typename T, typename... Ts>
+struct is_trivially_copyable<T, Ts...>
+	: std::integral_constant<bool, std::is_trivially_copyable<T>::value && is_trivially_copyable<Ts...>::value> {};
+
 } // namespace detail
 } // namespace channels
@@ -0,0 +1,30 @@
+#pragma once
+#include "compatibility/compile_features.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace channels {
+namespace detail {
+
+// Wakes one waiting thread when any of the producers has an event.
+// The waiter calls `prepare_wait`, checks the events and then calls `wait` with the returned sequence number, so an
+// event that happens after the check interrupts the wait. The producers make system calls only between `prepare_wait`
+// and `finish_wait`.
+class wake_signal {
+public:
+	// Called by the producers after they have published an event.
+	void notify() noexcept;
+
+	CHANNELS_NODISCARD std::uint32_t prepare_wait() noexcept;
+	// \return `false` if the `deadline` is reached.
+	bool wait(std::uint32_t sequence, const std::chrono::steady_clock::time_point* deadline) noexcept;
+	void finish_wait() noexcept;
+
+private:
+	std::atomic<std::uint32_t> sequence_{0};
+	std::atomic<bool> is_waiting_{false};
+};
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,61 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+namespace policy {
+
+/// The channel calls all callback functions and then throws `channels::callbacks_exception` with the exceptions they
+/// threw. It is the default error policy.
+struct collect_exceptions {};
+
+/// The callback functions must be `noexcept`: the channel checks it when they are connected, and the sending doesn't
+/// catch exceptions, so the dispatch loop has no exception handling code.
+/// \warning The dispatch loop is `noexcept`, so `std::terminate` is called if anything throws in it. Besides the
+///          `execute` function of an executor, it happens when memory can't be allocated or a mutex can't be locked
+///          for the connections that store the values: the connections with an executor copy the values to a shared
+///          allocation, the mailbox connections (`connect_mailbox`) push them to a queue and the conflated connections
+///          (`connect_conflated`) keep the latest value under a lock. Only the immediate callback functions are safe.
+struct nothrow {};
+
+/// The channel stops sending at the first exception and throws `channels::callbacks_exception` with it. The remaining
+/// callback functions aren't called.
+struct fail_fast {};
+
+} // namespace policy
+
+/// Traits class selecting the error policy of the channel type (`channels::channel`, `channels::buffered_channel` or
+/// `channels::keyed_channel`). Specialize it to change the policy:
+/// \code
+/// using tick_channel = channels::channel<tick>;
+///
+/// namespace channels {
+/// template<>
+/// struct error_policy_traits<tick_channel> {
+/// 	using type = policy::nothrow;
+/// };
+/// } // namespace channels
+/// \endcode
+/// \note The specialization must be declared before the channel type is used.
+template<typename Channel>
+struct error_policy_traits {
+	using type = policy::collect_exceptions;
+};
+
+template<typename Channel>
+using error_policy_t = typename error_policy_traits<Channel>::type;
+
+namespace detail {
+
+// Checks that the callback function can be connected to the channel with the error policy.
+template<typename Policy, typename Callback, typename... Ts>
+struct is_allowed_callback : std::true_type {};
+
+template<typename Callback, typename... Ts>
+struct is_allowed_callback<policy::nothrow, Callback, Ts...> : std::integral_constant<
+	bool,
+	noexcept(std::declval<std::decay_t<Callback>&>()(std::declval<const Ts&>()...))>
+{};
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,184 @@
+#pragma once
+#include "detail/compatibility/compile_features.h"
+#include "detail/future_shared_state.h"
+#include <chrono>
+#include <future>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+
+/// The class `embedded_promise` can be passed to `aggregating_channel::send` instead of `std::promise`.
+/// It doesn't allocate its own shared state: the aggregator is kept in the shared state of the sending and is passed to
+/// the sender through `channels::future`, so one sending requires one allocation.
+/// \tparam T Type of the aggregator.
+template<typename T>
+struct embedded_promise {};
+
+/// The class `future` provides access to the aggregator of `aggregating_channel::send` (like `std::future`).
+/// The future refers to the shared state of the sending, so it doesn't allocate memory.
+/// \tparam T Type of the aggregator.
+template<typename T>
+class future {
+public:
+	/// Constructs a `future` object without shared state.
+	/// \post `is_valid() == false`.
+	future() = default;
+
+	future(const future&) = delete;
+	future(future&& other) noexcept;
+	future& operator=(const future&) = delete;
+	future& operator=(future&& other) noexcept;
+
+	~future();
+
+	/// Checks if the future has shared state.
+	CHANNELS_NODISCARD bool is_valid() const noexcept;
+
+	/// Checks if the result is ready (all callback functions are completed or the aggregator has stopped the sending).
+	/// \throw std::future_error if `is_valid() == false`.
+	CHANNELS_NODISCARD bool is_ready() const;
+
+	/// Blocks until the result becomes ready.
+	/// \throw std::future_error if `is_valid() == false`.
+	void wait() const;
+
+	/// Blocks until the result becomes ready or the `timeout_duration` has elapsed.
+	/// \return `true` if the result is ready.
+	/// \throw std::future_error if `is_valid() == false`.
+	template<typename Rep, typename Period>
+	CHANNELS_NODISCARD bool wait_for(const std::chrono::duration<Rep, Period>& timeout_duration) const;
+
+	/// Waits until the result is ready and returns it.
+	/// \return The aggregator.
+	/// \throw std::future_error if `is_valid() == false`.
+	/// \throw The exception thrown by the aggregator.
+	/// \post `is_valid() == false`.
+	CHANNELS_NODISCARD T get();
+
+	/// Attaches the `continuation` that is called with this future when the result becomes ready.
+	/// The continuation is called in the thread that makes the result ready (in the thread of the last completed
+	/// callback function), or immediately in this thread if the result is ready already.
+	/// \param continuation Move constructible function object that is invocable with `channels::future<T>&&`.
+	///                     The call must be `noexcept`: the result usually becomes ready when the last callback
+	///                     function completes and releases the sending, where there is nobody to pass an exception to.
+	///                     A continuation that calls `get` must catch the exceptions of the aggregator itself.
+	/// \throw std::future_error if `is_valid() == false`.
+	/// \post `is_valid() == false`.
+	template<typename Continuation>
+	void then(Continuation&& continuation);
+
+public: // library private interface
+	explicit future(detail::future_shared_state_interface<T>& shared_state) noexcept;
+
+private:
+	struct adopt_reference_tag {};
+
+	future(detail::future_shared_state_interface<T>* shared_state, adopt_reference_tag) noexcept;
+
+	detail::future_shared_state_interface<T>& get_shared_state() const;
+
+	detail::future_shared_state_interface<T>* shared_state_{nullptr};
+};
+
+// implementation
+
+template<typename T>
+future<T>::future(detail::future_shared_state_interface<T>& shared_state) noexcept
+	: shared_state_{&shared_state}
+{
+	shared_state_->add_reference();
+}
+
+template<typename T>
+future<T>::future(detail::future_shared_state_interface<T>* const shared_state, adopt_reference_tag) noexcept
+	: shared_state_{shared_state}
+{}
+
+template<typename T>
+future<T>::future(future&& other) noexcept
+	: shared_state_{std::exchange(other.shared_state_, nullptr)}
+{}
+
+template<typename T>
+future<T>& future<T>::operator=(future&& other) noexcept
+{
+	if (this != &other) {
+		if (shared_state_)
+			shared_state_->remove_reference();
+		shared_state_ = std::exchange(other.shared_state_, nullptr);
+	}
+	return *this;
+}
+
+template<typename T>
+future<T>::~future()
+{
+	if (shared_state_)
+		shared_state_->remove_reference();
+}
+
+template<typename T>
+bool future<T>::is_valid() const noexcept
+{
+	return shared_state_ != nullptr;
+}
+
+template<typename T>
+bool future<T>::is_ready() const
+{
+	return get_shared_state().is_ready();
+}
+
+template<typename T>
+void future<T>::wait() const
+{
+	get_shared_state().wait();
+}
+
+template<typename T>
+template<typename Rep, typename Period>
+bool future<T>::wait_for(const std::chrono::duration<Rep, Period>& timeout_duration) const
+{
+	return get_shared_state().wait_for(timeout_duration);
+}
+
+template<typename T>
+T future<T>::get()
+{
+	detail::future_shared_state_interface<T>& shared_state = get_shared_state();
+
+	// the reference is released after taking the value
+	const future self{std::move(*this)};
+	return shared_state.take_value();
+}
+
+template<typename T>
+template<typename Continuation>
+void future<T>::then(Continuation&& continuation)
+{
+	static_assert(
+		noexcept(std::declval<std::decay_t<Continuation>&>()(std::declval<future>())),
+		"Continuation must be noexcept invocable with channels::future<T>&&");
+
+	detail::future_shared_state_interface<T>& shared_state = get_shared_state();
+
+	// the callback adopts the reference of this future when it is called
+	shared_state.set_continuation(
+		[shared_state = &shared_state,
+			continuation = std::decay_t<Continuation>{std::forward<Continuation>(continuation)}]() mutable noexcept {
+			continuation(future{shared_state, adopt_reference_tag{}});
+		});
+	// the callback is stored or called already, so it owns the reference
+	shared_state_ = nullptr;
+}
+
+template<typename T>
+detail::future_shared_state_interface<T>& future<T>::get_shared_state() const
+{
+	if (!shared_state_)
+		throw std::future_error{std::future_errc::no_state};
+	return *shared_state_;
+}
+
+} // namespace channels
@@ -1,8 +1,12 @@
 #pragma once
+#include <cstddef>
 
 namespace channels {
 
 class connection;
+class mailbox_connection;
+class static_connection;
+struct priority;
 
 // channels
 
@@ -15,11 +19,42 @@ class buffered_channel;
 template<typename F>
 class aggregating_channel;
 
+template<typename... Ts>
+class queue_channel;
+
+template<typename T, std::size_t Capacity>
+class ring_channel;
+
+template<typename Key, typename... Ts>
+class keyed_channel;
+
+template<typename T>
+class shm_buffered_channel;
+
+template<std::size_t N, typename... Ts>
+class static_channel;
+
+// futures
+
+template<typename T>
+class future;
+
+template<typename T>
+struct embedded_promise;
+
+// selectors
+
+class selector;
+
 // transmitters
 
 template<typename Channel>
 class transmitter;
 
+// statistics
+
+struct channel_statistics;
+
 // exceptions
 
 class callbacks_exception;
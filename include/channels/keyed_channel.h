@@ -0,0 +1,410 @@
+#pragma once
+#include "connection.h"
+#include "detail/compatibility/compile_features.h"
+#include "detail/shared_state.h"
+#include "error.h"
+#include "error_policy.h"
+#include "threading_policy.h"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+
+/// The class `keyed_channel` is similar to `channels::channel` but each value is sent with a key and the callback
+/// functions are connected to one key or to all keys. It replaces many channels (one per topic, like a channel per
+/// instrument) with one shared state, and unlike filtering inside the callback functions the cost of sending doesn't
+/// depend on the number of subscribers of other keys.
+/// The keys are found by an open-addressing hash table, so sending to a key costs one lookup without locks and the
+/// calls of the callback functions connected to this key (and of the ones connected to all keys). Each key takes only
+/// an entry of the hash table and a pointer to its list of callback functions.
+/// \note The key stays in the hash table when the last callback function of this key is disconnected, so the memory
+///       used by the channel is proportional to the number of keys that have ever had subscribers.
+///
+/// Example:
+/// \code
+/// channels::transmitter<channels::keyed_channel<instrument_id, order>> transmitter;
+/// const channels::connection connection =
+/// 	transmitter.get_channel().connect(instrument_id{42}, [](const order& o) { .... });
+/// const channels::connection log_connection = transmitter.get_channel().connect_all([](const order& o) { .... });
+///
+/// transmitter.send(instrument_id{42}, order{....}); // calls both callback functions
+/// transmitter.send(instrument_id{7}, order{....}); // calls only the second one
+/// \endcode
+///
+/// \tparam Key Type of the keys. It must be copyable, default constructible, equality comparable and hashable by
+///             `std::hash<Key>`.
+/// \tparam Ts Types of parameters passed to callback functions.
+template<typename Key, typename... Ts>
+class keyed_channel {
+	template<typename K, typename... Us>
+	friend bool operator==(const keyed_channel<K, Us...>& lhs, const keyed_channel<K, Us...>& rhs) noexcept; // NOLINT
+	template<typename K, typename... Us>
+	friend bool operator!=(const keyed_channel<K, Us...>& lhs, const keyed_channel<K, Us...>& rhs) noexcept; // NOLINT
+
+	class shared_state;
+	using error_policy = error_policy_t<keyed_channel>;
+	using threading_policy = threading_policy_t<keyed_channel>;
+
+public:
+	using key_type = Key;
+
+	/// Constructs a `keyed_channel` object with no shared state.
+	/// \post `is_valid() == false`.
+	keyed_channel() = default;
+
+	/// Checks if the `keyed_channel` refers to a shared state.
+	CHANNELS_NODISCARD bool is_valid() const noexcept;
+
+	/// Adds callback function to be called when `channels::transmitter` sends values with the `key`.
+	/// \note This method is thread safe.
+	/// \see channels::channel::connect
+	/// \throw channel_error If `is_valid() == false`.
+	template<typename Callback>
+	CHANNELS_NODISCARD connection connect(const Key& key, Callback&& callback) const;
+
+	/// Same as previous method `connect` but the callback function is called by the executor.
+	/// \see channels::channel::connect
+	/// \throw channel_error If `is_valid() == false`.
+	template<typename Executor, typename Callback>
+	CHANNELS_NODISCARD connection connect(const Key& key, Executor&& executor, Callback&& callback) const;
+
+	/// Adds callback function to be called when `channels::transmitter` sends values with any key.
+	/// The callback functions connected to all keys are called after the callback functions of the key.
+	/// \see channels::channel::connect
+	/// \throw channel_error If `is_valid() == false`.
+	template<typename Callback>
+	CHANNELS_NODISCARD connection connect_all(Callback&& callback) const;
+
+	/// Same as previous method `connect_all` but the callback function is called by the executor.
+	/// \see channels::channel::connect
+	/// \throw channel_error If `is_valid() == false`.
+	template<typename Executor, typename Callback>
+	CHANNELS_NODISCARD connection connect_all(Executor&& executor, Callback&& callback) const;
+
+	/// Returns the number of keys in the hash table.
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD std::size_t get_keys_number() const;
+
+protected:
+	struct make_shared_state_tag {};
+
+	/// Constructs a `keyed_channel` object with shared state.
+	/// \post `is_valid() == true`.
+	explicit keyed_channel(make_shared_state_tag);
+
+	/// Calls the callback functions connected to the `key` and to all keys and passes arguments to them.
+	/// \note This method is thread safe.
+	/// \throw callbacks_exception If one or more either callback function or `execute` function threw exceptions.
+	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
+	void send(const Key& key, Ts... args);
+
+private:
+	// Connects the callback function to the `key` or to all keys if the `key` is null.
+	template<typename... Args>
+	CHANNELS_NODISCARD connection connect_impl(const Key* key, Args&&... args) const;
+
+	void check_validity() const;
+
+	std::shared_ptr<shared_state> shared_state_;
+};
+
+// implementation
+
+template<typename Channel>
+struct channel_traits;
+
+template<typename Key, typename... Ts>
+struct channel_traits<keyed_channel<Key, Ts...>> {
+	static constexpr bool is_channel = true;
+};
+
+// Keeps the callback functions of all keys in lists published by `detail::shared_state_base`: the main list holds the
+// callback functions connected to all keys and each key has its own list.
+// The key index maps the keys to their lists. The lists are kept in a deque, so their addresses don't change when the
+// index grows. The senders look up the key in the index without locks (pinned in the epoch domain of the shared state
+// like for the lists), and the connecting threads are serialized by the mutex of the index.
+template<typename Key, typename... Ts>
+class keyed_channel<Key, Ts...>::shared_state : public detail::shared_state<Ts...> {
+	using base_type = detail::shared_state<Ts...>;
+
+public:
+	using typename base_type::invocable_socket;
+	using typename base_type::invocable_sockets_shared_view;
+
+	explicit shared_state(const bool is_single_threaded)
+		: base_type{is_single_threaded}
+		, index_{std::make_unique<key_index>(min_entries_number).release()}
+	{}
+
+	shared_state(const shared_state&) = delete;
+	shared_state(shared_state&&) = delete;
+	shared_state& operator=(const shared_state&) = delete;
+	shared_state& operator=(shared_state&&) = delete;
+
+	~shared_state() noexcept
+	{
+		// the retired indexes are deleted by the base class
+		delete index_.load(std::memory_order_relaxed); // NOLINT(cppcoreguidelines-owning-memory)
+		for (detail::sockets_slot& sockets : key_sockets_)
+			this->clear(sockets);
+	}
+
+	template<typename... Args>
+	invocable_socket& connect_key(const Key& key, Args&&... args)
+	{
+		detail::socket_pointer<invocable_socket> socket_ptr = this->make_invocable_socket(std::forward<Args>(args)...);
+		invocable_socket& socket = *socket_ptr;
+
+		detail::sockets_slot* sockets = nullptr;
+		{
+			detail::retired_list reclaimed; // deleted after the mutex is unlocked because it can destroy callbacks
+			const std::lock_guard<index_mutex_type> lock{index_mutex_};
+			sockets = &find_or_insert(key, reclaimed);
+		}
+		this->add(*sockets, std::move(socket_ptr), 0);
+		return socket;
+	}
+
+	invocable_sockets_shared_view get_key_sockets(const Key& key)
+	{
+		return invocable_sockets_shared_view{
+			this->find_sockets([this, &key] { return index_.load(std::memory_order_acquire)->find(key); })};
+	}
+
+	CHANNELS_NODISCARD std::size_t get_keys_number() const
+	{
+		const std::lock_guard<index_mutex_type> lock{index_mutex_};
+		return key_sockets_.size();
+	}
+
+private:
+	using index_mutex_type = detail::policy_mutex_t<threading_policy, std::mutex>;
+
+	static constexpr std::size_t min_entries_number = 16;
+
+	// Open-addressing hash table that maps the keys to their lists.
+	// An entry is written once (its key before its list) and never changes after that, so the senders read the index
+	// while a connecting thread inserts a key. When the index grows, a bigger copy is published and the old one is
+	// retired until no sender reads it.
+	class key_index : public detail::retired_node {
+	public:
+		explicit key_index(const std::size_t entries_number)
+			: retired_node{&key_index::reclaim}
+			, mask_{entries_number - 1}
+			, entries_{std::make_unique<entry[]>(entries_number)} // NOLINT(cppcoreguidelines-avoid-c-arrays)
+		{}
+
+		CHANNELS_NODISCARD std::size_t get_entries_number() const noexcept
+		{
+			return mask_ + 1;
+		}
+
+		// Returns the list of the `key` or null if the key isn't in the index.
+		CHANNELS_NODISCARD detail::sockets_slot* find(const Key& key) const
+		{
+			return entries_[find_position(key)].sockets.load(std::memory_order_acquire);
+		}
+
+		// Inserts the `key` that isn't in the index. It is called only by the connecting threads.
+		void insert(const Key& key, detail::sockets_slot& sockets)
+		{
+			entry& free_entry = entries_[find_position(key)];
+			assert(!free_entry.sockets.load(std::memory_order_relaxed)); // NOLINT
+			free_entry.key = key;
+			free_entry.sockets.store(&sockets, std::memory_order_release);
+		}
+
+		// Inserts all keys of the `other` index.
+		void insert_all(const key_index& other)
+		{
+			for (std::size_t position = 0; position <= other.mask_; ++position) {
+				const entry& other_entry = other.entries_[position];
+				detail::sockets_slot* const sockets = other_entry.sockets.load(std::memory_order_relaxed);
+				if (sockets)
+					insert(other_entry.key, *sockets);
+			}
+		}
+
+	private:
+		struct entry {
+			Key key;
+			std::atomic<detail::sockets_slot*> sockets{nullptr};
+		};
+
+		static void reclaim(retired_node& node) noexcept
+		{
+			delete static_cast<key_index*>(&node); // NOLINT(cppcoreguidelines-owning-memory)
+		}
+
+		// std::hash is the identity for integers on the common implementations, so its bits are mixed to spread the
+		// sequential keys over the table (the finalizer of MurmurHash3)
+		static std::size_t hash(const Key& key)
+		{
+			auto value = static_cast<std::uint64_t>(std::hash<Key>{}(key));
+			value ^= value >> 33u;
+			value *= 0xff51afd7ed558ccdull;
+			value ^= value >> 33u;
+			return static_cast<std::size_t>(value);
+		}
+
+		// Returns the position of the `key` or of the empty entry where it must be inserted.
+		std::size_t find_position(const Key& key) const
+		{
+			std::size_t position = hash(key) & mask_;
+			while (entries_[position].sockets.load(std::memory_order_acquire) && !(entries_[position].key == key))
+				position = (position + 1) & mask_;
+			return position;
+		}
+
+		const std::size_t mask_;
+		const std::unique_ptr<entry[]> entries_; // NOLINT(cppcoreguidelines-avoid-c-arrays)
+	};
+
+	// \param reclaimed The objects reclaimed by publishing a new index are moved to it.
+	detail::sockets_slot& find_or_insert(const Key& key, detail::retired_list& reclaimed)
+	{
+		key_index* index = index_.load(std::memory_order_relaxed);
+		detail::sockets_slot* const sockets = index->find(key);
+		if (sockets)
+			return *sockets;
+
+		// the load factor is kept not greater than 1/2, so the probe sequences are short
+		if ((key_sockets_.size() + 1) * 2 > index->get_entries_number()) {
+			auto new_index = std::make_unique<key_index>(index->get_entries_number() * 2);
+			new_index->insert_all(*index);
+			index = new_index.get();
+			reclaimed = this->publish(index_, std::move(new_index));
+		}
+
+		key_sockets_.emplace_back(nullptr);
+		try {
+			index->insert(key, key_sockets_.back());
+		}
+		catch (...) {
+			key_sockets_.pop_back();
+			throw;
+		}
+		return key_sockets_.back();
+	}
+
+	// guards the insertions to the index and the list of keys
+	mutable index_mutex_type index_mutex_;
+	std::atomic<key_index*> index_;
+	std::deque<detail::sockets_slot> key_sockets_;
+};
+
+template<typename Key, typename... Ts>
+constexpr std::size_t keyed_channel<Key, Ts...>::shared_state::min_entries_number;
+
+// keyed_channel
+
+template<typename Key, typename... Ts>
+bool keyed_channel<Key, Ts...>::is_valid() const noexcept
+{
+	return static_cast<bool>(shared_state_);
+}
+
+template<typename Key, typename... Ts>
+template<typename Callback>
+connection keyed_channel<Key, Ts...>::connect(const Key& key, Callback&& callback) const
+{
+	return connect_impl(&key, std::forward<Callback>(callback));
+}
+
+template<typename Key, typename... Ts>
+template<typename Executor, typename Callback>
+connection keyed_channel<Key, Ts...>::connect(const Key& key, Executor&& executor, Callback&& callback) const
+{
+	return connect_impl(&key, std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename Key, typename... Ts>
+template<typename Callback>
+connection keyed_channel<Key, Ts...>::connect_all(Callback&& callback) const
+{
+	return connect_impl(nullptr, std::forward<Callback>(callback));
+}
+
+template<typename Key, typename... Ts>
+template<typename Executor, typename Callback>
+connection keyed_channel<Key, Ts...>::connect_all(Executor&& executor, Callback&& callback) const
+{
+	return connect_impl(nullptr, std::forward<Executor>(executor), std::forward<Callback>(callback));
+}
+
+template<typename Key, typename... Ts>
+std::size_t keyed_channel<Key, Ts...>::get_keys_number() const
+{
+	check_validity();
+	return shared_state_->get_keys_number();
+}
+
+template<typename Key, typename... Ts>
+keyed_channel<Key, Ts...>::keyed_channel(make_shared_state_tag)
+	: shared_state_{std::make_shared<shared_state>(detail::is_single_threaded<threading_policy>::value)}
+{}
+
+template<typename Key, typename... Ts>
+void keyed_channel<Key, Ts...>::send(const Key& key, Ts... args)
+{
+	assert(shared_state_); // NOLINT
+
+	const detail::statistics::time_point start = detail::statistics::now();
+	detail::statistics::send_counters counters{1, 0, 0, 0};
+	callbacks_exception::exceptions_type exceptions;
+	std::tuple<Ts...> arguments{std::forward<Ts>(args)...};
+	typename shared_state::value_reference value{arguments};
+	if (shared_state_->deliver(error_policy{}, shared_state_->get_key_sockets(key), value, counters, exceptions))
+		shared_state_->deliver(error_policy{}, shared_state_->get_sockets(), value, counters, exceptions);
+	// both lists are passed in one sending
+	shared_state_->get_statistics().add_send(start, counters);
+
+	if (!exceptions.empty())
+		throw callbacks_exception{std::move(exceptions)};
+}
+
+template<typename Key, typename... Ts>
+template<typename... Args>
+connection keyed_channel<Key, Ts...>::connect_impl(const Key* const key, Args&&... args) const
+{
+	using callback_type = std::tuple_element_t<sizeof...(Args) - 1, std::tuple<Args...>>;
+	static_assert(
+		detail::is_allowed_callback<error_policy, callback_type, Ts...>::value,
+		"Callback must be noexcept for keyed_channel with policy::nothrow");
+
+	check_validity();
+	auto& socket = key
+		? shared_state_->connect_key(*key, std::forward<Args>(args)...)
+		: shared_state_->connect(0, std::forward<Args>(args)...);
+	return connection{*shared_state_, socket};
+}
+
+template<typename Key, typename... Ts>
+void keyed_channel<Key, Ts...>::check_validity() const
+{
+	if (!is_valid())
+		throw channel_error{"keyed_channel: has no state"};
+}
+
+template<typename K, typename... Us>
+bool operator==(const keyed_channel<K, Us...>& lhs, const keyed_channel<K, Us...>& rhs) noexcept
+{
+	return lhs.shared_state_ == rhs.shared_state_;
+}
+
+template<typename K, typename... Us>
+bool operator!=(const keyed_channel<K, Us...>& lhs, const keyed_channel<K, Us...>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+} // namespace channels
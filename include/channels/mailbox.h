@@ -0,0 +1,71 @@
+#pragma once
+#include "connection.h"
+#include "detail/compatibility/compile_features.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace channels {
+
+namespace detail {
+
+class mailbox_counters;
+
+} // namespace detail
+
+/// Defines what a mailbox does with a new value when it is full.
+/// \see channels::mailbox_options
+enum class overflow_policy {
+	/// The oldest pending value is dropped.
+	drop_oldest,
+	/// The new value is dropped.
+	drop_newest,
+	/// The sender waits until the callback function takes a value from the mailbox.
+	/// \warning The sender deadlocks if the callback function is executed in the thread of the sender.
+	/// \note While the sender waits, the callback functions disconnected from the channel aren't destroyed.
+	block_sender,
+	/// All pending values are dropped, so the callback function gets only the latest one.
+	conflate,
+};
+
+/// The structure `mailbox_options` describes the mailbox of one callback function.
+/// A mailbox is a lock-free bounded queue between the senders and the callback function connected with an executor.
+/// The mailbox schedules at most one task to the executor at a time, and this task calls the callback function with
+/// all pending values. So the memory used by a slow subscriber and the load of its executor are bounded.
+/// \see channels::channel::connect_mailbox
+struct mailbox_options {
+	/// Maximum number of pending values. It is rounded up to a power of two (at least 2).
+	std::size_t capacity = 64;
+	/// Behavior of the mailbox when it is full.
+	overflow_policy policy = overflow_policy::drop_oldest;
+};
+
+/// The structure `mailbox_statistics` is a snapshot of the counters of a mailbox.
+struct mailbox_statistics {
+	/// Number of values that are waiting for the callback function.
+	std::size_t depth = 0;
+	/// Number of values dropped by the overflow policy.
+	std::uint64_t dropped_number = 0;
+};
+
+/// A handler of the mailbox connection.
+/// In addition to `channels::connection` it provides the counters of the mailbox.
+class CHANNELS_NODISCARD mailbox_connection : public connection {
+public:
+	/// Constructs a disconnected `mailbox_connection` object.
+	/// \post `is_connected() == false`.
+	mailbox_connection() = default;
+
+	/// Returns the snapshot of the counters of the mailbox.
+	/// \note The counters are available even after the connection is disconnected.
+	/// \note This method is thread safe.
+	CHANNELS_NODISCARD mailbox_statistics get_mailbox_statistics() const noexcept;
+
+public: // library private interface
+	mailbox_connection(connection base, std::shared_ptr<const detail::mailbox_counters> counters) noexcept;
+
+private:
+	std::shared_ptr<const detail::mailbox_counters> counters_;
+};
+
+} // namespace channels
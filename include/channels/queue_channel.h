@@ -0,0 +1,324 @@
+#pragma once
+#include "detail/atomic_wait.h"
+#include "detail/bounded_queue.h"
+#include "detail/compatibility/compile_features.h"
+#include "detail/select_source.h"
+#include "error.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+
+/// The class `queue_channel` is a channel from which the consumers take the values themselves instead of connecting
+/// callback functions (like a pipe).
+/// The values sent to the transmitter are kept in a bounded lock-free queue. Any number of consumers can take them with
+/// methods `try_receive`, `receive`, `receive_for` and `receive_batch`, and each value is received by only one consumer.
+/// A consumer blocked in `receive` sleeps until a value is sent, so it doesn't need an executor.
+/// \note Like `channels::channel` all copies of the `queue_channel` object share one queue with the transmitter.
+///
+/// Example:
+/// \code
+/// channels::transmitter<channels::queue_channel<int>> transmitter{1024u}; // capacity of the queue
+/// const channels::queue_channel<int> channel = transmitter.get_channel();
+///
+/// std::thread consumer{[channel] {
+/// 	std::vector<std::tuple<int>> values;
+/// 	for (;;) {
+/// 		values.clear();
+/// 		channel.receive_batch(std::back_inserter(values), 64);
+/// 		....
+/// 	}
+/// }};
+///
+/// if (!transmitter.send(42))
+/// 	.... // the queue is full
+/// \endcode
+///
+/// \tparam Ts Types of the values. The values are moved through the queue, so the types must be nothrow movable.
+template<typename... Ts>
+class queue_channel {
+	template<typename... Us>
+	friend bool operator==(const queue_channel<Us...>& lhs, const queue_channel<Us...>& rhs) noexcept; // NOLINT
+	template<typename... Us>
+	friend bool operator!=(const queue_channel<Us...>& lhs, const queue_channel<Us...>& rhs) noexcept; // NOLINT
+
+	class shared_state;
+
+public:
+	using value_type = std::tuple<Ts...>;
+
+	/// Capacity of the queue if it isn't passed to the constructor of the transmitter.
+	static constexpr std::size_t default_capacity = 64;
+
+	/// Constructs a `queue_channel` object with no shared state.
+	/// \post `is_valid() == false`.
+	queue_channel() = default;
+
+	/// Checks if the `queue_channel` refers to a shared state.
+	CHANNELS_NODISCARD bool is_valid() const noexcept;
+
+	/// Returns the maximum number of values in the queue.
+	/// \note The capacity passed to the transmitter is rounded up to a power of two (at least 2).
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD std::size_t get_capacity() const;
+
+	/// Takes the oldest value from the queue if it isn't empty. This method doesn't block.
+	/// \note This method is thread safe.
+	/// \return `false` if the queue is empty (the `value` isn't changed in this case).
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD bool try_receive(value_type& value) const;
+
+	/// Takes the oldest value from the queue. If the queue is empty, it waits until a value is sent.
+	/// \note This method is thread safe.
+	/// \throw channel_error If `is_valid() == false`.
+	void receive(value_type& value) const;
+
+	/// Same as method `receive` but it waits not longer than `timeout`.
+	/// \return `false` if no value was sent during the `timeout` (the `value` isn't changed in this case).
+	/// \throw channel_error If `is_valid() == false`.
+	template<typename Rep, typename Period>
+	CHANNELS_NODISCARD bool receive_for(value_type& value, const std::chrono::duration<Rep, Period>& timeout) const;
+
+	/// Takes up to `max_number` oldest values from the queue and writes them to the `out`. If the queue is empty, it
+	/// waits until a value is sent.
+	/// \note This method is thread safe. Values received by one call can be interleaved with values received by other
+	///       consumers at the same time.
+	/// \return The number of values written to the `out`. It isn't zero if `max_number` isn't zero.
+	/// \throw channel_error If `is_valid() == false`.
+	template<typename OutputIterator>
+	std::size_t receive_batch(OutputIterator out, std::size_t max_number) const;
+
+public: // library private interface
+	// \see channels::selector
+	CHANNELS_NODISCARD std::shared_ptr<detail::select_source> get_select_source() const;
+
+protected:
+	struct make_shared_state_tag {};
+
+	/// Constructs a `queue_channel` object with shared state.
+	/// \param capacity Maximum number of values in the queue.
+	/// \post `is_valid() == true`.
+	explicit queue_channel(make_shared_state_tag, std::size_t capacity = default_capacity);
+
+	/// Puts the value to the queue and wakes the waiting consumers. This method doesn't block.
+	/// \note This method is thread safe.
+	/// \return `false` if the queue is full (the value is dropped in this case).
+	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
+	bool send(Ts... args);
+
+	/// Puts the elements of the range to the queue in order and wakes the waiting consumers once.
+	/// \note This method is thread safe.
+	/// \param values Range of values to send. Each element must be convertible to `std::tuple<Ts...>`.
+	/// \return The number of elements put to the queue. If the queue becomes full, the rest of the range is dropped.
+	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
+	template<typename Range>
+	std::size_t send_batch(Range&& values);
+
+private:
+	shared_state& check_validity() const;
+	// \param deadline The consumer waits without a limit if it is null.
+	static bool wait_value(
+		shared_state& state, value_type& value, const std::chrono::steady_clock::time_point* deadline);
+
+	std::shared_ptr<shared_state> shared_state_;
+};
+
+// implementation
+
+template<typename Channel>
+struct channel_traits;
+
+template<typename... Ts>
+struct channel_traits<queue_channel<Ts...>> {
+	static constexpr bool is_channel = true;
+};
+
+template<typename... Ts>
+class queue_channel<Ts...>::shared_state final : public detail::select_source {
+public:
+	explicit shared_state(const std::size_t capacity)
+		: queue{capacity}
+	{}
+
+	// Wakes the consumers waiting in `wait_value` and the selectors.
+	void notify() noexcept
+	{
+		// a consumer that has counted itself before this increment sees the new value and doesn't sleep, otherwise it
+		// is counted here and gets woken up
+		sequence.fetch_add(1, std::memory_order_seq_cst);
+		if (waiters_number.load(std::memory_order_seq_cst) != 0)
+			detail::atomic_notify_all(sequence);
+		notify_selectors();
+	}
+
+	bool is_ready(std::uint64_t& version) const noexcept override
+	{
+		// the event is the non-empty queue, so the version isn't used; reading the sequence orders the check of the
+		// queue after the registration of the selector (see `select_source`)
+		(void) version;
+		(void) sequence.load(std::memory_order_seq_cst);
+		return !queue.is_empty();
+	}
+
+	detail::bounded_queue<value_type> queue;
+	// it is changed after each sending, the consumers sleep on it
+	std::atomic<std::uint32_t> sequence{0};
+	std::atomic<std::uint32_t> waiters_number{0};
+};
+
+template<typename... Ts>
+constexpr std::size_t queue_channel<Ts...>::default_capacity;
+
+template<typename... Ts>
+bool queue_channel<Ts...>::is_valid() const noexcept
+{
+	return static_cast<bool>(shared_state_);
+}
+
+template<typename... Ts>
+std::size_t queue_channel<Ts...>::get_capacity() const
+{
+	return check_validity().queue.get_capacity();
+}
+
+template<typename... Ts>
+bool queue_channel<Ts...>::try_receive(value_type& value) const
+{
+	return check_validity().queue.try_pop(value);
+}
+
+template<typename... Ts>
+void queue_channel<Ts...>::receive(value_type& value) const
+{
+	const bool received = wait_value(check_validity(), value, nullptr);
+	assert(received); // NOLINT
+	(void) received;
+}
+
+template<typename... Ts>
+template<typename Rep, typename Period>
+bool queue_channel<Ts...>::receive_for(value_type& value, const std::chrono::duration<Rep, Period>& timeout) const
+{
+	shared_state& state = check_validity();
+	const std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+	return wait_value(state, value, &deadline);
+}
+
+template<typename... Ts>
+template<typename OutputIterator>
+std::size_t queue_channel<Ts...>::receive_batch(OutputIterator out, const std::size_t max_number) const
+{
+	shared_state& state = check_validity();
+	if (max_number == 0)
+		return 0;
+
+	value_type value;
+	const bool received = wait_value(state, value, nullptr);
+	assert(received); // NOLINT
+	(void) received;
+
+	std::size_t number = 0;
+	do {
+		*out = std::move(value);
+		++out;
+		++number;
+	} while (number < max_number && state.queue.try_pop(value));
+
+	return number;
+}
+
+template<typename... Ts>
+std::shared_ptr<detail::select_source> queue_channel<Ts...>::get_select_source() const
+{
+	check_validity();
+	return shared_state_;
+}
+
+template<typename... Ts>
+queue_channel<Ts...>::queue_channel(make_shared_state_tag, const std::size_t capacity)
+	: shared_state_{std::make_shared<shared_state>(capacity)}
+{}
+
+template<typename... Ts>
+bool queue_channel<Ts...>::send(Ts... args)
+{
+	assert(shared_state_); // NOLINT
+
+	value_type value{std::move(args)...};
+	if (!shared_state_->queue.try_push(value))
+		return false;
+
+	shared_state_->notify();
+	return true;
+}
+
+template<typename... Ts>
+template<typename Range>
+std::size_t queue_channel<Ts...>::send_batch(Range&& values)
+{
+	assert(shared_state_); // NOLINT
+
+	std::size_t number = 0;
+	for (auto&& element : values) {
+		value_type value(std::forward<decltype(element)>(element));
+		if (!shared_state_->queue.try_push(value))
+			break;
+
+		++number;
+	}
+
+	if (number != 0)
+		shared_state_->notify();
+	return number;
+}
+
+template<typename... Ts>
+typename queue_channel<Ts...>::shared_state& queue_channel<Ts...>::check_validity() const
+{
+	if (!is_valid())
+		throw channel_error{"queue_channel: has no state"};
+	return *shared_state_;
+}
+
+template<typename... Ts>
+bool queue_channel<Ts...>::wait_value(
+	shared_state& state, value_type& value, const std::chrono::steady_clock::time_point* const deadline)
+{
+	for (;;) {
+		if (state.queue.try_pop(value))
+			return true;
+
+		state.waiters_number.fetch_add(1, std::memory_order_seq_cst);
+		const std::uint32_t sequence = state.sequence.load(std::memory_order_seq_cst);
+		const bool received = state.queue.try_pop(value);
+		const bool is_in_time = received || detail::atomic_wait(state.sequence, sequence, deadline);
+		state.waiters_number.fetch_sub(1, std::memory_order_relaxed);
+
+		if (received)
+			return true;
+		if (!is_in_time)
+			return state.queue.try_pop(value);
+	}
+}
+
+template<typename... Us>
+bool operator==(const queue_channel<Us...>& lhs, const queue_channel<Us...>& rhs) noexcept
+{
+	return lhs.shared_state_ == rhs.shared_state_;
+}
+
+template<typename... Us>
+bool operator!=(const queue_channel<Us...>& lhs, const queue_channel<Us...>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+} // namespace channels
@@ -0,0 +1,519 @@
+#pragma once
+#include "detail/atomic_wait.h"
+#include "detail/compatibility/compile_features.h"
+#include "error.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace channels {
+
+/// Defines how a reader of `channels::ring_channel` waits for new values.
+enum class wait_strategy {
+	/// The reader spins without releasing the CPU. It has the lowest latency but it loads the CPU all the time.
+	busy_spin,
+	/// The reader calls `std::this_thread::yield` between checks.
+	yield,
+	/// The reader sleeps until the transmitter wakes it (using a futex on Linux). It doesn't load the CPU but the
+	/// transmitter makes a system call for each sending while the reader sleeps.
+	block,
+};
+
+/// The class `ring_channel` broadcasts values from one transmitter to many reader threads through a ring of
+/// preallocated slots (like the LMAX Disruptor).
+/// The transmitter writes each value to the next slot and publishes its sequence number; it never allocates memory and
+/// never calls user code. Each reader follows its own cursor, so every reader gets every value in order and readers don't
+/// contend with each other. If the slowest reader lags behind by `Capacity` values, the transmitter waits until it reads
+/// a value, so no value is lost.
+/// \note A reader that has stopped reading without being destroyed stops the transmitter. Use `get_max_lag` and
+///       `reader::get_lag` to monitor the readers.
+/// \warning The sending methods must not be called concurrently (there is only one producer).
+///
+/// Example:
+/// \code
+/// channels::transmitter<channels::ring_channel<quote, 4096>> transmitter;
+/// auto reader = transmitter.get_channel().make_reader(channels::wait_strategy::block);
+/// std::thread thread{[reader = std::move(reader)]() mutable {
+/// 	std::vector<quote> quotes;
+/// 	for (;;) {
+/// 		quotes.clear();
+/// 		reader.read_batch(std::back_inserter(quotes), 256);
+/// 		....
+/// 	}
+/// }};
+/// transmitter.send(quote{....});
+/// \endcode
+///
+/// \tparam T Type of the values. It must be default constructible and copy assignable.
+/// \tparam Capacity Number of slots. It must be a power of two.
+template<typename T, std::size_t Capacity>
+class ring_channel {
+	static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	template<typename U, std::size_t C>
+	friend bool operator==(const ring_channel<U, C>& lhs, const ring_channel<U, C>& rhs) noexcept; // NOLINT
+	template<typename U, std::size_t C>
+	friend bool operator!=(const ring_channel<U, C>& lhs, const ring_channel<U, C>& rhs) noexcept; // NOLINT
+
+	class shared_state;
+	struct cursor;
+
+public:
+	using value_type = T;
+
+	class reader;
+
+	/// Constructs a `ring_channel` object with no shared state.
+	/// \post `is_valid() == false`.
+	ring_channel() = default;
+
+	/// Checks if the `ring_channel` refers to a shared state.
+	CHANNELS_NODISCARD bool is_valid() const noexcept;
+
+	/// Creates a reader that gets all values sent after this call.
+	/// \note This method is thread safe.
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD reader make_reader(wait_strategy strategy = wait_strategy::yield) const;
+
+	/// Returns the number of sent values that the slowest reader hasn't read yet (zero if there are no readers).
+	/// \note This method is thread safe.
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD std::size_t get_max_lag() const;
+
+protected:
+	struct make_shared_state_tag {};
+
+	/// Constructs a `ring_channel` object with shared state.
+	/// \post `is_valid() == true`.
+	explicit ring_channel(make_shared_state_tag);
+
+	/// Writes the value to the next slot and publishes it to the readers.
+	/// If the slot hasn't been read by all readers yet, it waits until it is released.
+	/// \warning This method must not be called concurrently with other sending methods.
+	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
+	void send(T value);
+
+	/// Writes the elements of the range to the next slots and publishes them to the readers at once.
+	/// \warning This method must not be called concurrently with other sending methods.
+	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
+	template<typename Range>
+	void send_batch(Range&& values);
+
+private:
+	std::shared_ptr<shared_state> shared_state_;
+};
+
+/// The class `reader` is one consumer of `channels::ring_channel`.
+/// \note A `reader` object must be used by one thread at a time.
+template<typename T, std::size_t Capacity>
+class ring_channel<T, Capacity>::reader {
+	friend class ring_channel;
+
+public:
+	/// Constructs a `reader` object that isn't attached to a channel.
+	/// \post `is_valid() == false`.
+	reader() = default;
+
+	reader(const reader&) = delete;
+	reader(reader&&) noexcept = default;
+	reader& operator=(const reader&) = delete;
+	reader& operator=(reader&& other) noexcept;
+
+	/// Detaches the reader from the channel, so it doesn't hold the transmitter anymore.
+	~reader() noexcept;
+
+	/// Checks if the `reader` is attached to a channel.
+	CHANNELS_NODISCARD bool is_valid() const noexcept;
+
+	/// Returns the number of sent values that this reader hasn't read yet.
+	/// \note This method is thread safe.
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD std::size_t get_lag() const;
+
+	/// Copies the next value to the `value` if it has been sent. This method doesn't block.
+	/// \return `false` if there is no new value (the `value` isn't changed in this case).
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD bool try_read(T& value);
+
+	/// Copies the next value to the `value`. If it hasn't been sent yet, it waits according to the wait strategy.
+	/// \throw channel_error If `is_valid() == false`.
+	void read(T& value);
+
+	/// Same as method `read` but it waits not longer than `timeout`.
+	/// \return `false` if no value was sent during the `timeout` (the `value` isn't changed in this case).
+	/// \throw channel_error If `is_valid() == false`.
+	template<typename Rep, typename Period>
+	CHANNELS_NODISCARD bool read_for(T& value, const std::chrono::duration<Rep, Period>& timeout);
+
+	/// Copies up to `max_number` next values to the `out`. If there are no new values, it waits according to the wait
+	/// strategy until a value is sent.
+	/// \return The number of values written to the `out`. It isn't zero if `max_number` isn't zero.
+	/// \throw channel_error If `is_valid() == false`.
+	template<typename OutputIterator>
+	std::size_t read_batch(OutputIterator out, std::size_t max_number);
+
+private:
+	reader(std::shared_ptr<shared_state> shared_state, wait_strategy strategy);
+
+	shared_state& check_validity() const;
+	// Returns the number of available values. It is zero only if the `deadline` is reached.
+	// \param deadline The reader waits without a limit if it is null.
+	std::uint64_t wait_values(shared_state& state, const std::chrono::steady_clock::time_point* deadline);
+	void release() noexcept;
+
+	std::shared_ptr<shared_state> shared_state_;
+	std::unique_ptr<cursor> cursor_;
+	wait_strategy strategy_ = wait_strategy::yield;
+};
+
+// implementation
+
+template<typename Channel>
+struct channel_traits;
+
+template<typename T, std::size_t Capacity>
+struct channel_traits<ring_channel<T, Capacity>> {
+	static constexpr bool is_channel = true;
+};
+
+// Position of one reader. It is allocated separately, so the reader object can be moved while the transmitter reads
+// the position.
+template<typename T, std::size_t Capacity>
+struct ring_channel<T, Capacity>::cursor {
+	explicit cursor(const std::uint64_t sequence) noexcept
+		: next_sequence{sequence}
+	{}
+
+	// sequence number of the next value to read, all slots before it are released
+	std::atomic<std::uint64_t> next_sequence;
+};
+
+template<typename T, std::size_t Capacity>
+class ring_channel<T, Capacity>::shared_state {
+public:
+	static constexpr std::uint64_t mask = Capacity - 1;
+
+	shared_state()
+		: slots(Capacity)
+	{}
+
+	// Returns the sequence number of the next value of the writer.
+	CHANNELS_NODISCARD std::uint64_t get_published_sequence() const noexcept
+	{
+		return published_sequence.load(std::memory_order_seq_cst);
+	}
+
+	// Called by the writer before it writes the slot of the `sequence`.
+	void wait_slot(const std::uint64_t sequence) noexcept
+	{
+		while (sequence - gating_sequence >= Capacity) {
+			update_gating_sequence();
+			if (sequence - gating_sequence >= Capacity)
+				std::this_thread::yield();
+		}
+	}
+
+	// Makes all values before the `sequence` visible to the readers.
+	void publish(const std::uint64_t sequence) noexcept
+	{
+		// a blocked reader that has counted itself before this store sees the new value or gets woken up
+		published_sequence.store(sequence, std::memory_order_seq_cst);
+		if (blocked_readers_number.load(std::memory_order_seq_cst) != 0) {
+			wake_sequence.fetch_add(1, std::memory_order_seq_cst);
+			detail::atomic_notify_all(wake_sequence);
+		}
+	}
+
+	void add_cursor(cursor& reader_cursor)
+	{
+		const std::lock_guard<std::mutex> lock{cursors_mutex};
+		cursors.push_back(&reader_cursor);
+		// the writer doesn't overwrite the slots of values after the published ones until it takes this lock again
+		reader_cursor.next_sequence.store(get_published_sequence(), std::memory_order_relaxed);
+	}
+
+	void remove_cursor(cursor& reader_cursor) noexcept
+	{
+		const std::lock_guard<std::mutex> lock{cursors_mutex};
+		cursors.erase(std::find(cursors.begin(), cursors.end(), &reader_cursor));
+	}
+
+	CHANNELS_NODISCARD std::uint64_t get_max_lag() noexcept
+	{
+		const std::uint64_t published = get_published_sequence();
+		const std::lock_guard<std::mutex> lock{cursors_mutex};
+		std::uint64_t max_lag = 0;
+		for (const cursor* const reader_cursor : cursors)
+			max_lag = std::max(max_lag, published - reader_cursor->next_sequence.load(std::memory_order_acquire));
+		return max_lag;
+	}
+
+	std::vector<T> slots;
+
+	// the readers wait on these counters
+	std::atomic<std::uint64_t> published_sequence{0};
+	std::atomic<std::uint32_t> wake_sequence{0};
+	std::atomic<std::uint32_t> blocked_readers_number{0};
+
+	// the writer doesn't write the slots of values starting from `gating_sequence + Capacity`
+	std::uint64_t gating_sequence = 0;
+	std::uint64_t next_sequence = 0;
+
+private:
+	void update_gating_sequence() noexcept
+	{
+		const std::lock_guard<std::mutex> lock{cursors_mutex};
+		// a reader added after this call starts from the published sequence, so the writer can't pass it even if the
+		// `sequence` is ahead of the published one inside a batch
+		std::uint64_t minimum = get_published_sequence();
+		for (const cursor* const reader_cursor : cursors)
+			minimum = std::min(minimum, reader_cursor->next_sequence.load(std::memory_order_acquire));
+		gating_sequence = minimum;
+	}
+
+	std::mutex cursors_mutex;
+	std::vector<cursor*> cursors;
+};
+
+// ring_channel
+
+template<typename T, std::size_t Capacity>
+bool ring_channel<T, Capacity>::is_valid() const noexcept
+{
+	return static_cast<bool>(shared_state_);
+}
+
+template<typename T, std::size_t Capacity>
+typename ring_channel<T, Capacity>::reader ring_channel<T, Capacity>::make_reader(const wait_strategy strategy) const
+{
+	if (!is_valid())
+		throw channel_error{"ring_channel: has no state"};
+
+	return reader{shared_state_, strategy};
+}
+
+template<typename T, std::size_t Capacity>
+std::size_t ring_channel<T, Capacity>::get_max_lag() const
+{
+	if (!is_valid())
+		throw channel_error{"ring_channel: has no state"};
+
+	return static_cast<std::size_t>(shared_state_->get_max_lag());
+}
+
+template<typename T, std::size_t Capacity>
+ring_channel<T, Capacity>::ring_channel(make_shared_state_tag)
+	: shared_state_{std::make_shared<shared_state>()}
+{}
+
+template<typename T, std::size_t Capacity>
+void ring_channel<T, Capacity>::send(T value)
+{
+	assert(shared_state_); // NOLINT
+
+	shared_state& state = *shared_state_;
+	const std::uint64_t sequence = state.next_sequence;
+	state.wait_slot(sequence);
+	state.slots[sequence & shared_state::mask] = std::move(value);
+	state.next_sequence = sequence + 1;
+	state.publish(sequence + 1);
+}
+
+template<typename T, std::size_t Capacity>
+template<typename Range>
+void ring_channel<T, Capacity>::send_batch(Range&& values)
+{
+	assert(shared_state_); // NOLINT
+
+	shared_state& state = *shared_state_;
+	const std::uint64_t first_sequence = state.next_sequence;
+	std::uint64_t published_sequence = first_sequence;
+	std::uint64_t sequence = first_sequence;
+	for (auto&& value : values) {
+		// the readers can't release the slots of unpublished values, so a batch longer than the ring is published in
+		// parts
+		if (sequence - published_sequence == Capacity) {
+			state.publish(sequence);
+			published_sequence = sequence;
+		}
+		state.wait_slot(sequence);
+		state.slots[sequence & shared_state::mask] = std::forward<decltype(value)>(value);
+		++sequence;
+		state.next_sequence = sequence;
+	}
+
+	if (sequence != published_sequence)
+		state.publish(sequence);
+}
+
+// ring_channel::reader
+
+template<typename T, std::size_t Capacity>
+typename ring_channel<T, Capacity>::reader& ring_channel<T, Capacity>::reader::operator=(reader&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	release();
+	shared_state_ = std::move(other.shared_state_);
+	cursor_ = std::move(other.cursor_);
+	strategy_ = other.strategy_;
+	return *this;
+}
+
+template<typename T, std::size_t Capacity>
+ring_channel<T, Capacity>::reader::~reader() noexcept
+{
+	release();
+}
+
+template<typename T, std::size_t Capacity>
+bool ring_channel<T, Capacity>::reader::is_valid() const noexcept
+{
+	return static_cast<bool>(shared_state_);
+}
+
+template<typename T, std::size_t Capacity>
+std::size_t ring_channel<T, Capacity>::reader::get_lag() const
+{
+	const shared_state& state = check_validity();
+	return static_cast<std::size_t>(
+		state.get_published_sequence() - cursor_->next_sequence.load(std::memory_order_relaxed));
+}
+
+template<typename T, std::size_t Capacity>
+bool ring_channel<T, Capacity>::reader::try_read(T& value)
+{
+	shared_state& state = check_validity();
+	const std::uint64_t sequence = cursor_->next_sequence.load(std::memory_order_relaxed);
+	if (sequence == state.published_sequence.load(std::memory_order_acquire))
+		return false;
+
+	value = state.slots[sequence & shared_state::mask];
+	cursor_->next_sequence.store(sequence + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T, std::size_t Capacity>
+void ring_channel<T, Capacity>::reader::read(T& value)
+{
+	const std::size_t number = read_batch(&value, 1);
+	assert(number == 1); // NOLINT
+	(void) number;
+}
+
+template<typename T, std::size_t Capacity>
+template<typename Rep, typename Period>
+bool ring_channel<T, Capacity>::reader::read_for(T& value, const std::chrono::duration<Rep, Period>& timeout)
+{
+	shared_state& state = check_validity();
+	const std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+	if (wait_values(state, &deadline) == 0)
+		return false;
+
+	const std::uint64_t sequence = cursor_->next_sequence.load(std::memory_order_relaxed);
+	value = state.slots[sequence & shared_state::mask];
+	cursor_->next_sequence.store(sequence + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T, std::size_t Capacity>
+template<typename OutputIterator>
+std::size_t ring_channel<T, Capacity>::reader::read_batch(OutputIterator out, const std::size_t max_number)
+{
+	shared_state& state = check_validity();
+	if (max_number == 0)
+		return 0;
+
+	const std::uint64_t number = std::min<std::uint64_t>(wait_values(state, nullptr), max_number);
+	const std::uint64_t first_sequence = cursor_->next_sequence.load(std::memory_order_relaxed);
+	for (std::uint64_t sequence = first_sequence; sequence != first_sequence + number; ++sequence) {
+		*out = state.slots[sequence & shared_state::mask];
+		++out;
+	}
+	// the slots are released only after all values are copied
+	cursor_->next_sequence.store(first_sequence + number, std::memory_order_release);
+	return static_cast<std::size_t>(number);
+}
+
+template<typename T, std::size_t Capacity>
+ring_channel<T, Capacity>::reader::reader(std::shared_ptr<shared_state> shared_state, const wait_strategy strategy)
+	: shared_state_{std::move(shared_state)}
+	, cursor_{std::make_unique<cursor>(0)}
+	, strategy_{strategy}
+{
+	shared_state_->add_cursor(*cursor_);
+}
+
+template<typename T, std::size_t Capacity>
+typename ring_channel<T, Capacity>::shared_state& ring_channel<T, Capacity>::reader::check_validity() const
+{
+	if (!is_valid())
+		throw channel_error{"ring_channel::reader: has no state"};
+	return *shared_state_;
+}
+
+template<typename T, std::size_t Capacity>
+std::uint64_t ring_channel<T, Capacity>::reader::wait_values(
+	shared_state& state, const std::chrono::steady_clock::time_point* deadline)
+{
+	const std::uint64_t sequence = cursor_->next_sequence.load(std::memory_order_relaxed);
+	for (;;) {
+		const std::uint64_t published = state.published_sequence.load(std::memory_order_acquire);
+		if (published != sequence)
+			return published - sequence;
+		if (deadline && std::chrono::steady_clock::now() >= *deadline)
+			return 0;
+
+		switch (strategy_) {
+		case wait_strategy::busy_spin:
+			break;
+		case wait_strategy::yield:
+			std::this_thread::yield();
+			break;
+		case wait_strategy::block: {
+			state.blocked_readers_number.fetch_add(1, std::memory_order_seq_cst);
+			const std::uint32_t wake_sequence = state.wake_sequence.load(std::memory_order_seq_cst);
+			if (state.get_published_sequence() == sequence)
+				(void) detail::atomic_wait(state.wake_sequence, wake_sequence, deadline);
+			state.blocked_readers_number.fetch_sub(1, std::memory_order_relaxed);
+			break;
+		}
+		}
+	}
+}
+
+template<typename T, std::size_t Capacity>
+void ring_channel<T, Capacity>::reader::release() noexcept
+{
+	if (!shared_state_)
+		return;
+
+	shared_state_->remove_cursor(*cursor_);
+	shared_state_.reset();
+	cursor_.reset();
+}
+
+template<typename U, std::size_t C>
+bool operator==(const ring_channel<U, C>& lhs, const ring_channel<U, C>& rhs) noexcept
+{
+	return lhs.shared_state_ == rhs.shared_state_;
+}
+
+template<typename U, std::size_t C>
+bool operator!=(const ring_channel<U, C>& lhs, const ring_channel<U, C>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+} // namespace channels
@@ -0,0 +1,157 @@
+#pragma once
+#include "detail/compatibility/compile_features.h"
+#include "detail/select_source.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace channels {
+
+/// The class `selector` waits for events on several channels at once without spinning and without a thread per
+/// channel (like `select` in Go).
+/// The supported channels and their events are:
+/// - `channels::queue_channel`: the queue isn't empty;
+/// - `channels::buffered_channel`: a new value was sent since the selector reported this channel last time (the value
+///   sent before the channel was added is also reported).
+///
+/// The selector registers one waiter in all its channels, so a sending wakes the blocked selector with one system call.
+/// The channels are checked in the round-robin order starting after the last reported channel, so a busy channel
+/// doesn't starve the others.
+/// \note A `queue_channel` can be reported as ready but its value can be taken by another consumer before this thread
+///       calls `try_receive`, so the consumer should use `try_receive` after the selection.
+/// \note The `selector` object must be used by one thread at a time.
+///
+/// Example:
+/// \code
+/// channels::selector selector;
+/// const std::size_t jobs_index = selector.add(jobs_channel); // queue_channel<job>
+/// const std::size_t config_index = selector.add(config_channel); // buffered_channel<config>
+/// for (;;) {
+/// 	const std::size_t index = selector.select();
+/// 	if (index == jobs_index) {
+/// 		std::tuple<job> job;
+/// 		while (jobs_channel.try_receive(job))
+/// 			....
+/// 	}
+/// 	else if (index == config_index) {
+/// 		apply_config(*config_channel.get_value());
+/// 	}
+/// }
+/// \endcode
+class selector {
+public:
+	/// The index returned if no channel is ready.
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	/// Constructs the `selector` object without channels.
+	selector() = default;
+
+	selector(const selector&) = delete;
+	selector(selector&&) = delete;
+	selector& operator=(const selector&) = delete;
+	selector& operator=(selector&&) = delete;
+
+	/// Removes the selector from all its channels.
+	~selector() noexcept;
+
+	/// Adds the channel to the selector.
+	/// \return The index of the channel. Indexes are assigned in the order of addition starting from zero.
+	/// \throw channel_error If `channel.is_valid() == false`.
+	template<typename Channel>
+	std::size_t add(const Channel& channel);
+
+	/// Returns the number of added channels.
+	CHANNELS_NODISCARD std::size_t get_size() const noexcept;
+
+	/// Returns the index of a ready channel or `npos` if there are no ready channels. This method doesn't block.
+	CHANNELS_NODISCARD std::size_t try_select() noexcept;
+
+	/// Returns the index of a ready channel. If there are no ready channels, it waits until one of them becomes ready.
+	/// \warning It waits forever if the selector has no channels.
+	CHANNELS_NODISCARD std::size_t select() noexcept;
+
+	/// Same as method `select` but it waits not longer than `timeout`.
+	/// \return The index of a ready channel or `npos` if no channel became ready during the `timeout`.
+	template<typename Rep, typename Period>
+	CHANNELS_NODISCARD std::size_t select_for(const std::chrono::duration<Rep, Period>& timeout) noexcept;
+
+private:
+	struct entry {
+		std::shared_ptr<detail::select_source> source;
+		std::uint64_t version;
+	};
+
+	std::size_t add_source(std::shared_ptr<detail::select_source> source);
+	std::size_t wait(const std::chrono::steady_clock::time_point* deadline) noexcept;
+
+	detail::wake_signal notifier_;
+	std::vector<entry> entries_;
+	std::size_t next_index_ = 0;
+};
+
+/// Waits until one of the `channels` is ready.
+/// It is a shortcut for a temporary `channels::selector` with all `channels`.
+/// \return The index of the ready channel in the argument list.
+/// \throw channel_error If one of the `channels` isn't valid.
+template<typename... Channels>
+CHANNELS_NODISCARD std::size_t select(const Channels&... channels);
+
+/// Returns the index of a ready channel in the argument list or `selector::npos` if there are no ready channels.
+/// This function doesn't block.
+/// \throw channel_error If one of the `channels` isn't valid.
+template<typename... Channels>
+CHANNELS_NODISCARD std::size_t try_select(const Channels&... channels);
+
+// implementation
+
+// selector
+
+template<typename Channel>
+std::size_t selector::add(const Channel& channel)
+{
+	return add_source(channel.get_select_source());
+}
+
+template<typename Rep, typename Period>
+std::size_t selector::select_for(const std::chrono::duration<Rep, Period>& timeout) noexcept
+{
+	const std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+	return wait(&deadline);
+}
+
+// functions
+
+namespace select_detail {
+
+inline void add_channels(selector&)
+{}
+
+template<typename Channel, typename... Channels>
+void add_channels(selector& selector, const Channel& channel, const Channels&... channels)
+{
+	(void) selector.add(channel);
+	add_channels(selector, channels...);
+}
+
+} // namespace select_detail
+
+template<typename... Channels>
+std::size_t select(const Channels&... channels)
+{
+	selector selector;
+	select_detail::add_channels(selector, channels...);
+	return selector.select();
+}
+
+template<typename... Channels>
+std::size_t try_select(const Channels&... channels)
+{
+	selector selector;
+	select_detail::add_channels(selector, channels...);
+	return selector.try_select();
+}
+
+} // namespace channels
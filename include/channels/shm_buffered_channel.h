@@ -0,0 +1,417 @@
+#pragma once
+#include "detail/compatibility/compile_features.h"
+
+#ifdef CHANNELS_HAS_SHARED_MEMORY
+
+#include "detail/atomic_wait.h"
+#include "detail/seqlock_value.h"
+#include "detail/shared_memory.h"
+#include "error.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+
+/// The class `shm_buffered_channel` is similar to `channels::buffered_channel` but it keeps the last value sent in a
+/// named shared memory object, so processes on one host can read it without serialization and sockets.
+/// The transmitter `channels::transmitter<shm_buffered_channel<T>>` creates the object by name and other processes
+/// open it with the constructor `shm_buffered_channel(name)`.
+/// The value is protected by a sequence lock: the readers never take locks and `read_value` never writes to the shared
+/// memory, so any number of readers in any number of processes don't slow down the transmitter and each other. The
+/// readers can also wait for a new value; they sleep on a futex placed in the shared memory (on systems without futexes
+/// they poll the value). The waiting readers count themselves in the shared memory, so the readers map the object for
+/// writing too and need write access to it.
+/// \note The values are only copied, callbacks aren't supported.
+/// \note The shared memory object is removed when the transmitter is destroyed. The processes that have opened the
+///       channel keep the last value but don't see new ones: the channel is closed for them, and the waiting methods
+///       wake up and throw `channels::channel_error`. A new transmitter with the same name replaces the object, the
+///       readers have to open the channel again to see it. The replaced transmitter doesn't remove the new object.
+/// \note The readers detect that the process of the transmitter has died (the channel is closed in this case too), so
+///       they don't wait for it forever. If the process has died while it was storing a value, `read_value` throws
+///       `channels::channel_error`.
+/// \warning There must be only one transmitter for a name at a time.
+///
+/// Example:
+/// \code
+/// // publisher process
+/// channels::transmitter<channels::shm_buffered_channel<risk_snapshot>> transmitter{"/risk"};
+/// transmitter.send(calculate_risk());
+///
+/// // reader process
+/// const channels::shm_buffered_channel<risk_snapshot> channel{"/risk"};
+/// std::uint32_t version = 0;
+/// for (;;) {
+/// 	channel.wait_update(version);
+/// 	risk_snapshot snapshot;
+/// 	if (channel.read_value(snapshot))
+/// 		....
+/// }
+/// \endcode
+///
+/// \tparam T Type of the value. It must be trivially copyable and mustn't contain pointers to the memory of the
+///           process.
+template<typename T>
+class shm_buffered_channel {
+	static_assert(std::is_trivially_copyable<T>::value, "shm_buffered_channel requires trivially copyable type");
+	static_assert(
+		ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LONG_LOCK_FREE == 2 && ATOMIC_POINTER_LOCK_FREE == 2,
+		"shm_buffered_channel requires lock-free atomics");
+
+	template<typename U>
+	friend bool operator==(const shm_buffered_channel<U>& lhs, const shm_buffered_channel<U>& rhs) noexcept; // NOLINT
+	template<typename U>
+	friend bool operator!=(const shm_buffered_channel<U>& lhs, const shm_buffered_channel<U>& rhs) noexcept; // NOLINT
+
+	struct layout;
+	class shared_state;
+
+public:
+	using value_type = T;
+
+	/// Constructs a `shm_buffered_channel` object with no shared state.
+	/// \post `is_valid() == false`.
+	shm_buffered_channel() = default;
+
+	/// Opens the channel created by the transmitter with the same `name` in this or another process.
+	/// \param name Name of the shared memory object (like "/name").
+	/// \post `is_valid() == true`.
+	/// \throw channel_error If there is no channel with the `name` or it was created for another type of values.
+	explicit shm_buffered_channel(const std::string& name);
+
+	/// Checks if the `shm_buffered_channel` refers to a shared state.
+	CHANNELS_NODISCARD bool is_valid() const noexcept;
+
+	/// Copies the last value sent to the `value`.
+	/// This method doesn't take locks and doesn't write to the shared memory.
+	/// \return `false` if no value has been sent yet (the `value` isn't changed in this case).
+	/// \throw channel_error If `is_valid() == false` or the process of the transmitter has died while it was storing
+	///        the value.
+	CHANNELS_NODISCARD bool read_value(T& value) const;
+
+	/// Checks if the transmitter has been destroyed or its process has died.
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD bool is_closed() const;
+
+	/// Returns the version of the value. It is zero if no value has been sent yet and it is changed by each sending.
+	/// \throw channel_error If `is_valid() == false`.
+	CHANNELS_NODISCARD std::uint32_t get_version() const;
+
+	/// Waits until the version of the value differs from the `version` and then writes the new version to it.
+	/// \note The reader should read the value after this call. If several values were sent during the wait, only the
+	///       last one can be read.
+	/// \note Unlike `read_value`, this method writes to the shared memory: it counts the waiting readers there.
+	/// \throw channel_error If `is_valid() == false` or the channel is closed while the version equals `version`.
+	void wait_update(std::uint32_t& version) const;
+
+	/// Same as method `wait_update` but it waits not longer than `timeout`.
+	/// \return `false` if no value was sent during the `timeout` (the `version` isn't changed in this case).
+	/// \throw channel_error If `is_valid() == false` or the channel is closed while the version equals `version`.
+	template<typename Rep, typename Period>
+	CHANNELS_NODISCARD bool wait_update_for(
+		std::uint32_t& version, const std::chrono::duration<Rep, Period>& timeout) const;
+
+protected:
+	struct make_shared_state_tag {};
+
+	/// Creates the shared memory object with the `name` and constructs a `shm_buffered_channel` object with it.
+	/// \post `is_valid() == true`.
+	/// \throw channel_error If the shared memory object can't be created.
+	shm_buffered_channel(make_shared_state_tag, const std::string& name);
+
+	/// Stores the `value` to the shared memory and wakes the waiting readers.
+	/// \note This method is thread safe.
+	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
+	void send(const T& value);
+
+	/// Stores the last element of the range to the shared memory and wakes the waiting readers.
+	/// \note This method is thread safe.
+	/// \pre `is_valid() == true`. The behavior is undefined if `is_valid() == false` before the call to this method.
+	template<typename Range>
+	void send_batch(Range&& values);
+
+private:
+	// number of checks of the sequence lock after which the reader checks that the transmitter is alive
+	static constexpr std::size_t lock_attempts_number = 1024;
+	// the waiting readers wake up with this period to check that the transmitter is alive
+	static constexpr std::chrono::milliseconds liveness_check_period{100};
+
+	void check_validity() const;
+	bool wait(std::uint32_t& version, const std::chrono::steady_clock::time_point* deadline) const;
+
+	std::shared_ptr<shared_state> shared_state_;
+};
+
+// implementation
+
+template<typename Channel>
+struct channel_traits;
+
+template<typename T>
+struct channel_traits<shm_buffered_channel<T>> {
+	static constexpr bool is_channel = true;
+};
+
+// Data placed in the shared memory object. It contains only lock-free atomics, so it can be used by several processes.
+template<typename T>
+struct shm_buffered_channel<T>::layout {
+	// the transmitter writes this value after the layout is constructed
+	static constexpr std::uint32_t ready_mark = 0x43484e31;
+
+	std::atomic<std::uint32_t> ready{0};
+	// they are checked by the readers to detect channels created for other types
+	std::uint32_t value_size = sizeof(T);
+	std::uint32_t value_alignment = alignof(T);
+	// it is checked by the readers to detect the transmitter that has died without closing the channel
+	std::int64_t owner_process = 0;
+
+	std::atomic<std::uint32_t> closed{0};
+	std::atomic<std::uint32_t> version{0};
+	std::atomic<std::uint32_t> waiters_number{0};
+	detail::seqlock_value<T> value;
+};
+
+template<typename T>
+class shm_buffered_channel<T>::shared_state {
+public:
+	explicit shared_state(const std::string& name)
+		: memory_{name, sizeof(layout)}
+		, layout_{static_cast<layout*>(memory_.get_address())}
+	{
+		if (layout_->ready.load(std::memory_order_acquire) != layout::ready_mark)
+			throw channel_error{"shm_buffered_channel: channel isn't initialized"};
+		if (layout_->value_size != sizeof(T) || layout_->value_alignment != alignof(T))
+			throw channel_error{"shm_buffered_channel: channel has another type"};
+	}
+
+	shared_state(detail::shared_memory::create_tag tag, const std::string& name)
+		: memory_{tag, name, sizeof(layout)}
+		, layout_{new (memory_.get_address()) layout{}}
+		, is_owner_{true}
+	{
+		layout_->owner_process = detail::get_process_id();
+		layout_->ready.store(layout::ready_mark, std::memory_order_release);
+	}
+
+	shared_state(const shared_state&) = delete;
+	shared_state(shared_state&&) = delete;
+	shared_state& operator=(const shared_state&) = delete;
+	shared_state& operator=(shared_state&&) = delete;
+
+	~shared_state() noexcept
+	{
+		if (!is_owner_)
+			return;
+
+		// the readers of other processes keep the mapping, so they are woken up to see that the channel is closed
+		layout_->closed.store(1, std::memory_order_seq_cst);
+		if (layout_->waiters_number.load(std::memory_order_seq_cst) != 0)
+			detail::atomic_notify_all_shared(layout_->version);
+	}
+
+	CHANNELS_NODISCARD layout& get_layout() const noexcept
+	{
+		return *layout_;
+	}
+
+	CHANNELS_NODISCARD bool is_closed() const noexcept
+	{
+		return layout_->closed.load(std::memory_order_seq_cst) != 0
+			|| !detail::is_process_alive(layout_->owner_process);
+	}
+
+	void store(const T& value)
+	{
+		const std::lock_guard<std::mutex> lock{send_mutex_};
+		layout_->value.store(std::tuple<T>{value});
+
+		// zero is reserved for the channel without a value
+		std::uint32_t version = layout_->version.load(std::memory_order_relaxed) + 1;
+		if (version == 0)
+			version = 1;
+		// a reader that has counted itself before this store sees the new version or gets woken up
+		layout_->version.store(version, std::memory_order_seq_cst);
+		if (layout_->waiters_number.load(std::memory_order_seq_cst) != 0)
+			detail::atomic_notify_all_shared(layout_->version);
+	}
+
+private:
+	detail::shared_memory memory_;
+	layout* layout_;
+	const bool is_owner_ = false;
+	// it serializes the writers of the sequence lock in this process
+	std::mutex send_mutex_;
+};
+
+// shm_buffered_channel
+
+template<typename T>
+constexpr std::size_t shm_buffered_channel<T>::lock_attempts_number;
+
+template<typename T>
+constexpr std::chrono::milliseconds shm_buffered_channel<T>::liveness_check_period;
+
+template<typename T>
+shm_buffered_channel<T>::shm_buffered_channel(const std::string& name)
+	: shared_state_{std::make_shared<shared_state>(name)}
+{}
+
+template<typename T>
+bool shm_buffered_channel<T>::is_valid() const noexcept
+{
+	return static_cast<bool>(shared_state_);
+}
+
+template<typename T>
+bool shm_buffered_channel<T>::read_value(T& value) const
+{
+	check_validity();
+	std::tuple<T> tuple_value;
+	for (;;) {
+		switch (shared_state_->get_layout().value.try_load(tuple_value, lock_attempts_number)) {
+		case detail::seqlock_load_status::loaded:
+			value = std::get<0>(tuple_value);
+			return true;
+		case detail::seqlock_load_status::empty:
+			return false;
+		case detail::seqlock_load_status::busy:
+			// the transmitter closes the channel only after its last sending, so a closed channel with the lock held
+			// means that the process has died in the middle of the sending
+			if (shared_state_->is_closed())
+				throw channel_error{"shm_buffered_channel: transmitter has died while sending"};
+			break;
+		}
+	}
+}
+
+template<typename T>
+bool shm_buffered_channel<T>::is_closed() const
+{
+	check_validity();
+	return shared_state_->is_closed();
+}
+
+template<typename T>
+std::uint32_t shm_buffered_channel<T>::get_version() const
+{
+	check_validity();
+	return shared_state_->get_layout().version.load(std::memory_order_acquire);
+}
+
+template<typename T>
+void shm_buffered_channel<T>::wait_update(std::uint32_t& version) const
+{
+	check_validity();
+	(void) wait(version, nullptr);
+}
+
+template<typename T>
+template<typename Rep, typename Period>
+bool shm_buffered_channel<T>::wait_update_for(
+	std::uint32_t& version, const std::chrono::duration<Rep, Period>& timeout) const
+{
+	check_validity();
+	const std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+	return wait(version, &deadline);
+}
+
+template<typename T>
+shm_buffered_channel<T>::shm_buffered_channel(make_shared_state_tag, const std::string& name)
+	: shared_state_{std::make_shared<shared_state>(detail::shared_memory::create_tag{}, name)}
+{}
+
+template<typename T>
+void shm_buffered_channel<T>::send(const T& value)
+{
+	assert(shared_state_); // NOLINT
+	shared_state_->store(value);
+}
+
+template<typename T>
+template<typename Range>
+void shm_buffered_channel<T>::send_batch(Range&& values)
+{
+	assert(shared_state_); // NOLINT
+
+	// only the last value is visible to the readers, so the others aren't stored
+	std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+	bool has_value = false;
+	for (auto&& value : values) {
+		::new (&storage) T(std::forward<decltype(value)>(value));
+		has_value = true;
+	}
+
+	if (has_value)
+		shared_state_->store(*reinterpret_cast<const T*>(&storage)); // NOLINT
+}
+
+template<typename T>
+void shm_buffered_channel<T>::check_validity() const
+{
+	if (!is_valid())
+		throw channel_error{"shm_buffered_channel: has no state"};
+}
+
+template<typename T>
+bool shm_buffered_channel<T>::wait(
+	std::uint32_t& version, const std::chrono::steady_clock::time_point* const deadline) const
+{
+	layout& shared_layout = shared_state_->get_layout();
+	for (;;) {
+		const std::uint32_t current_version = shared_layout.version.load(std::memory_order_seq_cst);
+		if (current_version != version) {
+			version = current_version;
+			return true;
+		}
+		if (shared_state_->is_closed())
+			throw channel_error{"shm_buffered_channel: channel is closed"};
+
+		// the closing doesn't change the version, so a reader that misses the wakeup sees it at the next check
+		const std::chrono::steady_clock::time_point check_time =
+			std::chrono::steady_clock::now() + liveness_check_period;
+		const bool is_check_first = !deadline || check_time < *deadline;
+
+		shared_layout.waiters_number.fetch_add(1, std::memory_order_seq_cst);
+		bool is_in_time = true;
+		if (shared_layout.version.load(std::memory_order_seq_cst) == version
+			&& shared_layout.closed.load(std::memory_order_seq_cst) == 0)
+			is_in_time =
+				detail::atomic_wait_shared(shared_layout.version, version, is_check_first ? &check_time : deadline);
+		shared_layout.waiters_number.fetch_sub(1, std::memory_order_relaxed);
+
+		if (!is_in_time && !is_check_first) {
+			const std::uint32_t last_version = shared_layout.version.load(std::memory_order_acquire);
+			if (last_version == version)
+				return false;
+
+			version = last_version;
+			return true;
+		}
+	}
+}
+
+template<typename U>
+bool operator==(const shm_buffered_channel<U>& lhs, const shm_buffered_channel<U>& rhs) noexcept
+{
+	return lhs.shared_state_ == rhs.shared_state_;
+}
+
+template<typename U>
+bool operator!=(const shm_buffered_channel<U>& lhs, const shm_buffered_channel<U>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+} // namespace channels
+
+#endif
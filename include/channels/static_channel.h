@@ -0,0 +1,207 @@
+#pragma once
+#include "connection.h"
+#include "detail/compatibility/compile_features.h"
+#include "detail/static_socket.h"
+#include "error.h"
+#include "error_policy.h"
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+
+/// The class `static_channel` is similar to `channels::channel` but its set of callback functions is bounded at
+/// compile time: the channel keeps up to `N` callback functions in its own slots. The connecting and the sending don't
+/// allocate memory and don't take locks, and the sending calls the callback functions in one pass over the `N` slots.
+/// The constructor is `constexpr`, so the transmitter of the channel can be placed in static storage without dynamic
+/// initialization.
+/// \note The channel isn't shared between copies like `channels::channel`: it is the storage of the callback
+///       functions, so it can't be copied and `get_channel` of the transmitter returns a reference to it.
+/// \note The callback functions are called in order of the slots, a new callback function takes the first free slot.
+///       Unlike `channels::channel`, a callback function connected during the sending is called by this sending if
+///       it takes a slot that the sending hasn't passed yet.
+/// \note The callback functions can't be connected with executors. The size of a callback function must not exceed
+///       `detail::static_socket_base::storage_size` (four pointers).
+/// \warning The connections must be disconnected before the channel is destroyed.
+///
+/// Example:
+/// \code
+/// static channels::transmitter<channels::static_channel<4, order>> order_transmitter;
+///
+/// channels::static_connection connection = order_transmitter.get_channel().connect([](const order& o) { .... });
+/// order_transmitter.send(order{....});
+/// \endcode
+///
+/// \tparam N Maximum number of connected callback functions.
+/// \tparam Ts Types of parameters passed to callback functions.
+template<std::size_t N, typename... Ts>
+class static_channel {
+	static_assert(N != 0, "static_channel must have at least one slot");
+
+	using socket_type = detail::static_socket<Ts...>;
+	using exceptions_type = callbacks_exception::exceptions_type;
+	using error_policy = error_policy_t<static_channel>;
+
+public:
+	static_channel(const static_channel&) = delete;
+	static_channel& operator=(const static_channel&) = delete;
+
+	/// Destroys the connected callback functions.
+	~static_channel() noexcept;
+
+	/// Returns the maximum number of connected callback functions.
+	CHANNELS_NODISCARD static constexpr std::size_t get_capacity() noexcept;
+
+	/// Adds callback function to be called when `channels::transmitter` sends values to the channel object.
+	/// \note This method is thread safe.
+	/// \param callback Reference to the callback function.
+	///                 Callback type must match the concept `std::Invocable<Callback, const Ts&...>`.
+	/// \return A `channels::static_connection` object that controls the current connection.
+	/// \throw channel_error If all `N` slots are connected.
+	/// \throws Any exception thrown by the copy or move constructors of callback.
+	template<typename Callback>
+	CHANNELS_NODISCARD static_connection connect(Callback&& callback) const;
+
+protected:
+	struct make_shared_state_tag {};
+
+	/// Constructs a `static_channel` object without callback functions.
+	constexpr explicit static_channel(make_shared_state_tag) noexcept {}
+
+	/// Calls all connected callback functions and passes arguments to them.
+	/// \note This method is thread safe.
+	/// \param args Arguments to pass to the callback functions.
+	/// \throw callbacks_exception If one or more callback functions threw exceptions (it depends on the error policy
+	///        of the channel, see `channels::error_policy_traits`).
+	void send(Ts... args);
+
+private:
+	template<typename Policy>
+	void deliver(Policy error_policy, const Ts&... args, exceptions_type& exceptions) noexcept(
+		std::is_same<Policy, policy::nothrow>::value);
+
+	static bool call_socket(
+		policy::collect_exceptions, socket_type& socket, const Ts&... args, exceptions_type& exceptions);
+	static bool call_socket(policy::fail_fast, socket_type& socket, const Ts&... args, exceptions_type& exceptions);
+	static bool call_socket(
+		policy::nothrow, socket_type& socket, const Ts&... args, exceptions_type& exceptions) noexcept;
+
+	mutable socket_type sockets_[N]{}; // NOLINT(cppcoreguidelines-avoid-c-arrays)
+};
+
+// implementation
+
+template<typename Channel>
+struct channel_traits;
+
+template<std::size_t N, typename... Ts>
+struct channel_traits<static_channel<N, Ts...>> {
+	static constexpr bool is_channel = true;
+};
+
+// static_channel
+
+template<std::size_t N, typename... Ts>
+static_channel<N, Ts...>::~static_channel() noexcept
+{
+	for (socket_type& socket : sockets_)
+		socket.destroy();
+}
+
+template<std::size_t N, typename... Ts>
+constexpr std::size_t static_channel<N, Ts...>::get_capacity() noexcept
+{
+	return N;
+}
+
+template<std::size_t N, typename... Ts>
+template<typename Callback>
+static_connection static_channel<N, Ts...>::connect(Callback&& callback) const
+{
+	static_assert(
+		detail::is_allowed_callback<error_policy, Callback, Ts...>::value,
+		"Callback must be noexcept for static_channel with policy::nothrow");
+
+	for (socket_type& socket : sockets_) {
+		if (!socket.try_reserve())
+			continue;
+
+		try {
+			socket.construct(std::forward<Callback>(callback));
+		}
+		catch (...) {
+			socket.cancel();
+			throw;
+		}
+		socket.publish();
+		return static_connection{socket};
+	}
+
+	throw channel_error{"static_channel: has no free slots"};
+}
+
+template<std::size_t N, typename... Ts>
+void static_channel<N, Ts...>::send(Ts... args)
+{
+	// an empty vector doesn't allocate memory until some callback throws
+	exceptions_type exceptions;
+	deliver(error_policy{}, args..., exceptions);
+
+	if (!exceptions.empty())
+		throw callbacks_exception{std::move(exceptions)};
+}
+
+template<std::size_t N, typename... Ts>
+template<typename Policy>
+void static_channel<N, Ts...>::deliver(
+	const Policy error_policy, const Ts&... args, exceptions_type& exceptions) noexcept(
+	std::is_same<Policy, policy::nothrow>::value)
+{
+	for (socket_type& socket : sockets_) {
+		if (!socket.try_enter())
+			continue;
+
+		const bool is_continued = call_socket(error_policy, socket, args..., exceptions);
+		socket.leave();
+		if (!is_continued)
+			break;
+	}
+}
+
+template<std::size_t N, typename... Ts>
+bool static_channel<N, Ts...>::call_socket(
+	policy::collect_exceptions, socket_type& socket, const Ts&... args, exceptions_type& exceptions)
+{
+	try {
+		socket(args...);
+	}
+	catch (...) {
+		exceptions.push_back(std::current_exception());
+	}
+	return true;
+}
+
+template<std::size_t N, typename... Ts>
+bool static_channel<N, Ts...>::call_socket(
+	policy::fail_fast, socket_type& socket, const Ts&... args, exceptions_type& exceptions)
+{
+	try {
+		socket(args...);
+	}
+	catch (...) {
+		exceptions.push_back(std::current_exception());
+		return false;
+	}
+	return true;
+}
+
+template<std::size_t N, typename... Ts>
+bool static_channel<N, Ts...>::call_socket(
+	policy::nothrow, socket_type& socket, const Ts&... args, exceptions_type&) noexcept
+{
+	socket(args...);
+	return true;
+}
+
+} // namespace channels
@@ -0,0 +1,62 @@
+#pragma once
+#include <type_traits>
+
+namespace channels {
+namespace policy {
+
+/// The channel can be used from any threads. It is the default threading policy.
+struct multi_thread {};
+
+/// The channel is used only by one thread (like a channel of an event loop). It can be created in another thread and
+/// handed to this one: the thread is the one that first connects to the channel or sends to it. In debug builds the
+/// channel asserts that it isn't used by other threads.
+/// The sending, the connecting and the disconnecting don't take locks and the sending doesn't pin the thread for the
+/// memory reclamation. The reference counters of the callback functions and the pointer to the list of them stay atomic
+/// (they are uncontended in one thread), because the policy is handled by the parts of the channel that are shared by
+/// all channel types.
+/// \warning The callback functions connected with executors can be invoked in other threads, but they mustn't use the
+///          channel there.
+struct single_thread {};
+
+} // namespace policy
+
+/// Traits class selecting the threading policy of the channel type (`channels::channel`, `channels::buffered_channel`
+/// or `channels::keyed_channel`). It is specialized in the same way as `channels::error_policy_traits`:
+/// \code
+/// namespace channels {
+/// template<>
+/// struct threading_policy_traits<channel<mouse_event>> {
+/// 	using type = policy::single_thread;
+/// };
+/// } // namespace channels
+/// \endcode
+/// \note The specialization must be declared before the channel type is used.
+template<typename Channel>
+struct threading_policy_traits {
+	using type = policy::multi_thread;
+};
+
+template<typename Channel>
+using threading_policy_t = typename threading_policy_traits<Channel>::type;
+
+namespace detail {
+
+template<typename Policy>
+using is_single_threaded = std::is_same<Policy, policy::single_thread>;
+
+// Mutex that does nothing. It replaces the mutexes of the channels with policy `single_thread`.
+struct null_mutex {
+	void lock() noexcept {}
+	bool try_lock() noexcept { return true; } // NOLINT(readability-convert-member-functions-to-static)
+	void unlock() noexcept {}
+
+	void lock_shared() noexcept {}
+	bool try_lock_shared() noexcept { return true; } // NOLINT(readability-convert-member-functions-to-static)
+	void unlock_shared() noexcept {}
+};
+
+template<typename Policy, typename Mutex>
+using policy_mutex_t = std::conditional_t<is_single_threaded<Policy>::value, null_mutex, Mutex>;
+
+} // namespace detail
+} // namespace channels
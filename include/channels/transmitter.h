@@ -40,13 +40,19 @@ public:
 	/// Constructs the `transmitter` object and initialize the channel with a shared state.
 	/// \param args Pass arguments to the channel's constructor.
 	template<typename... Args>
-	explicit transmitter(Args&&... args);
+	constexpr explicit transmitter(Args&&... args);
 
 	/// Sends args to the channel.
 	/// \note This method is thread safe.
 	template<typename... Args>
 	decltype(auto) send(Args&&... args);
 
+	/// Sends each element of the range to the channel.
+	/// \note This method is thread safe.
+	/// \see channels::channel::send_batch
+	template<typename Range>
+	decltype(auto) send_batch(Range&& values);
+
 	/// \return Reference to the channel object. This channel object is always valid.
 	/// \note This method is thread safe.
 	CHANNELS_NODISCARD const Channel& get_channel() const noexcept;
@@ -63,7 +69,7 @@ private:
 
 template<typename Channel>
 template<typename... Args>
-transmitter<Channel>::transmitter(Args&&... args)
+constexpr transmitter<Channel>::transmitter(Args&&... args)
 	: channel_{std::forward<Args>(args)...}
 {}
 
@@ -74,6 +80,13 @@ decltype(auto) transmitter<Channel>::send(Args&&... args)
 	return channel_.send(std::forward<Args>(args)...);
 }
 
+template<typename Channel>
+template<typename Range>
+decltype(auto) transmitter<Channel>::send_batch(Range&& values)
+{
+	return channel_.send_batch(std::forward<Range>(values));
+}
+
 template<typename Channel>
 const Channel& transmitter<Channel>::get_channel() const noexcept
 {
@@ -91,11 +104,18 @@ class transmitter<Channel>::transmit_channel : public Channel {
 public:
 	/// Constructs a `transmit_channel` object with a shared state.
 	template<typename... Args>
-	explicit transmit_channel(Args&&... args)
+	constexpr explicit transmit_channel(Args&&... args)
 		: base_type{typename base_type::make_shared_state_tag{}, std::forward<Args>(args)...}
 	{}
 
 	using Channel::send;
+
+	// it isn't a using-declaration because not all channels support batches
+	template<typename Range>
+	decltype(auto) send_batch(Range&& values)
+	{
+		return base_type::send_batch(std::forward<Range>(values));
+	}
 };
 
 } // namespace channels
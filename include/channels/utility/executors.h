@@ -1,7 +1,11 @@
 #pragma once
 #include "../detail/compatibility/compile_features.h"
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace channels {
 inline namespace utility {
@@ -81,6 +85,124 @@ make_tracking_executor(TrackedObject&& tracked_object, Executor&& executor = {})
 template<typename TrackedObject, typename Executor, typename Function>
 void execute(const tracking_executor<TrackedObject, Executor>& executor, Function&& task);
 
+// thread_pool_executor
+
+namespace executors_detail {
+
+// Type-erased move-only function object. Function objects that fit into the internal buffer (for example the tasks of
+// deferred callback functions) are stored in it, so wrapping them doesn't allocate memory.
+class task {
+public:
+	task() = default;
+
+	template<typename Function, typename = std::enable_if_t<!std::is_same<std::decay_t<Function>, task>::value>>
+	explicit task(Function&& function);
+
+	task(const task&) = delete;
+	task(task&& other) noexcept;
+	task& operator=(const task&) = delete;
+	task& operator=(task&& other) noexcept;
+
+	~task();
+
+	CHANNELS_NODISCARD explicit operator bool() const noexcept;
+
+	// \pre `static_cast<bool>(*this) == true`.
+	void operator()();
+
+private:
+	static constexpr std::size_t buffer_size = 6 * sizeof(void*);
+	using buffer_type = std::aligned_storage_t<buffer_size>;
+
+	struct operations {
+		void (*invoke)(buffer_type& buffer);
+		void (*relocate)(buffer_type& from, buffer_type& to);
+		void (*destroy)(buffer_type& buffer);
+	};
+
+	template<typename Function>
+	struct is_local
+		: std::integral_constant<
+			bool,
+			sizeof(Function) <= buffer_size && alignof(Function) <= alignof(buffer_type) &&
+				std::is_nothrow_move_constructible<Function>::value> {};
+
+	template<typename Function>
+	struct local_function;
+	template<typename Function>
+	struct heap_function;
+
+	template<typename Function>
+	CHANNELS_NODISCARD static const operations& get_operations() noexcept;
+
+	template<typename Function>
+	void emplace(Function&& function, std::true_type /*is_local*/);
+	template<typename Function>
+	void emplace(Function&& function, std::false_type /*is_local*/);
+
+	void reset() noexcept;
+
+	const operations* operations_{nullptr};
+	buffer_type buffer_;
+};
+
+} // namespace executors_detail
+
+/// The `thread_pool_executor` runs tasks in a pool of worker threads.
+/// Each worker has its own lock-free deque. The tasks added by a worker thread (for example by a callback function
+/// that sends to another channel) are pushed to the deque of this worker, and idle workers steal tasks from the deques
+/// of other workers. The tasks added by other threads are pushed to the shared queue.
+/// Tasks are type-erased with small-buffer storage, so adding the task of a deferred callback function doesn't
+/// allocate memory.
+/// If a task throws an exception then `std::terminate` is called.
+///
+/// Example:
+/// \code
+/// channels::utility::thread_pool_executor executor{4};
+/// ...
+/// const channels::connection connection = channel.connect(&executor, [](const int value) { ... });
+/// \endcode
+///
+/// \note The executor must outlive the connections that use it.
+class thread_pool_executor {
+public:
+	/// Creates the pool and starts the worker threads.
+	/// \param threads_number Number of worker threads. If it is zero then `std::thread::hardware_concurrency()` threads
+	///                       are created (at least one).
+	explicit thread_pool_executor(std::size_t threads_number = 0);
+
+	/// Creates the pool and binds the worker thread number `i` to the CPU number `cpus[i % cpus.size()]`.
+	/// If `cpus` is empty or the platform doesn't support thread affinity, the threads aren't bound.
+	/// \throw std::system_error if a thread can't be bound to the CPU.
+	thread_pool_executor(std::size_t threads_number, const std::vector<std::size_t>& cpus);
+
+	thread_pool_executor(const thread_pool_executor&) = delete;
+	thread_pool_executor(thread_pool_executor&&) = delete;
+	thread_pool_executor& operator=(const thread_pool_executor&) = delete;
+	thread_pool_executor& operator=(thread_pool_executor&&) = delete;
+
+	/// Waits until all added tasks are completed and joins the worker threads.
+	/// \note It must not be called from a worker thread.
+	~thread_pool_executor();
+
+	/// Returns the number of worker threads.
+	CHANNELS_NODISCARD std::size_t get_threads_number() const noexcept;
+
+	/// Adds the `task` to the pool.
+	template<typename Function>
+	void add(Function&& task);
+
+private:
+	struct shared_state;
+
+	void add_task(executors_detail::task task);
+
+	std::unique_ptr<shared_state> shared_state_;
+};
+
+template<typename Function>
+void execute(thread_pool_executor* executor, Function&& task);
+
 // implementation
 
 // inline_executor
@@ -137,5 +259,145 @@ void execute(const tracking_executor<TrackedObject, Executor>& executor, Functio
 	executor.add(std::forward<Function>(task));
 }
 
+// thread_pool_executor
+
+namespace executors_detail {
+
+template<typename Function, typename>
+task::task(Function&& function)
+{
+	emplace(std::forward<Function>(function), is_local<std::decay_t<Function>>{});
+}
+
+inline task::task(task&& other) noexcept
+	: operations_{other.operations_}
+{
+	if (operations_) {
+		operations_->relocate(other.buffer_, buffer_);
+		other.operations_ = nullptr;
+	}
+}
+
+inline task& task::operator=(task&& other) noexcept
+{
+	if (this != &other) {
+		reset();
+		if (other.operations_) {
+			other.operations_->relocate(other.buffer_, buffer_);
+			operations_ = std::exchange(other.operations_, nullptr);
+		}
+	}
+	return *this;
+}
+
+inline task::~task()
+{
+	reset();
+}
+
+inline task::operator bool() const noexcept
+{
+	return operations_ != nullptr;
+}
+
+inline void task::operator()()
+{
+	operations_->invoke(buffer_);
+}
+
+template<typename Function>
+struct task::local_function {
+	static Function& get(buffer_type& buffer) noexcept
+	{
+		return *static_cast<Function*>(static_cast<void*>(&buffer));
+	}
+
+	static void invoke(buffer_type& buffer)
+	{
+		get(buffer)();
+	}
+
+	static void relocate(buffer_type& from, buffer_type& to)
+	{
+		::new (static_cast<void*>(&to)) Function{std::move(get(from))};
+		destroy(from);
+	}
+
+	static void destroy(buffer_type& buffer)
+	{
+		get(buffer).~Function();
+	}
+};
+
+template<typename Function>
+struct task::heap_function {
+	static Function*& get(buffer_type& buffer) noexcept
+	{
+		return *static_cast<Function**>(static_cast<void*>(&buffer));
+	}
+
+	static void invoke(buffer_type& buffer)
+	{
+		(*get(buffer))();
+	}
+
+	static void relocate(buffer_type& from, buffer_type& to)
+	{
+		::new (static_cast<void*>(&to)) Function*{get(from)};
+	}
+
+	static void destroy(buffer_type& buffer)
+	{
+		delete get(buffer); // NOLINT(cppcoreguidelines-owning-memory)
+	}
+};
+
+template<typename Function>
+const task::operations& task::get_operations() noexcept
+{
+	static constexpr operations function_operations{&Function::invoke, &Function::relocate, &Function::destroy};
+	return function_operations;
+}
+
+template<typename Function>
+void task::emplace(Function&& function, std::true_type /*is_local*/)
+{
+	using function_type = std::decay_t<Function>;
+
+	::new (static_cast<void*>(&buffer_)) function_type{std::forward<Function>(function)};
+	operations_ = &get_operations<local_function<function_type>>();
+}
+
+template<typename Function>
+void task::emplace(Function&& function, std::false_type /*is_local*/)
+{
+	using function_type = std::decay_t<Function>;
+
+	::new (static_cast<void*>(&buffer_)) function_type*{new function_type{std::forward<Function>(function)}};
+	operations_ = &get_operations<heap_function<function_type>>();
+}
+
+inline void task::reset() noexcept
+{
+	if (operations_) {
+		operations_->destroy(buffer_);
+		operations_ = nullptr;
+	}
+}
+
+} // namespace executors_detail
+
+template<typename Function>
+void thread_pool_executor::add(Function&& task)
+{
+	add_task(executors_detail::task{std::forward<Function>(task)});
+}
+
+template<typename Function>
+void execute(thread_pool_executor* const executor, Function&& task)
+{
+	executor->add(std::forward<Function>(task));
+}
+
 } // namespace utility
 } // namespace channels
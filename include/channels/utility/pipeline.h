@@ -0,0 +1,272 @@
+#pragma once
+#include "../channel_traits.h"
+#include "../detail/compatibility/compile_features.h"
+#include "transponder.h"
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace channels {
+inline namespace utility {
+
+namespace pipeline_detail {
+
+// The type of channel reported by the intermediate stages.
+struct stage_channel {};
+
+template<typename T>
+struct is_tuple : std::false_type {};
+
+template<typename... Ts>
+struct is_tuple<std::tuple<Ts...>> : std::true_type {};
+
+template<typename Channel, typename... Args>
+struct into_tag {
+	std::tuple<Args...> args;
+};
+
+} // namespace pipeline_detail
+} // namespace utility
+
+// a tuple passed to the next stage is unpacked by `transform_adaptor`
+template<typename... Args>
+struct is_applicable<utility::pipeline_detail::stage_channel, Args...> : std::integral_constant<
+	bool,
+	!(sizeof...(Args) == 1 && utility::pipeline_detail::is_tuple<std::decay_t<Args>...>::value)>
+{};
+
+inline namespace utility {
+
+/// Adaptor that calls all `Adaptors` one after another in one callback function.
+/// \see channels::utility::pipeline
+template<typename... Adaptors>
+class fused_adaptor {
+public:
+	constexpr explicit fused_adaptor(std::tuple<Adaptors...> adaptors)
+		noexcept(std::is_nothrow_move_constructible<std::tuple<Adaptors...>>::value)
+		: adaptors_{std::move(adaptors)}
+	{}
+
+	template<typename Transmitter, typename... Args>
+	void operator()(Transmitter& transmitter, Args&&... args)
+	{
+		call(std::integral_constant<std::size_t, 0>{}, transmitter, std::forward<Args>(args)...);
+	}
+
+private:
+	static constexpr std::size_t size = sizeof...(Adaptors);
+
+	template<std::size_t Index, typename Transmitter>
+	class stage_transmitter;
+
+	// the last adaptor gets the real transmitter, so it can inspect the destination channel
+	template<std::size_t Index, typename Transmitter, typename... Args>
+	void call(std::integral_constant<std::size_t, Index>, Transmitter& transmitter, Args&&... args)
+	{
+		using is_last = std::integral_constant<bool, Index + 1 == size>;
+		call_adaptor<Index>(is_last{}, transmitter, std::forward<Args>(args)...);
+	}
+
+	// a pipeline without adaptors sends the values as they are
+	template<typename Transmitter, typename... Args>
+	void call(std::integral_constant<std::size_t, size>, Transmitter& transmitter, Args&&... args)
+	{
+		transmitter.send(std::forward<Args>(args)...);
+	}
+
+	template<std::size_t Index, typename Transmitter, typename... Args>
+	void call_adaptor(std::true_type, Transmitter& transmitter, Args&&... args)
+	{
+		std::get<Index>(adaptors_)(transmitter, std::forward<Args>(args)...);
+	}
+
+	template<std::size_t Index, typename Transmitter, typename... Args>
+	void call_adaptor(std::false_type, Transmitter& transmitter, Args&&... args)
+	{
+		stage_transmitter<Index + 1, Transmitter> next_stage{*this, transmitter};
+		std::get<Index>(adaptors_)(next_stage, std::forward<Args>(args)...);
+	}
+
+	std::tuple<Adaptors...> adaptors_;
+};
+
+/// The class `pipeline` connects a source channel to a destination channel through a chain of adaptors with the pipe
+/// syntax:
+/// \code
+/// channels::transmitter<channels::channel<order>> orders;
+/// const channels::transponder<channels::channel<double>> big_order_prices =
+/// 	orders.get_channel()
+/// 	| channels::utility::filter([](const order& o) { return o.quantity > 1000; })
+/// 	| channels::utility::transform([](const order& o) { return o.price; })
+/// 	| channels::utility::into<channels::channel<double>>();
+/// \endcode
+/// The adaptors are composed at compile time into one callback function of one `channels::utility::transponder`, so
+/// the values pass between the stages as function arguments instead of intermediate channels.
+/// Any adaptor of `transponder` can be a stage: an object that is invocable with a transmitter and the values.
+/// The intermediate stages pass their values to the next stage by calling `send` of the transmitter. A stage of
+/// `transform_adaptor` that returns a `std::tuple` passes the elements of the tuple as separate values.
+///
+/// The object of this class is the result of `channel | adaptor`. It keeps the source channel and the adaptors until
+/// the pipeline is completed by `channels::utility::into`.
+template<typename SourceChannel, typename... Adaptors>
+class pipeline {
+	static_assert(is_channel_v<SourceChannel>, "SourceChannel must be channel");
+
+public:
+	constexpr pipeline(SourceChannel source_channel, std::tuple<Adaptors...> adaptors)
+		: source_channel_{std::move(source_channel)}
+		, adaptors_{std::move(adaptors)}
+	{}
+
+	/// Adds the `adaptor` to the end of the pipeline.
+	template<typename Adaptor>
+	CHANNELS_NODISCARD pipeline<SourceChannel, Adaptors..., std::decay_t<Adaptor>> append(Adaptor&& adaptor) &&;
+
+	/// Connects the pipeline to the source channel.
+	/// \param args Arguments that pass to the transponder's transmitter.
+	/// \throw channel_error If the source channel isn't valid.
+	template<typename Channel, typename... Args>
+	CHANNELS_NODISCARD transponder<Channel> connect(Args&&... args) &&;
+
+private:
+	SourceChannel source_channel_;
+	std::tuple<Adaptors...> adaptors_;
+};
+
+/// Creates the stage of a pipeline that passes only the values for which `filter_predicate` returns true.
+/// \see channels::utility::filter_adaptor
+template<typename P>
+constexpr auto filter(P&& filter_predicate)
+	noexcept(std::is_nothrow_constructible<filter_adaptor<std::decay_t<P>>, P>::value)
+{
+	return make_filter_adaptor(std::forward<P>(filter_predicate));
+}
+
+/// Creates the stage of a pipeline that passes the result of `transform_function`.
+/// \see channels::utility::transform_adaptor
+template<typename F>
+constexpr auto transform(F&& transform_function)
+	noexcept(std::is_nothrow_constructible<transform_adaptor<std::decay_t<F>>, F>::value)
+{
+	return make_transform_adaptor(std::forward<F>(transform_function));
+}
+
+/// Completes a pipeline: `source | stages... | into<Channel>(args...)` returns a `transponder<Channel>`.
+/// \param args Arguments that pass to the transponder's transmitter.
+template<typename Channel, typename... Args>
+CHANNELS_NODISCARD pipeline_detail::into_tag<Channel, std::decay_t<Args>...> into(Args&&... args);
+
+/// Starts a pipeline from the `source_channel`.
+template<
+	typename SourceChannel,
+	typename Adaptor,
+	typename = std::enable_if_t<is_channel_v<SourceChannel>>>
+CHANNELS_NODISCARD pipeline<SourceChannel, std::decay_t<Adaptor>> operator|(
+	const SourceChannel& source_channel, Adaptor&& adaptor);
+
+/// Adds the `adaptor` to the end of the `pipeline`.
+template<typename SourceChannel, typename... Adaptors, typename Adaptor>
+CHANNELS_NODISCARD pipeline<SourceChannel, Adaptors..., std::decay_t<Adaptor>> operator|(
+	pipeline<SourceChannel, Adaptors...> pipeline, Adaptor&& adaptor);
+
+/// Connects the `pipeline` to its source channel and returns the destination transponder.
+template<typename SourceChannel, typename... Adaptors, typename Channel, typename... Args>
+CHANNELS_NODISCARD transponder<Channel> operator|(
+	pipeline<SourceChannel, Adaptors...> pipeline, pipeline_detail::into_tag<Channel, Args...> tag);
+
+/// Connects the `source_channel` to the destination transponder directly.
+template<
+	typename SourceChannel,
+	typename Channel,
+	typename... Args,
+	typename = std::enable_if_t<is_channel_v<SourceChannel>>>
+CHANNELS_NODISCARD transponder<Channel> operator|(
+	const SourceChannel& source_channel, pipeline_detail::into_tag<Channel, Args...> tag);
+
+// implementation
+
+// fused_adaptor::stage_transmitter
+
+template<typename... Adaptors>
+template<std::size_t Index, typename Transmitter>
+class fused_adaptor<Adaptors...>::stage_transmitter {
+public:
+	using channel_type = pipeline_detail::stage_channel;
+
+	constexpr stage_transmitter(fused_adaptor& adaptor, Transmitter& transmitter) noexcept
+		: adaptor_{adaptor}
+		, transmitter_{transmitter}
+	{}
+
+	template<typename... Args>
+	void send(Args&&... args)
+	{
+		adaptor_.call(std::integral_constant<std::size_t, Index>{}, transmitter_, std::forward<Args>(args)...);
+	}
+
+private:
+	fused_adaptor& adaptor_;
+	Transmitter& transmitter_;
+};
+
+// pipeline
+
+template<typename SourceChannel, typename... Adaptors>
+template<typename Adaptor>
+pipeline<SourceChannel, Adaptors..., std::decay_t<Adaptor>>
+pipeline<SourceChannel, Adaptors...>::append(Adaptor&& adaptor) &&
+{
+	return {
+		std::move(source_channel_),
+		std::tuple_cat(std::move(adaptors_), std::make_tuple(std::forward<Adaptor>(adaptor)))};
+}
+
+template<typename SourceChannel, typename... Adaptors>
+template<typename Channel, typename... Args>
+transponder<Channel> pipeline<SourceChannel, Adaptors...>::connect(Args&&... args) &&
+{
+	return transponder<Channel>{
+		source_channel_, fused_adaptor<Adaptors...>{std::move(adaptors_)}, std::forward<Args>(args)...};
+}
+
+// functions
+
+template<typename Channel, typename... Args>
+pipeline_detail::into_tag<Channel, std::decay_t<Args>...> into(Args&&... args)
+{
+	return {std::make_tuple(std::forward<Args>(args)...)};
+}
+
+template<typename SourceChannel, typename Adaptor, typename>
+pipeline<SourceChannel, std::decay_t<Adaptor>> operator|(const SourceChannel& source_channel, Adaptor&& adaptor)
+{
+	return {source_channel, std::make_tuple(std::forward<Adaptor>(adaptor))};
+}
+
+template<typename SourceChannel, typename... Adaptors, typename Adaptor>
+pipeline<SourceChannel, Adaptors..., std::decay_t<Adaptor>> operator|(
+	pipeline<SourceChannel, Adaptors...> pipeline, Adaptor&& adaptor)
+{
+	return std::move(pipeline).append(std::forward<Adaptor>(adaptor));
+}
+
+template<typename SourceChannel, typename... Adaptors, typename Channel, typename... Args>
+transponder<Channel> operator|(
+	pipeline<SourceChannel, Adaptors...> pipeline, pipeline_detail::into_tag<Channel, Args...> tag)
+{
+	return detail::compatibility::apply(
+		[&pipeline](auto&&... args) {
+			return std::move(pipeline).template connect<Channel>(std::forward<decltype(args)>(args)...);
+		},
+		std::move(tag.args));
+}
+
+template<typename SourceChannel, typename Channel, typename... Args, typename>
+transponder<Channel> operator|(const SourceChannel& source_channel, pipeline_detail::into_tag<Channel, Args...> tag)
+{
+	return pipeline<SourceChannel>{source_channel, std::tuple<>{}} | std::move(tag);
+}
+
+} // namespace utility
+} // namespace channels
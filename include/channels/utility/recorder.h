@@ -0,0 +1,436 @@
+#pragma once
+#include "../channel_traits.h"
+#include "../connection.h"
+#include "../detail/bounded_queue.h"
+#include "../detail/compatibility/apply.h"
+#include "../detail/compatibility/compile_features.h"
+#include "../detail/seqlock_value.h"
+#include "../detail/type_traits.h"
+#include "../detail/wake_signal.h"
+#include "../transmitter.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef CHANNELS_HAS_MMAP
+
+namespace channels {
+inline namespace utility {
+
+/// The codec for `channels::utility::recorder` and `channels::utility::replayer` that copies the bytes of trivially
+/// copyable values.
+/// A codec for other types must have the same interface: the type `value_type` (a `std::tuple` of the types of the
+/// channel) and the methods `encode` and `decode`.
+/// \note The log written by this codec can be read only on a host with the same data representation.
+template<typename... Ts>
+struct trivial_codec {
+	static_assert(detail::is_trivially_copyable<Ts...>::value, "trivial_codec requires trivially copyable types");
+
+	using value_type = std::tuple<Ts...>;
+
+	/// Appends the representation of the `value` to the `buffer`.
+	void encode(const value_type& value, std::vector<unsigned char>& buffer) const;
+
+	/// Restores the value from its representation.
+	/// \throw std::runtime_error If the `size` doesn't match the types.
+	CHANNELS_NODISCARD value_type decode(const unsigned char* data, std::size_t size) const;
+
+private:
+	static constexpr std::size_t size = detail::get_packed_offset<Ts...>(sizeof...(Ts));
+
+	template<std::size_t... Is>
+	static value_type decode(const unsigned char* data, std::index_sequence<Is...>) noexcept;
+	template<typename T>
+	static T read(const unsigned char* data) noexcept;
+};
+
+namespace recorder_detail {
+
+// Preallocated log file mapped to the memory. The file consists of the header and the records:
+// [magic: 4 bytes][version: 4 bytes][data size: 8 bytes] and [timestamp: 8 bytes][size: 4 bytes][data: size bytes].
+// The data size in the header is updated after each record, so a log of a crashed process contains complete records.
+class log_writer {
+public:
+	// Creates the file of `capacity` bytes. An existing file is truncated.
+	// \throw std::system_error If the file can't be created.
+	log_writer(const std::string& path, std::size_t capacity);
+
+	log_writer(const log_writer&) = delete;
+	log_writer(log_writer&&) = delete;
+	log_writer& operator=(const log_writer&) = delete;
+	log_writer& operator=(log_writer&&) = delete;
+
+	// Unmaps the file and truncates it to the written records.
+	~log_writer() noexcept;
+
+	// \return `false` if there is no space for the record in the file.
+	CHANNELS_NODISCARD bool append(std::uint64_t timestamp, const unsigned char* data, std::size_t size) noexcept;
+
+private:
+	int descriptor_;
+	std::size_t capacity_;
+	unsigned char* address_;
+	std::size_t size_;
+};
+
+struct log_record {
+	// nanoseconds since the recorder was created
+	std::uint64_t timestamp;
+	const unsigned char* data;
+	std::size_t size;
+};
+
+class log_reader {
+public:
+	// \throw std::system_error If the file can't be opened or it isn't a log.
+	explicit log_reader(const std::string& path);
+
+	log_reader(const log_reader&) = delete;
+	log_reader(log_reader&&) = delete;
+	log_reader& operator=(const log_reader&) = delete;
+	log_reader& operator=(log_reader&&) = delete;
+
+	~log_reader() noexcept;
+
+	// Reads the record at the `offset` and moves the `offset` to the next record. The first record has offset zero.
+	// \return `false` if there are no more records.
+	CHANNELS_NODISCARD bool read(std::size_t& offset, log_record& record) const noexcept;
+
+private:
+	std::size_t file_size_;
+	const unsigned char* address_;
+	std::size_t size_;
+};
+
+} // namespace recorder_detail
+
+/// The class `recorder` captures the values sent to a channel into a binary log file, so the traffic can be studied or
+/// replayed later by `channels::utility::replayer`.
+/// The recorder connects to the channel like a subscriber. The callback function only takes a timestamp and puts the
+/// values to a lock-free staging buffer; a writer thread of the recorder encodes them with the codec and appends them
+/// to the preallocated memory-mapped file. So recording doesn't block the senders: if the staging buffer or the file is
+/// full, the values are dropped and counted.
+/// The callback function is `noexcept`, so the recorder can be connected to the channels with `policy::nothrow`. The
+/// values that can't be copied to the staging buffer (their copy constructor throws) are dropped and counted too.
+///
+/// Example:
+/// \code
+/// channels::transmitter<channels::channel<int, double>> transmitter;
+/// {
+/// 	using codec_type = channels::utility::trivial_codec<int, double>;
+/// 	channels::utility::recorder<codec_type> recorder{transmitter.get_channel(), "traffic.log", 64 << 20};
+/// 	....
+/// }
+/// channels::utility::replayer<codec_type> replayer{"traffic.log"};
+/// replayer.replay(test_transmitter);
+/// \endcode
+///
+/// \tparam Codec The type of the codec. \see channels::utility::trivial_codec
+/// \note If the codec throws an exception then `std::terminate` is called.
+template<typename Codec>
+class recorder {
+public:
+	using codec_type = Codec;
+	using value_type = typename Codec::value_type;
+
+	/// Creates the log file and connects to the `channel`.
+	/// \param path Path of the log file. An existing file is overwritten.
+	/// \param capacity Size of the log file in bytes. The values that don't fit in it are dropped.
+	/// \param codec The codec that encodes values.
+	/// \param staging_capacity Number of values that can wait for the writer thread.
+	/// \throw std::system_error If the file can't be created.
+	/// \throw channel_error If `channel.is_valid() == false`.
+	template<typename Channel>
+	recorder(
+		const Channel& channel,
+		const std::string& path,
+		std::size_t capacity,
+		Codec codec = Codec{},
+		std::size_t staging_capacity = 1024);
+
+	recorder(const recorder&) = delete;
+	recorder(recorder&&) = delete;
+	recorder& operator=(const recorder&) = delete;
+	recorder& operator=(recorder&&) = delete;
+
+	/// Disconnects from the channel, writes the staged values and closes the log file.
+	~recorder();
+
+	/// Returns the number of values written to the log file.
+	/// \note This method is thread safe.
+	CHANNELS_NODISCARD std::size_t get_recorded_number() const noexcept;
+
+	/// Returns the number of values dropped because the staging buffer or the log file was full or the value couldn't
+	/// be copied.
+	/// \note This method is thread safe.
+	CHANNELS_NODISCARD std::size_t get_dropped_number() const noexcept;
+
+private:
+	static constexpr int spin_number = 64;
+
+	struct entry {
+		std::uint64_t timestamp;
+		value_type value;
+	};
+
+	struct shared_state {
+		explicit shared_state(const std::size_t staging_capacity)
+			: entries{staging_capacity}
+		{}
+
+		template<typename... Ts>
+		void stage(const Ts&... values) noexcept;
+
+		const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+		detail::bounded_queue<entry> entries;
+		// it wakes the writer thread
+		detail::wake_signal signal;
+		std::atomic<bool> is_stopped{false};
+		std::atomic<std::size_t> recorded_number{0};
+		std::atomic<std::size_t> dropped_number{0};
+	};
+
+	void write_entries(Codec& codec) noexcept;
+
+	// the callback function shares the state, so a late call after the disconnection is harmless
+	std::shared_ptr<shared_state> shared_state_;
+	recorder_detail::log_writer log_;
+	std::thread writer_thread_;
+	connection connection_;
+};
+
+/// Defines how `channels::utility::replayer` paces the values.
+enum class replay_pacing {
+	/// The intervals between the values are the same as they were recorded.
+	recorded,
+	/// The values are sent without pauses.
+	as_fast_as_possible,
+};
+
+/// The class `replayer` sends the values recorded by `channels::utility::recorder` to a transmitter again. It can be
+/// used to reproduce a problem or as a realistic load generator.
+/// \tparam Codec The type of the codec. It must be compatible with the codec of the recorder.
+template<typename Codec>
+class replayer {
+public:
+	using codec_type = Codec;
+	using value_type = typename Codec::value_type;
+
+	/// Opens the log file.
+	/// \throw std::system_error If the file can't be opened or it isn't a log of the recorder.
+	explicit replayer(const std::string& path, Codec codec = Codec{});
+
+	/// Sends all recorded values to the `transmitter` in the order of recording.
+	/// This method can be called several times, each call replays the whole log.
+	/// \return The number of sent values.
+	/// \throw Any exception thrown by the codec or by the transmitter.
+	template<typename Channel>
+	std::size_t replay(transmitter<Channel>& transmitter, replay_pacing pacing = replay_pacing::recorded);
+
+private:
+	recorder_detail::log_reader log_;
+	Codec codec_;
+};
+
+// implementation
+
+// trivial_codec
+
+template<typename... Ts>
+constexpr std::size_t trivial_codec<Ts...>::size;
+
+template<typename... Ts>
+void trivial_codec<Ts...>::encode(const value_type& value, std::vector<unsigned char>& buffer) const
+{
+	const std::size_t offset = buffer.size();
+	buffer.resize(offset + size);
+	unsigned char* bytes = buffer.data() + offset; // NOLINT
+	detail::compatibility::apply(
+		[&bytes](const Ts&... values) {
+			(void) bytes;
+			const int dummy[] = {0, (std::memcpy(bytes, &values, sizeof(Ts)), bytes += sizeof(Ts), 0)...}; // NOLINT
+			(void) dummy;
+		},
+		value);
+}
+
+template<typename... Ts>
+typename trivial_codec<Ts...>::value_type
+trivial_codec<Ts...>::decode(const unsigned char* const data, const std::size_t size) const
+{
+	if (size != trivial_codec::size)
+		throw std::runtime_error{"trivial_codec: record has wrong size"};
+
+	return decode(data, std::index_sequence_for<Ts...>{});
+}
+
+template<typename... Ts>
+template<std::size_t... Is>
+typename trivial_codec<Ts...>::value_type
+trivial_codec<Ts...>::decode(const unsigned char* const data, std::index_sequence<Is...>) noexcept
+{
+	(void) data;
+	return value_type{read<Ts>(data + detail::get_packed_offset<Ts...>(Is))...}; // NOLINT
+}
+
+template<typename... Ts>
+template<typename T>
+T trivial_codec<Ts...>::read(const unsigned char* const data) noexcept
+{
+	std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+	std::memcpy(&storage, data, sizeof(T));
+	return *reinterpret_cast<const T*>(&storage); // NOLINT
+}
+
+// recorder
+
+template<typename Codec>
+template<typename Channel>
+recorder<Codec>::recorder(
+	const Channel& channel,
+	const std::string& path,
+	const std::size_t capacity,
+	Codec codec,
+	const std::size_t staging_capacity)
+	: shared_state_{std::make_shared<shared_state>(staging_capacity)}
+	, log_{path, capacity}
+{
+	static_assert(is_channel_v<Channel>, "Channel must be channel");
+
+	writer_thread_ = std::thread{[this, codec = std::move(codec)]() mutable { write_entries(codec); }};
+	try {
+		connection_ = channel.connect(
+			[state = shared_state_](const auto&... values) noexcept { state->stage(values...); });
+	}
+	catch (...) {
+		shared_state_->is_stopped.store(true, std::memory_order_seq_cst);
+		shared_state_->signal.notify();
+		writer_thread_.join();
+		throw;
+	}
+}
+
+template<typename Codec>
+recorder<Codec>::~recorder()
+{
+	connection_.disconnect();
+	shared_state_->is_stopped.store(true, std::memory_order_seq_cst);
+	shared_state_->signal.notify();
+	writer_thread_.join();
+}
+
+template<typename Codec>
+std::size_t recorder<Codec>::get_recorded_number() const noexcept
+{
+	return shared_state_->recorded_number.load(std::memory_order_relaxed);
+}
+
+template<typename Codec>
+std::size_t recorder<Codec>::get_dropped_number() const noexcept
+{
+	return shared_state_->dropped_number.load(std::memory_order_relaxed);
+}
+
+template<typename Codec>
+template<typename... Ts>
+void recorder<Codec>::shared_state::stage(const Ts&... values) noexcept
+{
+	const auto elapsed = std::chrono::steady_clock::now() - start_time;
+	const auto timestamp =
+		static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+	// the sender mustn't get exceptions of the recorder, so a value that can't be copied is counted as dropped
+	bool is_pushed = false;
+	try {
+		entry staged_entry{timestamp, value_type{values...}};
+		is_pushed = entries.try_push(staged_entry);
+	}
+	catch (...) {
+	}
+	if (!is_pushed) {
+		dropped_number.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	signal.notify();
+}
+
+template<typename Codec>
+void recorder<Codec>::write_entries(Codec& codec) noexcept
+{
+	shared_state& state = *shared_state_;
+	std::vector<unsigned char> buffer;
+	entry staged_entry{};
+	for (;;) {
+		// the stop flag is read before the staging buffer is drained, so the values staged before the stop are written
+		const bool is_stopped = state.is_stopped.load(std::memory_order_seq_cst);
+		while (state.entries.try_pop(staged_entry)) {
+			buffer.clear();
+			codec.encode(staged_entry.value, buffer);
+			if (log_.append(staged_entry.timestamp, buffer.data(), buffer.size()))
+				state.recorded_number.fetch_add(1, std::memory_order_relaxed);
+			else
+				state.dropped_number.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (is_stopped)
+			return;
+
+		// the writer yields for a while before it falls asleep, so the senders of a busy channel don't wake it up by
+		// system calls
+		for (int i = 0; i < spin_number && state.entries.is_empty(); ++i)
+			std::this_thread::yield();
+
+		const std::uint32_t sequence = state.signal.prepare_wait();
+		if (state.entries.is_empty() && !state.is_stopped.load(std::memory_order_seq_cst))
+			state.signal.wait(sequence, nullptr);
+		state.signal.finish_wait();
+	}
+}
+
+// replayer
+
+template<typename Codec>
+replayer<Codec>::replayer(const std::string& path, Codec codec)
+	: log_{path}
+	, codec_{std::move(codec)}
+{}
+
+template<typename Codec>
+template<typename Channel>
+std::size_t replayer<Codec>::replay(transmitter<Channel>& transmitter, const replay_pacing pacing)
+{
+	const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+	std::size_t offset = 0;
+	std::size_t number = 0;
+	recorder_detail::log_record record{};
+	std::uint64_t first_timestamp = 0;
+	while (log_.read(offset, record)) {
+		if (number == 0)
+			first_timestamp = record.timestamp;
+		if (pacing == replay_pacing::recorded) {
+			std::this_thread::sleep_until(
+				start_time + std::chrono::nanoseconds{static_cast<std::int64_t>(record.timestamp - first_timestamp)});
+		}
+
+		detail::compatibility::apply(
+			[&transmitter](auto&&... values) { transmitter.send(std::forward<decltype(values)>(values)...); },
+			codec_.decode(record.data, record.size));
+		++number;
+	}
+
+	return number;
+}
+
+} // namespace utility
+} // namespace channels
+
+#endif
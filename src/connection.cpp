@@ -1,5 +1,9 @@
 #include "connection.h"
+#include "mailbox.h"
+#include "detail/connection_table.h"
+#include "detail/mailbox.h"
 #include "detail/shared_state_base.h"
+#include "detail/static_socket.h"
 #include <cassert>
 #include <utility>
 
@@ -8,10 +12,11 @@ namespace channels {
 // connection
 
 connection::connection(connection&& other) noexcept
-	: shared_state_{std::move(other.shared_state_)}
-	, socket_{other.socket_}
+	: table_{other.table_}
+	, index_{other.index_}
+	, generation_{other.generation_}
 {
-	other.socket_ = nullptr;
+	other.table_ = nullptr;
 }
 
 connection& connection::operator=(connection&& other) noexcept
@@ -21,9 +26,10 @@ connection& connection::operator=(connection&& other) noexcept
 
 	disconnect();
 
-	shared_state_ = std::move(other.shared_state_);
-	socket_ = other.socket_;
-	other.socket_ = nullptr;
+	table_ = other.table_;
+	index_ = other.index_;
+	generation_ = other.generation_;
+	other.table_ = nullptr;
 
 	return *this;
 }
@@ -35,27 +41,84 @@ connection::~connection() noexcept
 
 void connection::disconnect() noexcept
 {
-	if (!shared_state_)
+	if (!table_)
 		return;
 
-	assert(socket_); // NOLINT
-	shared_state_->remove(*socket_);
+	table_->erase({index_, generation_});
+	table_ = nullptr;
+}
+
+bool connection::is_connected() const noexcept
+{
+	return table_ != nullptr;
+}
+
+connection::connection(detail::shared_state_base& shared_state, const detail::socket_base& socket) noexcept
+	: table_{&shared_state.get_connection_table()}
+	, index_{socket.get_connection().index}
+	, generation_{socket.get_connection().generation}
+{
+	table_->add_reference();
+}
+
+// static_connection
+
+static_connection::static_connection(static_connection&& other) noexcept
+	: socket_{other.socket_}
+{
+	other.socket_ = nullptr;
+}
+
+static_connection& static_connection::operator=(static_connection&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	disconnect();
+
+	socket_ = other.socket_;
+	other.socket_ = nullptr;
+
+	return *this;
+}
+
+static_connection::~static_connection() noexcept
+{
+	disconnect();
+}
+
+void static_connection::disconnect() noexcept
+{
+	if (!socket_)
+		return;
 
-	shared_state_.reset();
+	socket_->retire();
 	socket_ = nullptr;
 }
 
-bool connection::is_connected() const noexcept
+bool static_connection::is_connected() const noexcept
 {
-	return static_cast<bool>(shared_state_);
+	return socket_ != nullptr;
 }
 
-connection::connection(
-	std::shared_ptr<detail::shared_state_base> shared_state, detail::socket_base& socket) noexcept
-	: shared_state_{std::move(shared_state)}
-	, socket_{&socket}
+static_connection::static_connection(detail::static_socket_base& socket) noexcept
+	: socket_{&socket}
+{}
+
+// mailbox_connection
+
+mailbox_statistics mailbox_connection::get_mailbox_statistics() const noexcept
 {
-	assert(shared_state_); // NOLINT
+	if (!counters_)
+		return {};
+
+	return counters_->get_statistics();
 }
 
+mailbox_connection::mailbox_connection(
+	connection base, std::shared_ptr<const detail::mailbox_counters> counters) noexcept
+	: connection{std::move(base)}
+	, counters_{std::move(counters)}
+{}
+
 } // namespace channels
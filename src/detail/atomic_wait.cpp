@@ -0,0 +1,152 @@
+#include "detail/atomic_wait.h"
+#ifdef __linux__
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace channels {
+namespace detail {
+
+#ifdef __linux__
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex requires a plain 32-bit word");
+
+namespace {
+
+bool futex_wait(
+	const std::atomic<std::uint32_t>& value,
+	const std::uint32_t expected,
+	const std::chrono::steady_clock::time_point* const deadline,
+	const int operation) noexcept
+{
+	timespec timeout{};
+	timespec* timeout_pointer = nullptr;
+	if (deadline) {
+		const auto remaining = *deadline - std::chrono::steady_clock::now();
+		if (remaining <= std::chrono::steady_clock::duration::zero())
+			return false;
+
+		const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+		timeout.tv_sec = static_cast<std::time_t>(seconds.count());
+		timeout.tv_nsec = static_cast<long>(std::chrono::nanoseconds{remaining - seconds}.count()); // NOLINT
+		timeout_pointer = &timeout;
+	}
+
+	// the relative timeout of FUTEX_WAIT is measured by the monotonic clock like std::chrono::steady_clock
+	const long result = syscall(SYS_futex, &value, operation, expected, timeout_pointer, nullptr, 0); // NOLINT
+	return !(result == -1 && errno == ETIMEDOUT);
+}
+
+} // namespace
+
+bool atomic_wait(
+	const std::atomic<std::uint32_t>& value,
+	const std::uint32_t expected,
+	const std::chrono::steady_clock::time_point* const deadline) noexcept
+{
+	return futex_wait(value, expected, deadline, FUTEX_WAIT_PRIVATE);
+}
+
+void atomic_notify_all(std::atomic<std::uint32_t>& value) noexcept
+{
+	syscall(SYS_futex, &value, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0); // NOLINT
+}
+
+bool atomic_wait_shared(
+	const std::atomic<std::uint32_t>& value,
+	const std::uint32_t expected,
+	const std::chrono::steady_clock::time_point* const deadline) noexcept
+{
+	// without the private flag the futex is identified by the physical page, so it works for shared mappings
+	return futex_wait(value, expected, deadline, FUTEX_WAIT);
+}
+
+void atomic_notify_all_shared(std::atomic<std::uint32_t>& value) noexcept
+{
+	syscall(SYS_futex, &value, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0); // NOLINT
+}
+
+#else
+
+namespace {
+
+// Waiters are distributed over a fixed number of condition variables by the address of the value.
+struct wait_bucket {
+	std::mutex mutex;
+	std::condition_variable condition;
+};
+
+wait_bucket& get_wait_bucket(const void* const address) noexcept
+{
+	static std::array<wait_bucket, 16> buckets;
+	return buckets[std::hash<const void*>{}(address) % buckets.size()];
+}
+
+} // namespace
+
+bool atomic_wait(
+	const std::atomic<std::uint32_t>& value,
+	const std::uint32_t expected,
+	const std::chrono::steady_clock::time_point* const deadline) noexcept
+{
+	wait_bucket& bucket = get_wait_bucket(&value);
+	std::unique_lock<std::mutex> lock{bucket.mutex};
+	if (value.load(std::memory_order_acquire) != expected)
+		return true;
+
+	if (!deadline) {
+		bucket.condition.wait(lock);
+		return true;
+	}
+
+	return bucket.condition.wait_until(lock, *deadline) == std::cv_status::no_timeout;
+}
+
+void atomic_notify_all(std::atomic<std::uint32_t>& value) noexcept
+{
+	wait_bucket& bucket = get_wait_bucket(&value);
+	{
+		// the waiter either hasn't checked the value yet or already waits on the condition variable
+		const std::lock_guard<std::mutex> lock{bucket.mutex};
+	}
+	bucket.condition.notify_all();
+}
+
+bool atomic_wait_shared(
+	const std::atomic<std::uint32_t>& value,
+	const std::uint32_t expected,
+	const std::chrono::steady_clock::time_point* const deadline) noexcept
+{
+	// the condition variables aren't shared between processes, so the waiter polls the value
+	if (value.load(std::memory_order_acquire) != expected)
+		return true;
+
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (deadline && now >= *deadline)
+		return false;
+
+	std::chrono::steady_clock::time_point wake_time = now + std::chrono::milliseconds{1};
+	if (deadline && *deadline < wake_time)
+		wake_time = *deadline;
+	std::this_thread::sleep_until(wake_time);
+	return true;
+}
+
+void atomic_notify_all_shared(std::atomic<std::uint32_t>&) noexcept
+{}
+
+#endif
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,117 @@
+#include "detail/connection_table.h"
+#include "detail/shared_state_base.h"
+#include <cassert>
+#include <new>
+
+namespace channels {
+namespace detail {
+
+constexpr std::uint32_t connection_table::no_entry;
+
+connection_table* connection_table::create(shared_state_base& shared_state, const bool is_single_threaded)
+{
+	return new connection_table{shared_state, is_single_threaded}; // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+connection_table::connection_table(shared_state_base& shared_state, const bool is_single_threaded) noexcept
+	: is_single_threaded_{is_single_threaded}
+	, shared_state_{&shared_state}
+{}
+
+void connection_table::add_reference() noexcept
+{
+	if (is_single_threaded_)
+		references_count_.store(references_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	else
+		references_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void connection_table::remove_reference() noexcept
+{
+	assert(references_count_.load(std::memory_order_relaxed) > 0); // NOLINT
+	std::size_t references_count = 0;
+	if (is_single_threaded_) {
+		references_count = references_count_.load(std::memory_order_relaxed);
+		references_count_.store(references_count - 1, std::memory_order_relaxed);
+	}
+	else {
+		references_count = references_count_.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	if (references_count == 1)
+		delete this; // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+connection_table::unique_lock_type connection_table::lock()
+{
+	if (is_single_threaded_)
+		return unique_lock_type{mutex_, std::defer_lock};
+
+	return unique_lock_type{mutex_};
+}
+
+connection_table::unique_lock_type connection_table::try_lock()
+{
+	if (is_single_threaded_)
+		return unique_lock_type{mutex_, std::defer_lock};
+
+	return unique_lock_type{mutex_, std::try_to_lock};
+}
+
+connection_table::handle connection_table::insert(socket_base& socket, const unique_lock_type& lock)
+{
+	assert(is_single_threaded_ || lock.owns_lock()); // NOLINT
+	(void) lock;
+
+	if (free_entries_ == no_entry) {
+		if (entries_.size() == no_entry)
+			throw std::bad_alloc{};
+
+		entries_.push_back(entry{nullptr, 0, no_entry});
+		free_entries_ = static_cast<std::uint32_t>(entries_.size() - 1);
+	}
+
+	entry& free_entry = entries_[free_entries_];
+	const handle result{free_entries_, free_entry.generation};
+	free_entries_ = free_entry.next_free;
+	free_entry.socket = &socket;
+	free_entry.next_free = no_entry;
+
+	return result;
+}
+
+void connection_table::erase(const handle connection) noexcept
+{
+	{
+		retired_list reclaimed; // deleted after the mutex is unlocked because it can destroy callbacks
+		const unique_lock_type table_lock = lock();
+
+		assert(connection.index < entries_.size()); // NOLINT
+		entry& connection_entry = entries_[connection.index];
+		// each handle is erased once, so its generation matches unless the handle is corrupted
+		assert(connection_entry.generation == connection.generation && connection_entry.socket); // NOLINT
+		if (connection_entry.generation == connection.generation) {
+			// the sockets of the detached shared state are destroyed with it
+			if (shared_state_)
+				reclaimed = shared_state_->remove(*connection_entry.socket, table_lock);
+
+			++connection_entry.generation;
+			connection_entry.socket = nullptr;
+			connection_entry.next_free = free_entries_;
+			free_entries_ = connection.index;
+		}
+	}
+
+	remove_reference();
+}
+
+void connection_table::detach(const unique_lock_type& lock) noexcept
+{
+	assert(is_single_threaded_ || lock.owns_lock()); // NOLINT
+	(void) lock;
+
+	shared_state_ = nullptr;
+}
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,219 @@
+#include "detail/epoch_reclamation.h"
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace channels {
+namespace detail {
+
+// Pin of one reader. The records are linked to the list of the domain once and deleted with the domain, so the list
+// can be traversed without locks.
+struct epoch_domain::record {
+	static constexpr std::uint64_t pinned_flag = 1;
+
+	// epoch observed by the reader shifted by one bit and the flag `pinned`, zero if the record is free
+	std::atomic<std::uint64_t> state{0};
+	record* next{nullptr};
+};
+
+constexpr std::uint64_t epoch_domain::record::pinned_flag;
+
+namespace {
+
+struct cached_record {
+	std::uint64_t domain_id;
+	epoch_domain::record* record;
+};
+
+constexpr std::size_t record_cache_size = 8;
+
+std::atomic<std::uint64_t> next_domain_id{1}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// the domain identifiers aren't reused, so a record of a destroyed domain is never taken from the cache
+thread_local std::array<cached_record, record_cache_size> record_cache{}; // NOLINT
+
+} // namespace
+
+// epoch_domain
+
+epoch_domain::epoch_domain() noexcept
+	: id_{next_domain_id.fetch_add(1, std::memory_order_relaxed)}
+{}
+
+epoch_domain::~epoch_domain() noexcept
+{
+	record* pin = records_.load(std::memory_order_relaxed);
+	while (pin) {
+		assert(pin->state.load(std::memory_order_relaxed) == 0); // NOLINT
+		record* const next = pin->next;
+		delete pin; // NOLINT(cppcoreguidelines-owning-memory)
+		pin = next;
+	}
+}
+
+epoch_domain::record& epoch_domain::pin()
+{
+	cached_record& cached = record_cache[id_ % record_cache_size]; // NOLINT
+	if (cached.domain_id == id_ && try_claim(*cached.record))
+		return *cached.record;
+
+	record& result = acquire_record();
+	cached = cached_record{id_, &result};
+	return result;
+}
+
+void epoch_domain::unpin(record& pin) noexcept
+{
+	assert((pin.state.load(std::memory_order_relaxed) & record::pinned_flag) != 0); // NOLINT
+	pin.state.store(0, std::memory_order_release);
+}
+
+std::uint64_t epoch_domain::get_epoch() const noexcept
+{
+	// the object must be unlinked before its epoch is taken
+	return epoch_.load(std::memory_order_seq_cst);
+}
+
+std::uint64_t epoch_domain::try_advance() noexcept
+{
+	const std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+
+	for (const record* pin = records_.load(std::memory_order_seq_cst); pin; pin = pin->next) {
+		const std::uint64_t state = pin->state.load(std::memory_order_seq_cst);
+		if ((state & record::pinned_flag) != 0 && (state >> 1) != epoch)
+			return epoch;
+	}
+
+	std::uint64_t expected = epoch;
+	if (epoch_.compare_exchange_strong(expected, epoch + 1, std::memory_order_seq_cst))
+		return epoch + 1;
+
+	return expected;
+}
+
+bool epoch_domain::try_claim(record& pin) noexcept
+{
+	if (pin.state.load(std::memory_order_relaxed) != 0)
+		return false;
+
+	// the epoch can be stale at the exchange, which only delays the advance; the pin must be visible to the writers
+	// before the reader loads pointers to shared objects, so the exchange is sequentially consistent
+	std::uint64_t state = 0;
+	return pin.state.compare_exchange_strong(
+		state, (epoch_.load(std::memory_order_relaxed) << 1) | record::pinned_flag, std::memory_order_seq_cst);
+}
+
+epoch_domain::record& epoch_domain::acquire_record()
+{
+	for (record* pin = records_.load(std::memory_order_acquire); pin; pin = pin->next) {
+		if (try_claim(*pin))
+			return *pin;
+	}
+
+	auto* const pin = new record{}; // NOLINT(cppcoreguidelines-owning-memory)
+	pin->state.store((epoch_.load(std::memory_order_relaxed) << 1) | record::pinned_flag, std::memory_order_relaxed);
+	// the record must be visible to the writers before the reader loads pointers to shared objects
+	pin->next = records_.load(std::memory_order_relaxed);
+	while (!records_.compare_exchange_weak(pin->next, pin, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+	}
+	return *pin;
+}
+
+// retired_node
+
+retired_node::retired_node(const reclaim_function_type reclaim) noexcept
+	: reclaim_{reclaim}
+{
+	assert(reclaim_); // NOLINT
+}
+
+// retired_list
+
+retired_list::retired_list(retired_list&& other) noexcept
+	: first_{other.first_}
+	, last_{other.last_}
+{
+	other.first_ = nullptr;
+	other.last_ = nullptr;
+}
+
+retired_list& retired_list::operator=(retired_list&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	clear();
+
+	first_ = other.first_;
+	last_ = other.last_;
+	other.first_ = nullptr;
+	other.last_ = nullptr;
+
+	return *this;
+}
+
+retired_list::~retired_list() noexcept
+{
+	clear();
+}
+
+bool retired_list::empty() const noexcept
+{
+	return first_ == nullptr;
+}
+
+void retired_list::push(retired_node& node, const std::uint64_t epoch) noexcept
+{
+	assert(!last_ || last_->retire_epoch_ <= epoch); // NOLINT
+	node.retire_epoch_ = epoch;
+	node.next_ = nullptr;
+
+	if (last_)
+		last_->next_ = &node;
+	else
+		first_ = &node;
+	last_ = &node;
+}
+
+retired_list retired_list::take_reclaimable(const std::uint64_t epoch) noexcept
+{
+	retired_list result;
+	if (!first_ || !epoch_domain::is_reclaimable(first_->retire_epoch_, epoch))
+		return result;
+
+	// the nodes are retired in order of epochs, so the reclaimable ones are at the head of the list
+	retired_node* last_reclaimed = first_;
+	while (last_reclaimed->next_ && epoch_domain::is_reclaimable(last_reclaimed->next_->retire_epoch_, epoch))
+		last_reclaimed = last_reclaimed->next_;
+
+	result.first_ = first_;
+	result.last_ = last_reclaimed;
+	first_ = last_reclaimed->next_;
+	last_reclaimed->next_ = nullptr;
+	if (!first_)
+		last_ = nullptr;
+
+	return result;
+}
+
+retired_list retired_list::take_all() noexcept
+{
+	return std::move(*this);
+}
+
+void retired_list::clear() noexcept
+{
+	retired_node* node = first_;
+	first_ = nullptr;
+	last_ = nullptr;
+
+	while (node) {
+		retired_node* const next = node->next_;
+		node->reclaim_(*node);
+		node = next;
+	}
+}
+
+} // namespace detail
+} // namespace channels
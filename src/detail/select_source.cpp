@@ -0,0 +1,39 @@
+#include "detail/select_source.h"
+#include <algorithm>
+
+namespace channels {
+namespace detail {
+
+// select_source
+
+void select_source::add_selector(wake_signal& notifier)
+{
+	const std::lock_guard<std::mutex> lock{selectors_mutex_};
+	selectors_.push_back(&notifier);
+	selectors_number_.store(selectors_.size(), std::memory_order_seq_cst);
+}
+
+void select_source::remove_selector(wake_signal& notifier) noexcept
+{
+	const std::lock_guard<std::mutex> lock{selectors_mutex_};
+	const auto it = std::find(selectors_.begin(), selectors_.end(), &notifier);
+	if (it == selectors_.end())
+		return;
+
+	selectors_.erase(it);
+	selectors_number_.store(selectors_.size(), std::memory_order_seq_cst);
+}
+
+void select_source::notify_selectors() noexcept
+{
+	// the common case without selectors doesn't take the lock
+	if (selectors_number_.load(std::memory_order_seq_cst) == 0)
+		return;
+
+	const std::lock_guard<std::mutex> lock{selectors_mutex_};
+	for (wake_signal* const notifier : selectors_)
+		notifier->notify();
+}
+
+} // namespace detail
+} // namespace channels
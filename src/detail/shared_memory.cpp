@@ -0,0 +1,142 @@
+#include "detail/shared_memory.h"
+
+#ifdef CHANNELS_HAS_SHARED_MEMORY
+
+#include "error.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace channels {
+namespace detail {
+
+namespace {
+
+// Closes the descriptor when the mapping is done (the mapping stays valid).
+class descriptor_guard {
+public:
+	explicit descriptor_guard(const int descriptor) noexcept
+		: descriptor_{descriptor}
+	{}
+
+	descriptor_guard(const descriptor_guard&) = delete;
+	descriptor_guard& operator=(const descriptor_guard&) = delete;
+
+	~descriptor_guard() noexcept
+	{
+		close(descriptor_);
+	}
+
+private:
+	int descriptor_;
+};
+
+} // namespace
+
+shared_memory::shared_memory(create_tag, std::string name, const std::size_t size)
+	: name_{std::move(name)}
+	, size_{size}
+	, is_owner_{true}
+{
+	// the old object may be left by a crashed process, so it is replaced instead of being reused
+	shm_unlink(name_.c_str());
+	const int descriptor = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR); // NOLINT
+	if (descriptor == -1)
+		throw channel_error{"shared_memory: can't create object"};
+
+	const descriptor_guard guard{descriptor};
+	struct stat status{};
+	if (fstat(descriptor, &status) == -1) {
+		shm_unlink(name_.c_str());
+		throw channel_error{"shared_memory: can't create object"};
+	}
+	device_ = static_cast<std::uint64_t>(status.st_dev);
+	inode_ = static_cast<std::uint64_t>(status.st_ino);
+
+	if (ftruncate(descriptor, static_cast<off_t>(size_)) == -1) {
+		unlink();
+		throw channel_error{"shared_memory: can't resize object"};
+	}
+	try {
+		map(descriptor);
+	}
+	catch (...) {
+		unlink();
+		throw;
+	}
+}
+
+shared_memory::shared_memory(std::string name, const std::size_t size)
+	: name_{std::move(name)}
+	, size_{size}
+	, is_owner_{false}
+{
+	const int descriptor = shm_open(name_.c_str(), O_RDWR, 0); // NOLINT
+	if (descriptor == -1)
+		throw channel_error{"shared_memory: can't open object"};
+
+	const descriptor_guard guard{descriptor};
+	struct stat status{};
+	if (fstat(descriptor, &status) == -1 || status.st_size < static_cast<off_t>(size_))
+		throw channel_error{"shared_memory: object has wrong size"};
+
+	map(descriptor);
+}
+
+shared_memory::~shared_memory() noexcept
+{
+	munmap(address_, size_);
+	if (is_owner_)
+		unlink();
+}
+
+void* shared_memory::get_address() const noexcept
+{
+	return address_;
+}
+
+void shared_memory::map(const int descriptor)
+{
+	void* const address = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	if (address == MAP_FAILED) // NOLINT
+		throw channel_error{"shared_memory: can't map object"};
+
+	address_ = address;
+}
+
+void shared_memory::unlink() const noexcept
+{
+	// a creator with the same name may have replaced the object, its object mustn't be removed
+	const int descriptor = shm_open(name_.c_str(), O_RDONLY, 0); // NOLINT
+	if (descriptor == -1)
+		return;
+
+	struct stat status{};
+	{
+		const descriptor_guard guard{descriptor};
+		if (fstat(descriptor, &status) == -1)
+			return;
+	}
+	if (static_cast<std::uint64_t>(status.st_dev) == device_ && static_cast<std::uint64_t>(status.st_ino) == inode_)
+		shm_unlink(name_.c_str());
+}
+
+std::int64_t get_process_id() noexcept
+{
+	return static_cast<std::int64_t>(getpid());
+}
+
+bool is_process_alive(const std::int64_t id) noexcept
+{
+	// the signal 0 only checks the process, EPERM means that it exists but belongs to another user
+	return kill(static_cast<pid_t>(id), 0) == 0 || errno != ESRCH;
+}
+
+} // namespace detail
+} // namespace channels
+
+#endif
@@ -1,5 +1,9 @@
 #include "detail/shared_state_base.h"
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <new>
+#include <thread>
 #include <utility>
 
 namespace channels {
@@ -7,6 +11,10 @@ namespace detail {
 
 // socket_base
 
+socket_base::socket_base() noexcept
+	: retired_node{&socket_base::reclaim}
+{}
+
 void socket_base::set_blocked(const bool blocked) noexcept
 {
 	blocked_.store(blocked, std::memory_order_relaxed);
@@ -17,70 +25,377 @@ bool socket_base::is_blocked() const noexcept
 	return blocked_.load(std::memory_order_relaxed);
 }
 
+int socket_base::get_priority() const noexcept
+{
+	return priority_;
+}
+
+connection_table::handle socket_base::get_connection() const noexcept
+{
+	return connection_;
+}
+
 void socket_base::add_reference() noexcept
 {
-	++references_count_;
+	references_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void socket_base::remove_reference() noexcept
+{
+	assert(references_count_.load(std::memory_order_relaxed) > 0); // NOLINT
+	if (references_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		assert(destroy_); // NOLINT
+		destroy_(*this);
+	}
+}
+
+void socket_base::reclaim(retired_node& node)
+{
+	// the reference of the shared state is released when no sender can access the disconnected socket
+	static_cast<socket_base&>(node).remove_reference();
+}
+
+// sockets_snapshot
+
+sockets_snapshot::pointer sockets_snapshot::make(const sockets_snapshot* const sockets, socket_base& added)
+{
+	const iterator first = sockets ? sockets->begin() : iterator{};
+	const iterator end = sockets ? sockets->end() : iterator{};
+	const auto new_size = static_cast<size_type>(std::distance(first, end)) + 1;
+
+	void* const memory = ::operator new(sizeof(sockets_snapshot) + new_size * sizeof(value_type));
+	pointer result{new (memory) sockets_snapshot{new_size}};
+
+	// the sockets are sorted by priority, so the position is found on connection instead of on each sending
+	const iterator position = std::find_if(first, end, [&added](const socket_base& socket) noexcept {
+		return socket.get_priority() < added.get_priority();
+	});
+
+	// the erased entries are skipped by the iterators, so the new array has none of them
+	value_type* last = result->mutable_data();
+	const auto construct = [&last](socket_base& socket) noexcept {
+		new (last++) value_type{socket}; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	};
+	std::for_each(first, position, construct);
+	construct(added);
+	std::for_each(position, end, construct);
+	assert(last == result->data() + new_size); // NOLINT
+
+	return result;
+}
+
+sockets_snapshot::sockets_snapshot(const size_type size) noexcept
+	: retired_node{&sockets_snapshot::reclaim}
+	, size_{size}
+{}
+
+void sockets_snapshot::erase(const socket_base& socket) noexcept
+{
+	value_type* const first = mutable_data();
+	value_type* const entry = std::find_if(first, first + size_, [&socket](const value_type& item) noexcept { // NOLINT
+		return item.socket == &socket && item.erasure.load(std::memory_order_relaxed) == 0;
+	});
+	assert(entry != first + size_); // NOLINT
+
+	// the entry is stamped before the number is published, so the iterators created after that skip it
+	const size_type erasure = erasures_number_.load(std::memory_order_relaxed) + 1;
+	entry->erasure.store(erasure, std::memory_order_release);
+	erasures_number_.store(erasure, std::memory_order_release);
+}
+
+void sockets_snapshot::reclaim(retired_node& node)
+{
+	deleter{}(static_cast<sockets_snapshot*>(&node));
 }
 
-size_t socket_base::remove_reference() noexcept
+void sockets_snapshot::deleter::operator()(sockets_snapshot* const snapshot) const noexcept
 {
-	assert(references_count_ > 0); // NOLINT
-	return --references_count_;
+	snapshot->~sockets_snapshot();
+	::operator delete(snapshot);
+}
+
+sockets_snapshot::size_type sockets_snapshot::size() const noexcept
+{
+	return size_;
+}
+
+const sockets_snapshot::value_type* sockets_snapshot::data() const noexcept
+{
+	// the array of sockets is placed right after the header in the same memory block
+	return reinterpret_cast<const value_type*>(this + 1); // NOLINT
+}
+
+sockets_snapshot::value_type* sockets_snapshot::mutable_data() noexcept
+{
+	return reinterpret_cast<value_type*>(this + 1); // NOLINT
+}
+
+sockets_snapshot::iterator sockets_snapshot::begin() const noexcept
+{
+	const value_type* const first = data();
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return iterator{first, first + size_, erasures_number_.load(std::memory_order_acquire)};
+}
+
+sockets_snapshot::iterator sockets_snapshot::end() const noexcept
+{
+	const value_type* const last = data() + size_; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return iterator{last, last, 0};
 }
 
 // shared_state_base
 
-void channels::detail::shared_state_base::remove(socket_base& socket)
+shared_state_base::shared_state_base(const bool is_single_threaded)
+	: socket_pool_{socket_pool::create(is_single_threaded)}
+	, connection_table_{nullptr}
+	, is_single_threaded_{is_single_threaded}
 {
+	try {
+		connection_table_ = connection_table::create(*this, is_single_threaded);
+	}
+	catch (...) {
+		socket_pool_->remove_reference();
+		throw;
+	}
+}
+
+shared_state_base::~shared_state_base() noexcept
+{
+	// the senders keep the shared state alive, so the retired snapshots are deleted with it
+	assert(readers_number_ == 0); // NOLINT
+	clear(sockets_);
+
+	// the pool is deleted here only if all sockets are destroyed, otherwise the last of them deletes it
+	socket_pool_->remove_reference();
+	// the connections that outlive the shared state keep the table alive until they are disconnected
+	connection_table_->remove_reference();
+}
+
+retired_list shared_state_base::remove(socket_base& socket, const sockets_unique_lock_type& sockets_lock)
+{
+	assert(is_single_threaded_ || sockets_lock.owns_lock()); // NOLINT
+	check_thread();
 	socket.set_blocked(true);
 
-	const sockets_unique_lock_type sockets_lock{sockets_mutex_};
-	remove_reference(socket, sockets_lock);
+	assert(socket.slot_); // NOLINT
+	sockets_snapshot* const current_sockets = socket.slot_->load();
+	assert(current_sockets); // NOLINT
+	// the senders that have started before the erasure can still use the socket until it is reclaimed
+	current_sockets->erase(socket);
+	retire(socket, sockets_lock);
+
+	--sockets_number_;
+	statistics_.update_subscribers_number(sockets_number_);
+	return collect_retired(sockets_lock);
+}
+
+void shared_state_base::add(socket_pointer<socket_base> socket, const int priority)
+{
+	add(sockets_, std::move(socket), priority);
+}
+
+void shared_state_base::add(sockets_slot& sockets, socket_pointer<socket_base> socket, const int priority)
+{
+	assert(socket); // NOLINT
+	socket->priority_ = priority;
+	socket->slot_ = &sockets;
+
+	retired_list reclaimed; // deleted after the mutex is unlocked because it can destroy callbacks
+	const sockets_unique_lock_type sockets_lock = lock_sockets();
+
+	snapshot_pointer new_sockets = sockets_snapshot::make(sockets.load(), *socket);
+	socket->connection_ = connection_table_->insert(*socket, sockets_lock);
+	// from now on the socket is owned by the shared state
+	static_cast<void>(socket.release());
+
+	++sockets_number_;
+	publish(sockets, std::move(new_sockets), sockets_lock);
+	reclaimed = collect_retired(sockets_lock);
+}
+
+connection_table& shared_state_base::get_connection_table() noexcept
+{
+	return *connection_table_;
+}
+
+statistics& shared_state_base::get_statistics() noexcept
+{
+	return statistics_;
 }
 
-void shared_state_base::add(std::shared_ptr<socket_base> socket)
+channel_statistics shared_state_base::get_statistics_snapshot()
 {
-	sockets_unique_lock_type sockets_lock{sockets_mutex_};
-	sockets_.push_back(std::move(socket));
+	channel_statistics result;
+	statistics_.fill(result);
+	const sockets_shared_view sockets = get_sockets();
+	result.subscribers_number = static_cast<std::size_t>(std::distance(sockets.begin(), sockets.end()));
+	return result;
 }
 
 sockets_shared_view shared_state_base::get_sockets()
 {
-	sockets_shared_lock_type sockets_lock{sockets_mutex_};
-	for (intrusive_list::node& socket : sockets_)
-		static_cast<socket_base&>(socket).add_reference(); // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
+	return get_sockets(sockets_);
+}
+
+sockets_shared_view shared_state_base::get_sockets(const sockets_slot& sockets)
+{
+	epoch_domain::record* const pin = lock_shared();
+	return sockets_shared_view{*this, sockets.load(), pin};
+}
+
+void shared_state_base::clear(sockets_slot& sockets) noexcept
+{
+	{
+		const sockets_unique_lock_type sockets_lock = connection_table_->lock();
+		connection_table_->detach(sockets_lock);
+	}
+
+	// it is called only when there are no senders so the snapshot can be deleted right now
+	const snapshot_pointer snapshot{sockets.exchange(nullptr)};
+	if (!snapshot)
+		return;
+
+	// the disconnected sockets are released by the retired list
+	std::for_each(snapshot->begin(), snapshot->end(), [](socket_base& socket) noexcept {
+		socket_pointer<socket_base>::adopt(&socket).reset();
+	});
+}
+
+shared_state_base::sockets_unique_lock_type shared_state_base::lock_sockets()
+{
+	check_thread();
+	return connection_table_->lock();
+}
+
+void shared_state_base::check_thread() noexcept
+{
+#ifndef NDEBUG
+	if (!is_single_threaded_)
+		return;
+
+	const std::thread::id current_thread = std::this_thread::get_id();
+	if (owner_thread_ == std::thread::id{})
+		owner_thread_ = current_thread;
+	assert(owner_thread_ == current_thread); // NOLINT
+#endif
+}
+
+epoch_domain::record* shared_state_base::lock_shared()
+{
+	if (is_single_threaded_) {
+		check_thread();
+		++readers_number_;
+		return nullptr;
+	}
+
+	return &epoch_domain_.pin();
+}
+
+void shared_state_base::unlock_shared(epoch_domain::record* const pin) noexcept
+{
+	if (is_single_threaded_) {
+		assert(readers_number_ != 0); // NOLINT
+		// all readers are nested in the current thread, so the snapshots are reclaimed when the outermost one leaves
+		if (--readers_number_ == 0 && !retired_.empty())
+			static_cast<void>(retired_.take_all());
+		return;
+	}
 
-	return sockets_shared_view{*this, sockets_.begin(), sockets_.size()};
+	assert(pin); // NOLINT
+	epoch_domain::unpin(*pin);
+	if (!has_retired_.load())
+		return;
+
+	retired_list reclaimed; // deleted after the mutex is unlocked because it can destroy callbacks
+	const sockets_unique_lock_type sockets_lock = connection_table_->try_lock();
+	if (sockets_lock)
+		reclaimed = collect_retired(sockets_lock);
 }
 
-void shared_state_base::remove_reference(socket_base& socket, const sockets_unique_lock_type&) noexcept
+void shared_state_base::publish(
+	sockets_slot& slot, snapshot_pointer sockets, const sockets_unique_lock_type& lock) noexcept
 {
-	if (socket.remove_reference() == 0)
-		sockets_.erase(&socket);
+	assert(is_single_threaded_ || lock.owns_lock()); // NOLINT
+	(void) lock;
+
+	statistics_.update_subscribers_number(sockets_number_);
+
+	snapshot_pointer old_sockets{slot.exchange(sockets.release())};
+	if (!old_sockets)
+		return;
+
+	retire(*old_sockets.release(), lock);
+}
+
+void shared_state_base::retire(retired_node& node, const sockets_unique_lock_type& lock) noexcept
+{
+	assert(is_single_threaded_ || lock.owns_lock()); // NOLINT
+	(void) lock;
+
+	if (is_single_threaded_) {
+		retired_.push(node, 0);
+		return;
+	}
+
+	retired_.push(node, epoch_domain_.get_epoch());
+	has_retired_.store(true);
+}
+
+retired_list shared_state_base::collect_retired(const sockets_unique_lock_type& lock) noexcept
+{
+	assert(is_single_threaded_ || lock.owns_lock()); // NOLINT
+	(void) lock;
+
+	if (retired_.empty())
+		return {};
+
+	retired_list reclaimed;
+	if (is_single_threaded_) {
+		// all readers are nested in the current thread, so the snapshots are reclaimed when the outermost one leaves
+		if (readers_number_ == 0)
+			reclaimed = retired_.take_all();
+	}
+	else {
+		// a snapshot retired in the current epoch becomes reclaimable after two advances
+		epoch_domain_.try_advance();
+		reclaimed = retired_.take_reclaimable(epoch_domain_.try_advance());
+	}
+
+	if (!is_single_threaded_ && retired_.empty())
+		has_retired_.store(false);
+
+	return reclaimed;
 }
 
 // sockets_shared_view
 
 sockets_shared_view::sockets_shared_view(
-	shared_state_base& shared_state, const base_type::base_iterator_type first_item, const base_type::size_type size)
-	: base_type{first_item, size}
+	shared_state_base& shared_state, const sockets_snapshot* const sockets, epoch_domain::record* const pin) noexcept
+	: sockets_{sockets}
 	, shared_state_{&shared_state}
+	, pin_{pin}
 {}
 
 sockets_shared_view::sockets_shared_view(sockets_shared_view&& other) noexcept
-	: base_type{std::move(other)}
+	: sockets_{other.sockets_}
 	, shared_state_{other.shared_state_}
+	, pin_{other.pin_}
 {
+	other.sockets_ = nullptr;
 	other.shared_state_ = nullptr;
+	other.pin_ = nullptr;
 }
 
 sockets_shared_view& sockets_shared_view::operator=(sockets_shared_view&& other) noexcept
 {
 	reset();
 
+	sockets_ = other.sockets_;
 	shared_state_ = other.shared_state_;
+	pin_ = other.pin_;
+	other.sockets_ = nullptr;
 	other.shared_state_ = nullptr;
-	base_type::operator=(std::move(other));
+	other.pin_ = nullptr;
 
 	return *this;
 }
@@ -90,22 +405,40 @@ sockets_shared_view::~sockets_shared_view() noexcept
 	reset();
 }
 
-void sockets_shared_view::reset() noexcept
+sockets_shared_view::iterator sockets_shared_view::begin() const noexcept
 {
-	if (!shared_state_)
-		return;
+	return sockets_ ? sockets_->begin() : iterator{};
+}
 
-	if (empty())
-		return;
+sockets_shared_view::iterator sockets_shared_view::end() const noexcept
+{
+	return sockets_ ? sockets_->end() : iterator{};
+}
 
-	const shared_state_base::sockets_unique_lock_type sockets_lock{shared_state_->sockets_mutex_};
-	for (iterator it = begin(), next_it = it; it != end(); it = next_it) {
-		++next_it;
+sockets_shared_view::iterator sockets_shared_view::cbegin() const noexcept
+{
+	return begin();
+}
 
-		shared_state_->remove_reference(static_cast<socket_base&>(*it), sockets_lock); // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
-	}
+sockets_shared_view::iterator sockets_shared_view::cend() const noexcept
+{
+	return end();
+}
+
+bool sockets_shared_view::empty() const noexcept
+{
+	return begin() == end();
+}
+
+void sockets_shared_view::reset() noexcept
+{
+	if (!shared_state_)
+		return;
 
+	shared_state_->unlock_shared(pin_);
+	sockets_ = nullptr;
 	shared_state_ = nullptr;
+	pin_ = nullptr;
 }
 
 } // namespace detail
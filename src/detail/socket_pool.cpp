@@ -0,0 +1,123 @@
+#include "detail/socket_pool.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+namespace channels {
+namespace detail {
+
+union socket_pool::block {
+	block* next;
+	std::aligned_storage_t<block_size, block_alignment> storage;
+};
+
+struct socket_pool::chunk {
+	chunk* next;
+	std::size_t blocks_number;
+
+	CHANNELS_NODISCARD block* blocks() noexcept
+	{
+		// blocks are placed right after the header in the same memory block
+		return reinterpret_cast<block*>(reinterpret_cast<unsigned char*>(this) + header_size); // NOLINT
+	}
+
+	static constexpr std::size_t header_size =
+		(sizeof(chunk*) + sizeof(std::size_t) + alignof(block) - 1) / alignof(block) * alignof(block);
+};
+
+constexpr std::size_t socket_pool::block_size;
+constexpr std::size_t socket_pool::block_alignment;
+constexpr std::size_t socket_pool::chunk::header_size;
+
+socket_pool* socket_pool::create(const bool is_single_threaded)
+{
+	return new socket_pool{is_single_threaded}; // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+socket_pool::socket_pool(const bool is_single_threaded) noexcept
+	: is_single_threaded_{is_single_threaded}
+{}
+
+socket_pool::~socket_pool() noexcept
+{
+	while (chunks_) {
+		chunk* const next = chunks_->next;
+		chunks_->~chunk();
+		::operator delete(chunks_);
+		chunks_ = next;
+	}
+}
+
+void socket_pool::add_reference() noexcept
+{
+	references_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void socket_pool::remove_reference() noexcept
+{
+	assert(references_count_.load(std::memory_order_relaxed) > 0); // NOLINT
+	if (references_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete this; // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+void* socket_pool::allocate()
+{
+	if (is_single_threaded_) {
+		if (!free_blocks_)
+			free_blocks_ = released_blocks_.exchange(nullptr, std::memory_order_acquire);
+		return take_block();
+	}
+
+	const std::lock_guard<std::mutex> lock{mutex_};
+	return take_block();
+}
+
+void socket_pool::deallocate(void* const memory) noexcept
+{
+	assert(memory); // NOLINT
+
+	block* const b = new (memory) block;
+	if (is_single_threaded_) {
+		// the socket can be destroyed by an executor task in another thread
+		b->next = released_blocks_.load(std::memory_order_relaxed);
+		while (!released_blocks_.compare_exchange_weak(
+			b->next, b, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+	else {
+		const std::lock_guard<std::mutex> lock{mutex_};
+
+		b->next = free_blocks_;
+		free_blocks_ = b;
+	}
+
+	remove_reference();
+}
+
+socket_pool::block* socket_pool::take_block()
+{
+	if (!free_blocks_) {
+		constexpr std::size_t max_chunk_blocks_number = 64;
+
+		const std::size_t blocks_number = next_chunk_blocks_number_;
+		void* const memory = ::operator new(chunk::header_size + blocks_number * sizeof(block));
+		chunks_ = new (memory) chunk{chunks_, blocks_number};
+		next_chunk_blocks_number_ = std::min(blocks_number * 2, max_chunk_blocks_number);
+
+		block* const blocks = chunks_->blocks();
+		for (std::size_t i = blocks_number; i > 0; --i) {
+			block* const b = new (&blocks[i - 1]) block; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			b->next = free_blocks_;
+			free_blocks_ = b;
+		}
+	}
+
+	block* const result = free_blocks_;
+	free_blocks_ = result->next;
+	add_reference();
+
+	return result;
+}
+
+} // namespace detail
+} // namespace channels
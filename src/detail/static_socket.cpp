@@ -0,0 +1,47 @@
+#include "detail/static_socket.h"
+#include <cassert>
+
+namespace channels {
+namespace detail {
+
+constexpr std::size_t static_socket_base::storage_size;
+constexpr std::uint32_t static_socket_base::connected_flag;
+constexpr std::uint32_t static_socket_base::retired_flag;
+constexpr std::uint32_t static_socket_base::owned_flag;
+constexpr std::uint32_t static_socket_base::sender_unit;
+
+void static_socket_base::retire() noexcept
+{
+	const std::uint32_t state =
+		state_.fetch_add(retired_flag - connected_flag, std::memory_order_acq_rel) + (retired_flag - connected_flag);
+	assert((state & retired_flag) != 0); // NOLINT
+	if (state == retired_flag)
+		try_reclaim();
+}
+
+void static_socket_base::destroy() noexcept
+{
+	const std::uint32_t state = state_.load(std::memory_order_acquire);
+	assert(state == 0 || state == connected_flag); // NOLINT
+	if (state == connected_flag)
+		destroy_(storage_);
+	state_.store(0, std::memory_order_relaxed);
+}
+
+void static_socket_base::try_reclaim() noexcept
+{
+	// the disconnection and the last sender can both see the retired slot without senders, only one of them destroys
+	// the callback function
+	std::uint32_t expected = retired_flag;
+	if (!state_.compare_exchange_strong(expected, owned_flag, std::memory_order_acquire, std::memory_order_relaxed))
+		return;
+
+	assert(destroy_); // NOLINT
+	destroy_(storage_);
+	destroy_ = nullptr;
+	// the senders that have come while the callback function was destroyed are kept in the state
+	state_.fetch_sub(owned_flag, std::memory_order_release);
+}
+
+} // namespace detail
+} // namespace channels
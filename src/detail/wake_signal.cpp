@@ -0,0 +1,33 @@
+#include "detail/wake_signal.h"
+#include "detail/atomic_wait.h"
+
+namespace channels {
+namespace detail {
+
+void wake_signal::notify() noexcept
+{
+	// a waiter that hasn't prepared yet sees the new sequence number in `prepare_wait` and doesn't fall asleep
+	sequence_.fetch_add(1, std::memory_order_seq_cst);
+	if (is_waiting_.load(std::memory_order_seq_cst))
+		atomic_notify_all(sequence_);
+}
+
+std::uint32_t wake_signal::prepare_wait() noexcept
+{
+	is_waiting_.store(true, std::memory_order_seq_cst);
+	return sequence_.load(std::memory_order_seq_cst);
+}
+
+bool wake_signal::wait(
+	const std::uint32_t sequence, const std::chrono::steady_clock::time_point* const deadline) noexcept
+{
+	return atomic_wait(sequence_, sequence, deadline);
+}
+
+void wake_signal::finish_wait() noexcept
+{
+	is_waiting_.store(false, std::memory_order_relaxed);
+}
+
+} // namespace detail
+} // namespace channels
@@ -0,0 +1,71 @@
+#include "select.h"
+#include <utility>
+
+namespace channels {
+
+// selector
+
+constexpr std::size_t selector::npos;
+
+selector::~selector() noexcept
+{
+	for (entry& channel_entry : entries_)
+		channel_entry.source->remove_selector(notifier_);
+}
+
+std::size_t selector::get_size() const noexcept
+{
+	return entries_.size();
+}
+
+std::size_t selector::try_select() noexcept
+{
+	const std::size_t size = entries_.size();
+	for (std::size_t i = 0; i < size; ++i) {
+		const std::size_t index = (next_index_ + i) % size;
+		entry& channel_entry = entries_[index];
+		if (channel_entry.source->is_ready(channel_entry.version)) {
+			next_index_ = index + 1;
+			return index;
+		}
+	}
+
+	return npos;
+}
+
+std::size_t selector::select() noexcept
+{
+	return wait(nullptr);
+}
+
+std::size_t selector::add_source(std::shared_ptr<detail::select_source> source)
+{
+	entries_.push_back(entry{std::move(source), 0});
+	try {
+		entries_.back().source->add_selector(notifier_);
+	}
+	catch (...) {
+		entries_.pop_back();
+		throw;
+	}
+	return entries_.size() - 1;
+}
+
+std::size_t selector::wait(const std::chrono::steady_clock::time_point* const deadline) noexcept
+{
+	for (;;) {
+		const std::uint32_t sequence = notifier_.prepare_wait();
+		const std::size_t index = try_select();
+		if (index != npos) {
+			notifier_.finish_wait();
+			return index;
+		}
+
+		const bool is_in_time = notifier_.wait(sequence, deadline);
+		notifier_.finish_wait();
+		if (!is_in_time)
+			return try_select();
+	}
+}
+
+} // namespace channels
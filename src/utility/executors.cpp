@@ -0,0 +1,342 @@
+#include "utility/executors.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace channels {
+inline namespace utility {
+
+namespace {
+
+using executors_detail::task;
+
+// Work-stealing deque of fixed capacity (Chase-Lev algorithm).
+// Only the owner thread pushes and pops tasks at the bottom; other threads steal tasks from the top.
+// The slot of a stolen task is released after the task is moved out of it, so the owner never overwrites a slot that
+// is being read by a thief.
+class work_stealing_deque {
+public:
+	// Returns false if the deque is full (the `value` isn't moved).
+	bool push(task& value) noexcept;
+	bool pop(task& value) noexcept;
+	bool steal(task& value) noexcept;
+
+private:
+	static constexpr std::int64_t capacity = 256;
+
+	struct slot {
+		task value;
+		std::atomic<bool> is_full{false};
+	};
+
+	slot& get_slot(std::int64_t index) noexcept;
+	static void take(slot& slot, task& value) noexcept;
+
+	std::atomic<std::int64_t> top_{0};
+	std::array<slot, capacity> slots_;
+	std::atomic<std::int64_t> bottom_{0};
+};
+
+bool work_stealing_deque::push(task& value) noexcept
+{
+	const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+	const std::int64_t top = top_.load(std::memory_order_acquire);
+	if (bottom - top >= capacity)
+		return false;
+
+	slot& slot = get_slot(bottom);
+	if (slot.is_full.load(std::memory_order_acquire))
+		return false;
+
+	slot.value = std::move(value);
+	slot.is_full.store(true, std::memory_order_relaxed);
+	bottom_.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+bool work_stealing_deque::pop(task& value) noexcept
+{
+	const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+	bottom_.store(bottom, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::int64_t top = top_.load(std::memory_order_relaxed);
+
+	if (top > bottom) {
+		bottom_.store(bottom + 1, std::memory_order_release);
+		return false;
+	}
+
+	if (top == bottom) {
+		// the last task: compete with thieves
+		const bool won = top_.compare_exchange_strong(
+			top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		bottom_.store(bottom + 1, std::memory_order_release);
+		if (!won)
+			return false;
+	}
+
+	take(get_slot(bottom), value);
+	return true;
+}
+
+bool work_stealing_deque::steal(task& value) noexcept
+{
+	std::int64_t top = top_.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+	if (top >= bottom)
+		return false;
+
+	if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return false;
+
+	take(get_slot(top), value);
+	return true;
+}
+
+work_stealing_deque::slot& work_stealing_deque::get_slot(const std::int64_t index) noexcept
+{
+	return slots_[static_cast<std::size_t>(index % capacity)];
+}
+
+void work_stealing_deque::take(slot& slot, task& value) noexcept
+{
+	value = std::move(slot.value);
+	slot.is_full.store(false, std::memory_order_release);
+}
+
+// Queue of tasks in a ring buffer. Unlike std::deque it doesn't allocate memory when the number of tasks doesn't exceed
+// the maximum number reached before.
+class task_queue {
+public:
+	CHANNELS_NODISCARD bool empty() const noexcept;
+	void push(task value);
+	task pop() noexcept;
+
+private:
+	std::vector<task> buffer_;
+	std::size_t head_ = 0;
+	std::size_t size_ = 0;
+};
+
+bool task_queue::empty() const noexcept
+{
+	return size_ == 0;
+}
+
+void task_queue::push(task value)
+{
+	if (size_ == buffer_.size()) {
+		std::vector<task> buffer(std::max<std::size_t>(buffer_.size() * 2, 16));
+		for (std::size_t i = 0; i < size_; ++i)
+			buffer[i] = std::move(buffer_[(head_ + i) % buffer_.size()]);
+		buffer_ = std::move(buffer);
+		head_ = 0;
+	}
+
+	buffer_[(head_ + size_) % buffer_.size()] = std::move(value);
+	++size_;
+}
+
+task task_queue::pop() noexcept
+{
+	assert(!empty()); // NOLINT
+
+	task value = std::move(buffer_[head_]);
+	head_ = (head_ + 1) % buffer_.size();
+	--size_;
+	return value;
+}
+
+} // namespace
+
+// thread_pool_executor::shared_state
+
+struct thread_pool_executor::shared_state {
+	struct worker {
+		work_stealing_deque deque;
+		std::thread thread;
+	};
+
+	explicit shared_state(std::size_t threads_number);
+
+	void run_worker(std::size_t index) noexcept;
+	bool find_task(std::size_t index, task& value) noexcept;
+	void notify() noexcept;
+	void stop() noexcept;
+
+	std::vector<std::unique_ptr<worker>> workers;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	task_queue injected_tasks;
+	std::atomic<std::size_t> injected_tasks_number{0};
+	bool stopped = false;
+
+	// it is changed after each addition of a task, so a worker doesn't fall asleep if a task was added while it was
+	// looking for a task
+	std::atomic<std::uint64_t> epoch{0};
+	std::atomic<std::size_t> sleeping_workers_number{0};
+};
+
+namespace {
+
+thread_local const void* this_thread_pool = nullptr; // NOLINT
+thread_local std::size_t this_thread_worker_index = 0; // NOLINT
+
+} // namespace
+
+thread_pool_executor::shared_state::shared_state(const std::size_t threads_number)
+{
+	workers.reserve(threads_number);
+	for (std::size_t i = 0; i < threads_number; ++i)
+		workers.push_back(std::make_unique<worker>());
+}
+
+void thread_pool_executor::shared_state::run_worker(const std::size_t index) noexcept
+{
+	this_thread_pool = this;
+	this_thread_worker_index = index;
+
+	task value;
+	for (;;) {
+		const std::uint64_t current_epoch = epoch.load(std::memory_order_seq_cst);
+		if (find_task(index, value)) {
+			value();
+			value = task{};
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock{mutex};
+		if (epoch.load(std::memory_order_seq_cst) != current_epoch)
+			continue;
+		if (stopped)
+			return;
+
+		sleeping_workers_number.fetch_add(1, std::memory_order_seq_cst);
+		condition.wait(lock, [this, current_epoch] {
+			return stopped || epoch.load(std::memory_order_seq_cst) != current_epoch;
+		});
+		sleeping_workers_number.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+bool thread_pool_executor::shared_state::find_task(const std::size_t index, task& value) noexcept
+{
+	if (workers[index]->deque.pop(value))
+		return true;
+
+	if (injected_tasks_number.load(std::memory_order_acquire) != 0) {
+		const std::lock_guard<std::mutex> lock{mutex};
+		if (!injected_tasks.empty()) {
+			value = injected_tasks.pop();
+			injected_tasks_number.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	for (std::size_t i = 1; i < workers.size(); ++i) {
+		if (workers[(index + i) % workers.size()]->deque.steal(value))
+			return true;
+	}
+
+	return false;
+}
+
+void thread_pool_executor::shared_state::notify() noexcept
+{
+	epoch.fetch_add(1, std::memory_order_seq_cst);
+	if (sleeping_workers_number.load(std::memory_order_seq_cst) != 0) {
+		const std::lock_guard<std::mutex> lock{mutex};
+		condition.notify_one();
+	}
+}
+
+void thread_pool_executor::shared_state::stop() noexcept
+{
+	{
+		const std::lock_guard<std::mutex> lock{mutex};
+		stopped = true;
+	}
+	condition.notify_all();
+
+	for (const std::unique_ptr<worker>& worker : workers) {
+		if (worker->thread.joinable())
+			worker->thread.join();
+	}
+}
+
+// thread_pool_executor
+
+thread_pool_executor::thread_pool_executor(const std::size_t threads_number)
+	: thread_pool_executor{threads_number, {}}
+{}
+
+thread_pool_executor::thread_pool_executor(std::size_t threads_number, const std::vector<std::size_t>& cpus)
+{
+	if (threads_number == 0)
+		threads_number = std::max(std::thread::hardware_concurrency(), 1u);
+
+	shared_state_ = std::make_unique<shared_state>(threads_number);
+	try {
+		for (std::size_t i = 0; i < threads_number; ++i) {
+			std::thread& thread = shared_state_->workers[i]->thread;
+			thread = std::thread{[state = shared_state_.get(), i] { state->run_worker(i); }};
+
+			if (cpus.empty())
+				continue;
+#ifdef __linux__
+			const std::size_t cpu = cpus[i % cpus.size()];
+			if (cpu >= CPU_SETSIZE)
+				throw std::system_error{std::make_error_code(std::errc::invalid_argument), "invalid CPU number"};
+
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			CPU_SET(cpu, &cpu_set);
+			const int error = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+			if (error != 0)
+				throw std::system_error{error, std::system_category(), "can't bind the worker thread to the CPU"};
+#endif
+		}
+	}
+	catch (...) {
+		shared_state_->stop();
+		throw;
+	}
+}
+
+thread_pool_executor::~thread_pool_executor()
+{
+	shared_state_->stop();
+}
+
+std::size_t thread_pool_executor::get_threads_number() const noexcept
+{
+	return shared_state_->workers.size();
+}
+
+void thread_pool_executor::add_task(task new_task)
+{
+	shared_state& state = *shared_state_;
+	// a worker thread pushes the task to its own deque
+	if (this_thread_pool != &state || !state.workers[this_thread_worker_index]->deque.push(new_task)) {
+		const std::lock_guard<std::mutex> lock{state.mutex};
+		state.injected_tasks.push(std::move(new_task));
+		state.injected_tasks_number.fetch_add(1, std::memory_order_release);
+	}
+
+	state.notify();
+}
+
+} // namespace utility
+} // namespace channels
@@ -0,0 +1,178 @@
+#include "utility/recorder.h"
+
+#ifdef CHANNELS_HAS_MMAP
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace channels {
+inline namespace utility {
+namespace recorder_detail {
+
+namespace {
+
+constexpr std::uint32_t log_magic = 0x4c4e4843; // "CHNL"
+constexpr std::uint32_t log_version = 1;
+
+// offsets in the file header
+constexpr std::size_t magic_offset = 0;
+constexpr std::size_t version_offset = 4;
+constexpr std::size_t data_size_offset = 8;
+constexpr std::size_t header_size = 16;
+
+// offsets in the record header
+constexpr std::size_t timestamp_offset = 0;
+constexpr std::size_t record_size_offset = 8;
+constexpr std::size_t record_header_size = 12;
+
+template<typename T>
+void store(unsigned char* const address, const T value) noexcept
+{
+	std::memcpy(address, &value, sizeof(T));
+}
+
+template<typename T>
+T load(const unsigned char* const address) noexcept
+{
+	T value{};
+	std::memcpy(&value, address, sizeof(T));
+	return value;
+}
+
+[[noreturn]] void throw_system_error(const char* const message)
+{
+	throw std::system_error{errno, std::generic_category(), message};
+}
+
+} // namespace
+
+// log_writer
+
+log_writer::log_writer(const std::string& path, const std::size_t capacity)
+	: descriptor_{open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)} // NOLINT
+	, capacity_{header_size + capacity}
+	, address_{nullptr}
+	, size_{0}
+{
+	if (descriptor_ == -1)
+		throw_system_error("recorder: can't create log file");
+
+	// the space is reserved beforehand, so appending a record never touches the file system metadata
+#ifdef __linux__
+	const int error = posix_fallocate(descriptor_, 0, static_cast<off_t>(capacity_));
+	const bool is_allocated = error == 0;
+	if (!is_allocated)
+		errno = error;
+#else
+	const bool is_allocated = ftruncate(descriptor_, static_cast<off_t>(capacity_)) == 0;
+#endif
+	void* const address = is_allocated
+		? mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor_, 0)
+		: MAP_FAILED; // NOLINT
+	if (address == MAP_FAILED) { // NOLINT
+		const int map_error = errno;
+		close(descriptor_);
+		errno = map_error;
+		throw_system_error("recorder: can't map log file");
+	}
+
+	address_ = static_cast<unsigned char*>(address);
+	store(address_ + magic_offset, log_magic);
+	store(address_ + version_offset, log_version);
+	store(address_ + data_size_offset, std::uint64_t{0});
+}
+
+log_writer::~log_writer() noexcept
+{
+	munmap(address_, capacity_);
+	(void) ftruncate(descriptor_, static_cast<off_t>(header_size + size_));
+	close(descriptor_);
+}
+
+bool log_writer::append(const std::uint64_t timestamp, const unsigned char* const data, const std::size_t size) noexcept
+{
+	if (capacity_ - header_size - size_ < record_header_size + size || size > UINT32_MAX)
+		return false;
+
+	unsigned char* const record = address_ + header_size + size_; // NOLINT
+	store(record + timestamp_offset, timestamp);
+	store(record + record_size_offset, static_cast<std::uint32_t>(size));
+	std::memcpy(record + record_header_size, data, size); // NOLINT
+	size_ += record_header_size + size;
+	store(address_ + data_size_offset, static_cast<std::uint64_t>(size_));
+	return true;
+}
+
+// log_reader
+
+log_reader::log_reader(const std::string& path)
+	: file_size_{0}
+	, address_{nullptr}
+	, size_{0}
+{
+	const int descriptor = open(path.c_str(), O_RDONLY); // NOLINT
+	if (descriptor == -1)
+		throw_system_error("replayer: can't open log file");
+
+	struct stat status{};
+	if (fstat(descriptor, &status) == -1) {
+		const int error = errno;
+		close(descriptor);
+		errno = error;
+		throw_system_error("replayer: can't read log file");
+	}
+
+	file_size_ = static_cast<std::size_t>(status.st_size);
+	void* const address =
+		file_size_ >= header_size ? mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, descriptor, 0) : MAP_FAILED; // NOLINT
+	const int error = errno;
+	close(descriptor);
+	if (file_size_ < header_size)
+		throw std::system_error{std::make_error_code(std::errc::invalid_argument), "replayer: file isn't a log"};
+	if (address == MAP_FAILED) { // NOLINT
+		errno = error;
+		throw_system_error("replayer: can't map log file");
+	}
+
+	address_ = static_cast<const unsigned char*>(address);
+	const std::uint64_t size = load<std::uint64_t>(address_ + data_size_offset);
+	if (load<std::uint32_t>(address_ + magic_offset) != log_magic ||
+		load<std::uint32_t>(address_ + version_offset) != log_version || size > file_size_ - header_size) {
+		munmap(const_cast<unsigned char*>(address_), file_size_); // NOLINT
+		throw std::system_error{std::make_error_code(std::errc::invalid_argument), "replayer: file isn't a log"};
+	}
+
+	size_ = static_cast<std::size_t>(size);
+}
+
+log_reader::~log_reader() noexcept
+{
+	munmap(const_cast<unsigned char*>(address_), file_size_); // NOLINT
+}
+
+bool log_reader::read(std::size_t& offset, log_record& record) const noexcept
+{
+	if (size_ - offset < record_header_size)
+		return false;
+
+	const unsigned char* const record_address = address_ + header_size + offset; // NOLINT
+	const std::size_t size = load<std::uint32_t>(record_address + record_size_offset);
+	if (size_ - offset - record_header_size < size)
+		return false;
+
+	record.timestamp = load<std::uint64_t>(record_address + timestamp_offset);
+	record.data = record_address + record_header_size; // NOLINT
+	record.size = size;
+	offset += record_header_size + size;
+	return true;
+}
+
+} // namespace recorder_detail
+} // namespace utility
+} // namespace channels
+
+#endif
@@ -12,8 +12,12 @@
 #include "tools/executor.h"
 #include <channels/detail/compatibility/compile_features.h>
 #include <catch2/catch.hpp>
+#include <array>
+#include <chrono>
 #include <exception>
+#include <future>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -381,6 +385,127 @@ TEST_CASE("Testing class aggregating_channel", "[aggregating_channel]") {
 			tools::check_throws(aggregator.get_exceptions());
 		}
 	}
+	SECTION("testing with std::promise") {
+		using aggregator_type = box_aggregator<int>;
+
+		transmitter<aggregating_channel<int(int)>> transmitter;
+
+		const connection c = transmitter.get_channel().connect([](const int v) noexcept { return v; });
+
+		std::future<aggregator_type> future = transmitter.send(aggregator_type{}, 1, std::promise<aggregator_type>{});
+
+		const aggregator_type aggregator = future.get();
+		CHECK(aggregator.get_results() == std::vector<int>{1});
+	}
+	SECTION("testing class future") {
+		using channel_type = aggregating_channel<int(int)>;
+		using aggregator_type = box_aggregator<int>;
+		using promise_type = embedded_promise<aggregator_type>;
+
+		tools::executor executor;
+		transmitter<channel_type> transmitter;
+		const connection c = transmitter.get_channel().connect(&executor, [](const int v) noexcept { return v; });
+
+		SECTION("default constructed future") {
+			channels::future<aggregator_type> future;
+
+			CHECK_FALSE(future.is_valid());
+			CHECK_THROWS_AS(future.wait(), std::future_error);
+			CHECK_THROWS_AS(future.get(), std::future_error);
+		}
+		SECTION("waiting for result") {
+			channels::future<aggregator_type> future = transmitter.send(aggregator_type{}, 1, promise_type{});
+			REQUIRE(future.is_valid());
+			CHECK_FALSE(future.is_ready());
+			CHECK_FALSE(future.wait_for(std::chrono::milliseconds{1}));
+
+			executor.run_all_tasks();
+			CHECK(future.is_ready());
+			CHECK(future.wait_for(std::chrono::milliseconds{1}));
+			future.wait();
+
+			const aggregator_type aggregator = future.get();
+			CHECK(aggregator.get_results() == std::vector<int>{1});
+			CHECK_FALSE(future.is_valid());
+		}
+		SECTION("moving future") {
+			channels::future<aggregator_type> future1 = transmitter.send(aggregator_type{}, 2, promise_type{});
+			channels::future<aggregator_type> future2 = std::move(future1);
+			CHECK_FALSE(future1.is_valid()); // NOLINT(bugprone-use-after-move, hicpp-invalid-access-moved)
+			REQUIRE(future2.is_valid());
+
+			executor.run_all_tasks();
+			CHECK(future2.get().get_results() == std::vector<int>{2});
+		}
+		SECTION("destroying future before result is ready") {
+			{
+				const channels::future<aggregator_type> future = transmitter.send(aggregator_type{}, 3, promise_type{});
+			}
+			CHECK_NOTHROW(executor.run_all_tasks());
+		}
+		SECTION("attaching continuation before result is ready") {
+			channels::future<aggregator_type> future = transmitter.send(aggregator_type{}, 4, promise_type{});
+			std::vector<int> results;
+			future.then([&results](channels::future<aggregator_type>&& ready_future) noexcept {
+				CHECK(ready_future.is_ready());
+				results = ready_future.get().get_results();
+			});
+			CHECK_FALSE(future.is_valid());
+			CHECK(results.empty());
+
+			executor.run_all_tasks();
+			CHECK(results == std::vector<int>{4});
+		}
+		SECTION("attaching continuation that doesn't fit into shared state") {
+			channels::future<aggregator_type> future = transmitter.send(aggregator_type{}, 7, promise_type{});
+			std::vector<int> results;
+			const auto counter = std::make_shared<int>(0);
+			const std::array<int, 16> payload{};
+			future.then([&results, counter, payload](channels::future<aggregator_type>&& ready_future) noexcept {
+				++*counter;
+				results = ready_future.get().get_results();
+				results.push_back(payload.back());
+			});
+			CHECK(counter.use_count() == 2);
+
+			executor.run_all_tasks();
+			CHECK(results == std::vector<int>{7, 0});
+			CHECK(*counter == 1);
+			// the continuation is destroyed after it is called
+			CHECK(counter.use_count() == 1);
+		}
+		SECTION("attaching continuation after result is ready") {
+			channels::future<aggregator_type> future = transmitter.send(aggregator_type{}, 5, promise_type{});
+			executor.run_all_tasks();
+
+			std::vector<int> results;
+			future.then([&results](channels::future<aggregator_type>&& ready_future) noexcept {
+				results = ready_future.get().get_results();
+			});
+			CHECK(results == std::vector<int>{5});
+		}
+		SECTION("attaching continuation to result with exception") {
+			using throw_aggregator_type = limited_throw_aggregator<aggregator_type>;
+			using throw_promise_type = embedded_promise<throw_aggregator_type>;
+
+			channels::future<throw_aggregator_type> future =
+				transmitter.send(throw_aggregator_type{0}, 6, throw_promise_type{});
+			// the continuation is called by the noexcept completion of the sending, so it catches the exception itself
+			std::exception_ptr exception;
+			future.then([&exception](channels::future<throw_aggregator_type>&& ready_future) noexcept {
+				try {
+					static_cast<void>(ready_future.get());
+				}
+				catch (...) {
+					exception = std::current_exception();
+				}
+			});
+
+			executor.run_all_tasks();
+			REQUIRE(exception);
+			CHECK_THROWS_AS(std::rethrow_exception(exception), std::runtime_error);
+		}
+	}
 	SECTION("testing with custom promise") {
 		SECTION("void callbacks") {
 			using aggregator_type = box_aggregator<void>;
@@ -3,10 +3,14 @@
 #include "tools/callbacks.h"
 #include "tools/exception_helpers.h"
 #include "tools/executor.h"
+#include "tools/thread_helpers.h"
 #include "tools/tracker.h"
 #include <catch2/catch.hpp>
+#include <atomic>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace channels {
@@ -87,6 +91,22 @@ TEST_CASE("Testing class buffered_channel", "[buffered_channel]") {
 			CHECK(calls_number2 == 2u);
 		}
 	}
+	SECTION("connecting conflated callback") {
+		using channel_type = buffered_channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		tools::executor executor;
+		std::vector<int> values;
+
+		transmitter.send(1);
+		const connection connection =
+			channel.connect_conflated(&executor, [&values](const int value) { values.push_back(value); });
+		transmitter.send(2);
+		CHECK(executor.get_tasks_number() == 1u);
+
+		executor.run_all_tasks();
+		CHECK(values == std::vector<int>{2});
+	}
 	SECTION("connecting callback with multiple arguments") {
 		using namespace std::string_literals;
 
@@ -277,6 +297,23 @@ TEST_CASE("Testing class buffered_channel", "[buffered_channel]") {
 			CHECK(order[1] == 2);
 		}
 	}
+	SECTION("checking callbacks call order with priorities") {
+		using channel_type = buffered_channel<>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		std::vector<int> order;
+
+		const connection connection1 = channel.connect([&order] { order.push_back(1); });
+		const connection connection2 = channel.connect(priority{1}, [&order] { order.push_back(2); });
+		transmitter.send();
+		CHECK(order == std::vector<int>{2, 1});
+
+		// the buffered value is passed to the new callback at once
+		tools::executor executor;
+		const connection connection3 = channel.connect(priority{2}, &executor, [&order] { order.push_back(3); });
+		executor.run_all_tasks();
+		CHECK(order == std::vector<int>{2, 1, 3});
+	}
 	SECTION("callbacks throw exception (without executor only)") {
 		using channel_type = buffered_channel<int>;
 		transmitter<channel_type> transmitter;
@@ -577,11 +614,78 @@ TEST_CASE("Testing class buffered_channel", "[buffered_channel]") {
 		CHECK(tracker.get_value() == 272);
 		CHECK(tracker.get_copy_generation() == 0u);
 	}
+	SECTION("sending batch") {
+		using channel_type = buffered_channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		std::vector<int> values1;
+		const connection connection1 = channel.connect([&values1](const int i) { values1.push_back(i); });
+		transmitter.send_batch(std::vector<int>{1, 2, 3});
+		CHECK(values1 == std::vector<int>{1, 2, 3});
+
+		REQUIRE(channel.get_value());
+		CHECK(std::get<0>(*channel.get_value()) == 3);
+
+		std::vector<int> values2;
+		const connection connection2 = channel.connect([&values2](const int i) { values2.push_back(i); });
+		CHECK(values2 == std::vector<int>{3});
+	}
 	SECTION("testing method get_value for invalid channel") {
 		const buffered_channel<> channel;
 
 		CHECK_THROWS_AS(channel.get_value(), channel_error);
 	}
+	SECTION("testing method read_value") {
+		using channel_type = buffered_channel<int, double, char>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		std::tuple<int, double, char> value{0, 0.0, 'a'};
+		CHECK_FALSE(channel.read_value(value));
+		CHECK(value == std::make_tuple(0, 0.0, 'a'));
+
+		transmitter.send(1, 2.5, 'b');
+		REQUIRE(channel.read_value(value));
+		CHECK(value == std::make_tuple(1, 2.5, 'b'));
+
+		transmitter.send_batch(std::vector<std::tuple<int, double, char>>{{2, 3.5, 'c'}, {3, 4.5, 'd'}});
+		REQUIRE(channel.read_value(value));
+		CHECK(value == std::make_tuple(3, 4.5, 'd'));
+	}
+	SECTION("testing method read_value from different threads") {
+		using channel_type = buffered_channel<std::uint64_t, std::uint64_t>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		transmitter.send(0u, 0u);
+
+		constexpr std::uint64_t values_number = 10000;
+		std::atomic<bool> torn_read{false};
+		{
+			std::vector<tools::joining_thread> readers;
+			for (unsigned i = 0; i < 2; ++i) {
+				readers.emplace_back([&channel, &torn_read] {
+					std::tuple<std::uint64_t, std::uint64_t> value;
+					// Catch assertions aren't thread-safe, so the result is checked in the main thread
+					do {
+						if (!channel.read_value(value) || std::get<0>(value) != std::get<1>(value))
+							torn_read = true;
+					} while (!torn_read && std::get<0>(value) != values_number);
+				});
+			}
+
+			for (std::uint64_t i = 1; i <= values_number; ++i)
+				transmitter.send(i, i);
+		}
+
+		CHECK_FALSE(torn_read);
+	}
+	SECTION("testing method read_value for invalid channel") {
+		const buffered_channel<int> channel;
+		std::tuple<int> value;
+
+		CHECK_THROWS_AS(channel.read_value(value), channel_error);
+	}
 	SECTION("testing comparing functions") {
 		using channel_type = buffered_channel<>;
 
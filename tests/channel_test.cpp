@@ -1,16 +1,23 @@
 #include <channels/channel.h>
 #include <channels/transmitter.h>
+#include <channels/utility/executors.h>
 #include "tools/callbacks.h"
 #include "tools/exception_helpers.h"
 #include "tools/executor.h"
 #include "tools/thread_helpers.h"
+#include "tools/tracker.h"
 #include <catch2/catch.hpp>
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -225,6 +232,35 @@ TEST_CASE("Testing class channel", "[channel]") {
 			CHECK(calls_number == 1u);
 		}
 	}
+	SECTION("connecting large callback") {
+		using channel_type = channel<>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		std::array<unsigned, 64> calls_numbers{};
+
+		SECTION("without executor") {
+			connection connection = channel.connect([&calls_numbers, data = calls_numbers] {
+				calls_numbers[0] += static_cast<unsigned>(data.size());
+			});
+			transmitter.send();
+			CHECK(calls_numbers[0] == 64u);
+
+			connection.disconnect();
+			transmitter.send();
+			CHECK(calls_numbers[0] == 64u);
+		}
+		SECTION("with executor") {
+			tools::executor executor;
+			const connection connection = channel.connect(&executor, [&calls_numbers, data = calls_numbers] {
+				calls_numbers[0] += static_cast<unsigned>(data.size());
+			});
+			transmitter.send();
+			transmitter = decltype(transmitter){};
+			executor.run_all_tasks();
+			CHECK(calls_numbers[0] == 64u);
+		}
+	}
 	SECTION("connecting from callback") {
 		using channel_type = channel<>;
 		transmitter<channel_type> transmitter;
@@ -268,6 +304,37 @@ TEST_CASE("Testing class channel", "[channel]") {
 			CHECK(order[1] == 2);
 		}
 	}
+	SECTION("checking callbacks call order with priorities") {
+		using channel_type = channel<>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		std::vector<int> order;
+
+		SECTION("without executor") {
+			const connection connection1 = channel.connect(priority{-1}, [&order] { order.push_back(1); });
+			const connection connection2 = channel.connect([&order] { order.push_back(2); });
+			const connection connection3 = channel.connect(priority{1}, [&order] { order.push_back(3); });
+			const connection connection4 = channel.connect(priority{1}, [&order] { order.push_back(4); });
+			connection connection5 = channel.connect(priority{0}, [&order] { order.push_back(5); });
+			transmitter.send();
+			CHECK(order == std::vector<int>{3, 4, 2, 5, 1});
+
+			// disconnecting keeps the order of the other callbacks
+			connection5.disconnect();
+			const connection connection6 = channel.connect(priority{1}, [&order] { order.push_back(6); });
+			order.clear();
+			transmitter.send();
+			CHECK(order == std::vector<int>{3, 4, 6, 2, 1});
+		}
+		SECTION("with executor") {
+			tools::executor executor;
+			const connection connection1 = channel.connect(&executor, [&order] { order.push_back(1); });
+			const connection connection2 = channel.connect(priority{1}, &executor, [&order] { order.push_back(2); });
+			transmitter.send();
+			executor.run_all_tasks();
+			CHECK(order == std::vector<int>{2, 1});
+		}
+	}
 	SECTION("callbacks throw exception (without executor only)") {
 		using channel_type = channel<>;
 		transmitter<channel_type> transmitter;
@@ -509,6 +576,43 @@ TEST_CASE("Testing class channel", "[channel]") {
 			executor.run_all_tasks();
 			CHECK(calls_number == 1);
 		}
+		SECTION("connection doesn't keep callback alive") {
+			const auto callback_state = std::make_shared<int>(0);
+			const std::weak_ptr<int> weak_callback_state = callback_state;
+			connection connection = channel.connect([callback_state] { ++*callback_state; });
+
+			transmitter = decltype(transmitter){};
+			CHECK(connection.is_connected());
+			CHECK(weak_callback_state.use_count() == 1);
+
+			connection.disconnect();
+			CHECK_FALSE(connection.is_connected());
+		}
+	}
+	SECTION("reconnecting after disconnecting") {
+		using channel_type = channel<>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		unsigned calls_number1 = 0;
+		unsigned calls_number2 = 0;
+		unsigned calls_number3 = 0;
+		connection connection1 = channel.connect([&calls_number1] { ++calls_number1; });
+		connection connection2 = channel.connect([&calls_number2] { ++calls_number2; });
+
+		// the new connection takes the place of the disconnected one, the old handle doesn't refer to it
+		connection1.disconnect();
+		connection connection3 = channel.connect([&calls_number3] { ++calls_number3; });
+		connection1.disconnect();
+		transmitter.send();
+		CHECK(calls_number1 == 0u);
+		CHECK(calls_number2 == 1u);
+		CHECK(calls_number3 == 1u);
+
+		connection2.disconnect();
+		transmitter.send();
+		CHECK(calls_number2 == 1u);
+		CHECK(calls_number3 == 2u);
 	}
 	SECTION("async connects and disconnects") {
 		using channel_type = channel<>;
@@ -548,6 +652,38 @@ TEST_CASE("Testing class channel", "[channel]") {
 			[](const connection& c) { return c.is_connected(); });
 		CHECK(real_connects_number == async_connects_number);
 	}
+	SECTION("async sends with connects and disconnects") {
+		using channel_type = channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		std::atomic<int> persistent_calls_number{0};
+		const connection persistent_connection =
+			channel.connect([&persistent_calls_number](int) { ++persistent_calls_number; });
+
+		constexpr int senders_number = 4;
+		constexpr int sends_number = 1000;
+		std::array<std::thread, senders_number> senders;
+		for (std::thread& sender : senders) {
+			sender = std::thread([&transmitter] {
+				for (int i = 0; i < sends_number; ++i)
+					transmitter.send(i);
+			});
+		}
+
+		std::thread connector{[&channel] {
+			for (int i = 0; i < sends_number; ++i) {
+				auto calls_number = std::make_shared<std::atomic<int>>(0);
+				connection c = channel.connect([calls_number](int) { ++*calls_number; });
+				c.disconnect();
+			}
+		}};
+
+		tools::wait_all(senders);
+		connector.join();
+
+		CHECK(persistent_calls_number == senders_number * sends_number);
+	}
 	SECTION("checking destroy sending data after call all callbacks") {
 		class notifier {
 		public:
@@ -590,6 +726,394 @@ TEST_CASE("Testing class channel", "[channel]") {
 		executor.run_all_tasks();
 		CHECK(calls_number == 1u);
 	}
+	SECTION("sending batch") {
+		using channel_type = channel<int, std::string>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		const std::vector<std::tuple<int, std::string>> batch{{1, "1"}, {2, "2"}, {3, "3"}};
+
+		SECTION("without executor") {
+			std::vector<int> values;
+			const connection connection = channel.connect([&values](const int i, const std::string& s) {
+				CHECK(std::to_string(i) == s);
+				values.push_back(i);
+			});
+			transmitter.send_batch(batch);
+			CHECK(values == std::vector<int>{1, 2, 3});
+
+			transmitter.send_batch(std::vector<std::tuple<int, std::string>>{});
+			CHECK(values.size() == 3u);
+		}
+		SECTION("with executor") {
+			tools::executor executor;
+			std::vector<int> values;
+			const connection connection = channel.connect(&executor, [&values](const int i, const std::string& s) {
+				CHECK(std::to_string(i) == s);
+				values.push_back(i);
+			});
+			transmitter.send_batch(batch);
+			CHECK(executor.get_tasks_number() == 1u);
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{1, 2, 3});
+		}
+		SECTION("callbacks throw exception") {
+			std::vector<int> values;
+			const connection connection1 = channel.connect([&values](const int i, const std::string&) {
+				values.push_back(i);
+				if (i == 2)
+					throw std::runtime_error{"Callback error"};
+			});
+			const connection connection2 = channel.connect([&values](const int i, const std::string&) {
+				values.push_back(i * 10);
+			});
+
+			try {
+				transmitter.send_batch(batch);
+				FAIL("transmitter must be throw callbacks_exception");
+			}
+			catch (const callbacks_exception& transmitter_exception) {
+				CHECK(transmitter_exception.get_exceptions().size() == 1u);
+				CHECK(values == std::vector<int>{1, 2, 3, 10, 20, 30});
+			}
+		}
+		SECTION("disconnecting from callback") {
+			std::vector<int> values;
+			connection connection;
+			connection = channel.connect([&values, &connection](const int i, const std::string&) {
+				values.push_back(i);
+				connection.disconnect();
+			});
+			transmitter.send_batch(batch);
+			CHECK(values == std::vector<int>{1});
+		}
+	}
+	SECTION("checking sending value isn't copied") {
+		using channel_type = channel<tools::tracker>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		std::vector<unsigned> copy_generations;
+		const auto callback = [&copy_generations](const tools::tracker& t) {
+			CHECK(t.get_value() == 272);
+			copy_generations.push_back(t.get_copy_generation());
+		};
+
+		SECTION("without executor") {
+			const connection connection1 = channel.connect(callback);
+			const connection connection2 = channel.connect(callback);
+			transmitter.send(tools::tracker{272});
+		}
+		SECTION("with and without executor") {
+			tools::executor executor;
+			const connection connection1 = channel.connect(callback);
+			const connection connection2 = channel.connect(&executor, callback);
+			const connection connection3 = channel.connect(callback);
+			const connection connection4 = channel.connect(&executor, callback);
+			transmitter.send(tools::tracker{272});
+			executor.run_all_tasks();
+		}
+
+		CHECK(std::all_of(copy_generations.begin(), copy_generations.end(), [](unsigned g) { return g == 0; }));
+	}
+	SECTION("connecting conflated callback") {
+		using channel_type = channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		tools::executor executor;
+		std::vector<int> values;
+		const auto callback = [&values](const int value) { values.push_back(value); };
+
+		SECTION("to invalid channel") {
+			CHECK_THROWS_AS(channel_type{}.connect_conflated(&executor, callback), channel_error);
+		}
+		SECTION("delivering only the latest value") {
+			const connection connection = channel.connect_conflated(&executor, callback);
+			transmitter.send(1);
+			transmitter.send(2);
+			transmitter.send_batch(std::vector<int>{3, 4});
+			CHECK(executor.get_tasks_number() == 1u);
+
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{4});
+
+			transmitter.send(5);
+			CHECK(executor.get_tasks_number() == 2u);
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{4, 5});
+		}
+		SECTION("throwing from callback function") {
+			bool is_thrown = false;
+			const connection connection = channel.connect_conflated(&executor, [&](const int value) {
+				values.push_back(value);
+				if (!is_thrown) {
+					is_thrown = true;
+					transmitter.send(2);
+					throw std::runtime_error{"test"};
+				}
+			});
+			transmitter.send(1);
+
+			// the value sent by the callback function isn't left until the next sending
+			CHECK_THROWS_AS(executor.run_all_tasks(), std::runtime_error);
+			CHECK(executor.get_tasks_number() == 2u);
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{1, 2});
+		}
+		SECTION("disconnecting") {
+			connection connection = channel.connect_conflated(&executor, callback);
+			transmitter.send(1);
+			connection.disconnect();
+			executor.run_all_tasks();
+			CHECK(values.empty());
+		}
+	}
+	SECTION("connecting callback with mailbox") {
+		using channel_type = channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		tools::executor executor;
+		std::vector<int> values;
+		const auto callback = [&values](const int value) { values.push_back(value); };
+
+		SECTION("to invalid channel") {
+			CHECK_THROWS_AS(
+				channel_type{}.connect_mailbox(mailbox_options{}, &executor, callback), channel_error);
+		}
+		SECTION("scheduling one task for all values") {
+			const mailbox_connection connection = channel.connect_mailbox(mailbox_options{}, &executor, callback);
+			transmitter.send(1);
+			transmitter.send(2);
+			transmitter.send_batch(std::vector<int>{3, 4});
+			CHECK(executor.get_tasks_number() == 1u);
+			CHECK(connection.get_mailbox_statistics().depth == 4u);
+
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{1, 2, 3, 4});
+			CHECK(connection.get_mailbox_statistics().depth == 0u);
+
+			transmitter.send(5);
+			CHECK(executor.get_tasks_number() == 2u);
+		}
+		SECTION("with drop_oldest policy") {
+			const mailbox_connection connection =
+				channel.connect_mailbox(mailbox_options{2, overflow_policy::drop_oldest}, &executor, callback);
+			transmitter.send_batch(std::vector<int>{1, 2, 3, 4});
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{3, 4});
+			CHECK(connection.get_mailbox_statistics().dropped_number == 2u);
+		}
+		SECTION("with drop_newest policy") {
+			const mailbox_connection connection =
+				channel.connect_mailbox(mailbox_options{2, overflow_policy::drop_newest}, &executor, callback);
+			transmitter.send_batch(std::vector<int>{1, 2, 3, 4});
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{1, 2});
+			CHECK(connection.get_mailbox_statistics().dropped_number == 2u);
+		}
+		SECTION("with conflate policy") {
+			const mailbox_connection connection =
+				channel.connect_mailbox(mailbox_options{8, overflow_policy::conflate}, &executor, callback);
+			transmitter.send(1);
+			transmitter.send(2);
+			transmitter.send(3);
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{3});
+			CHECK(connection.get_mailbox_statistics().dropped_number == 2u);
+		}
+		SECTION("with block_sender policy") {
+			thread_pool_executor thread_pool{1};
+			std::atomic<int> sum{0};
+			const mailbox_connection connection = channel.connect_mailbox(
+				mailbox_options{2, overflow_policy::block_sender}, &thread_pool,
+				[&sum](const int value) { sum += value; });
+
+			constexpr int values_number = 1000;
+			for (int i = 1; i <= values_number; ++i)
+				transmitter.send(i);
+
+			while (sum != values_number * (values_number + 1) / 2)
+				std::this_thread::yield();
+			CHECK(connection.get_mailbox_statistics().depth == 0u);
+			CHECK(connection.get_mailbox_statistics().dropped_number == 0u);
+		}
+		SECTION("disconnecting with blocked sender") {
+			mailbox_connection connection =
+				channel.connect_mailbox(mailbox_options{2, overflow_policy::block_sender}, &executor, callback);
+			transmitter.send_batch(std::vector<int>{1, 2});
+
+			// the task isn't run while the sender waits, so only disconnecting releases it
+			std::thread sender{[&transmitter] { transmitter.send(3); }};
+			std::this_thread::sleep_for(std::chrono::milliseconds{20});
+			connection.disconnect();
+			sender.join();
+
+			executor.run_all_tasks();
+			CHECK(values.empty());
+		}
+		SECTION("throwing from callback function with full mailbox and drop_newest policy") {
+			bool is_thrown = false;
+			const mailbox_connection connection = channel.connect_mailbox(
+				mailbox_options{2, overflow_policy::drop_newest}, &executor,
+				[&](const int value) {
+					values.push_back(value);
+					if (!is_thrown) {
+						is_thrown = true;
+						transmitter.send(3);
+						throw std::runtime_error{"test"};
+					}
+				});
+			transmitter.send_batch(std::vector<int>{1, 2});
+
+			CHECK_THROWS_AS(executor.run_all_tasks(), std::runtime_error);
+			CHECK(connection.get_mailbox_statistics().depth == 2u);
+			CHECK(executor.get_tasks_number() == 2u);
+			transmitter.send(4);
+			CHECK(connection.get_mailbox_statistics().dropped_number == 1u);
+
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{1, 2, 3});
+			CHECK(connection.get_mailbox_statistics().depth == 0u);
+
+			transmitter.send(5);
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{1, 2, 3, 5});
+		}
+		SECTION("throwing from callback function with full mailbox and block_sender policy") {
+			std::thread sender;
+			bool is_thrown = false;
+			const mailbox_connection connection = channel.connect_mailbox(
+				mailbox_options{2, overflow_policy::block_sender}, &executor,
+				[&](const int value) {
+					values.push_back(value);
+					if (!is_thrown) {
+						is_thrown = true;
+						// the sender pushes its value when the first one is taken
+						sender.join();
+						throw std::runtime_error{"test"};
+					}
+				});
+			transmitter.send_batch(std::vector<int>{1, 2});
+			sender = std::thread{[&transmitter] { transmitter.send(3); }};
+
+			CHECK_THROWS_AS(executor.run_all_tasks(), std::runtime_error);
+			CHECK(connection.get_mailbox_statistics().depth == 2u);
+			CHECK(executor.get_tasks_number() == 2u);
+
+			executor.run_all_tasks();
+			CHECK(values == std::vector<int>{1, 2, 3});
+			CHECK(connection.get_mailbox_statistics().depth == 0u);
+		}
+		SECTION("disconnecting") {
+			mailbox_connection connection = channel.connect_mailbox(mailbox_options{}, &executor, callback);
+			transmitter.send(1);
+			connection.disconnect();
+			executor.run_all_tasks();
+			CHECK(values.empty());
+			CHECK(connection.get_mailbox_statistics().depth == 0u);
+		}
+	}
+	SECTION("disconnecting from callback function of another channel") {
+		transmitter<channel<>> outer_transmitter;
+		transmitter<channel<>> inner_transmitter;
+		const auto counter = std::make_shared<int>(0);
+		connection inner_connection = inner_transmitter.get_channel().connect([counter] { ++*counter; });
+		const connection outer_connection = outer_transmitter.get_channel().connect([&] {
+			inner_transmitter.send();
+			inner_connection.disconnect();
+			inner_transmitter.send();
+		});
+
+		outer_transmitter.send();
+		CHECK(*counter == 1);
+		CHECK(counter.use_count() == 1);
+	}
+	SECTION("disconnecting while sending is blocked in other callback function") {
+		transmitter<channel<>> transmitter;
+		std::atomic<bool> is_blocked{false};
+		std::atomic<bool> is_released{false};
+		const connection blocked_connection = transmitter.get_channel().connect([&is_blocked, &is_released] {
+			is_blocked = true;
+			while (!is_released)
+				std::this_thread::yield();
+		});
+		const auto counter = std::make_shared<int>(0);
+		connection connection = transmitter.get_channel().connect([counter] { ++*counter; });
+
+		{
+			const tools::joining_thread thread{[&transmitter] { transmitter.send(); }};
+			while (!is_blocked)
+				std::this_thread::yield();
+
+			// the blocked sender can still access the disconnected socket, so its callback function is kept
+			connection.disconnect();
+			CHECK(counter.use_count() == 2);
+			is_released = true;
+		}
+
+		// the callback function is reclaimed when the sender leaves, without waiting for other changes of the channel
+		CHECK(*counter == 0);
+		CHECK(counter.use_count() == 1);
+	}
+	SECTION("disconnecting while callback function of another channel is blocked") {
+		transmitter<channel<>> blocked_transmitter;
+		transmitter<channel<>> other_transmitter;
+		std::atomic<bool> is_blocked{false};
+		std::atomic<bool> is_released{false};
+		const connection blocked_connection = blocked_transmitter.get_channel().connect([&is_blocked, &is_released] {
+			is_blocked = true;
+			while (!is_released)
+				std::this_thread::yield();
+		});
+		const tools::joining_thread thread{[&blocked_transmitter] { blocked_transmitter.send(); }};
+		while (!is_blocked)
+			std::this_thread::yield();
+
+		// the blocked sender doesn't delay the reclamation of the callback functions of other channels
+		const auto counter = std::make_shared<int>(0);
+		connection connection = other_transmitter.get_channel().connect([counter] { ++*counter; });
+		other_transmitter.send();
+		connection.disconnect();
+		CHECK(*counter == 1);
+		CHECK(counter.use_count() == 1);
+
+		is_released = true;
+	}
+	SECTION("testing method get_statistics") {
+		using channel_type = channel<int>;
+
+		SECTION("for channel without shared_state") {
+			CHECK_THROWS_AS(channel_type{}.get_statistics(), channel_error);
+		}
+		SECTION("for channel with shared_state") {
+			transmitter<channel_type> transmitter;
+			const channel_type& channel = transmitter.get_channel();
+
+			connection connection1;
+			const connection connection2 = channel.connect([&connection1](const int value) {
+				connection1.disconnect();
+				if (value != 0)
+					throw std::runtime_error{"Callback error"};
+			});
+			connection1 = channel.connect([](int) {});
+			CHECK(channel.get_statistics().subscribers_number == 2u);
+
+			CHECK_THROWS_AS(transmitter.send(1), callbacks_exception);
+			transmitter.send(0);
+
+			const channel_statistics statistics = channel.get_statistics();
+			CHECK(statistics.subscribers_number == 1u);
+#ifdef CHANNELS_STATISTICS
+			CHECK(statistics.sends_number == 2u);
+			CHECK(statistics.deliveries_number == 2u);
+			CHECK(statistics.exceptions_number == 1u);
+			CHECK(statistics.blocked_skips_number == 1u);
+			CHECK(statistics.peak_subscribers_number == 2u);
+			CHECK(std::accumulate(
+				statistics.send_durations_histogram.begin(), statistics.send_durations_histogram.end(), 0u) == 2u);
+#endif
+		}
+	}
 	SECTION("testing comparing functions") {
 		using channel_type = channel<>;
 
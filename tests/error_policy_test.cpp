@@ -0,0 +1,146 @@
+#include <channels/error_policy.h>
+#include <channels/buffered_channel.h>
+#include <channels/channel.h>
+#include <channels/error.h>
+#include <channels/keyed_channel.h>
+#include <channels/transmitter.h>
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+struct tick {
+	int value;
+};
+
+struct order {
+	int value;
+};
+
+} // namespace
+} // namespace test
+
+template<>
+struct error_policy_traits<channel<test::tick>> {
+	using type = policy::nothrow;
+};
+
+template<>
+struct error_policy_traits<buffered_channel<test::tick>> {
+	using type = policy::nothrow;
+};
+
+template<>
+struct error_policy_traits<channel<test::order>> {
+	using type = policy::fail_fast;
+};
+
+template<>
+struct error_policy_traits<buffered_channel<test::order>> {
+	using type = policy::fail_fast;
+};
+
+template<>
+struct error_policy_traits<keyed_channel<int, test::order>> {
+	using type = policy::fail_fast;
+};
+
+namespace test {
+namespace {
+
+TEST_CASE("Testing error policies", "[error_policy]") {
+	SECTION("checking callbacks allowed by policies") {
+		auto callback = [](const tick&) {};
+		auto noexcept_callback = [](const tick&) noexcept {};
+
+		CHECK(detail::is_allowed_callback<policy::collect_exceptions, decltype(callback), tick>::value);
+		CHECK(detail::is_allowed_callback<policy::fail_fast, decltype(callback), tick>::value);
+		CHECK_FALSE(detail::is_allowed_callback<policy::nothrow, decltype(callback), tick>::value);
+		CHECK(detail::is_allowed_callback<policy::nothrow, decltype(noexcept_callback), tick>::value);
+	}
+	SECTION("sending with policy nothrow") {
+		transmitter<channel<tick>> transmitter;
+		int sum = 0;
+		const connection connection1 = transmitter.get_channel().connect([&sum](const tick& t) noexcept {
+			sum += t.value;
+		});
+		const connection connection2 = transmitter.get_channel().connect([&sum](const tick& t) noexcept {
+			sum += t.value * 10;
+		});
+
+		transmitter.send(tick{1});
+		transmitter.send_batch(std::vector<tick>{{2}, {3}});
+		CHECK(sum == 66);
+	}
+	SECTION("sending to buffered_channel with policy nothrow") {
+		transmitter<buffered_channel<tick>> transmitter;
+		transmitter.send(tick{1});
+
+		int sum = 0;
+		const connection connection = transmitter.get_channel().connect([&sum](const tick& t) noexcept {
+			sum += t.value;
+		});
+		transmitter.send(tick{2});
+		CHECK(sum == 3);
+	}
+	SECTION("sending with policy fail_fast") {
+		std::vector<int> calls;
+		auto throwing_callback = [&calls](const order& o) {
+			calls.push_back(o.value);
+			throw std::runtime_error{"error"};
+		};
+		auto callback = [&calls](const order& o) { calls.push_back(o.value * 10); };
+
+		SECTION("channel") {
+			transmitter<channel<order>> transmitter;
+			const connection connection1 = transmitter.get_channel().connect(throwing_callback);
+			const connection connection2 = transmitter.get_channel().connect(callback);
+
+			try {
+				transmitter.send(order{1});
+				FAIL("callbacks_exception isn't thrown");
+			}
+			catch (const callbacks_exception& e) {
+				CHECK(e.get_exceptions().size() == 1u);
+			}
+			CHECK(calls == std::vector<int>{1});
+
+			CHECK_THROWS_AS(transmitter.send_batch(std::vector<order>{{2}, {3}}), callbacks_exception);
+			CHECK(calls == std::vector<int>{1, 2});
+		}
+		SECTION("buffered_channel") {
+			transmitter<buffered_channel<order>> transmitter;
+			const connection connection1 = transmitter.get_channel().connect(throwing_callback);
+			const connection connection2 = transmitter.get_channel().connect(callback);
+
+			CHECK_THROWS_AS(transmitter.send(order{1}), callbacks_exception);
+			CHECK(calls == std::vector<int>{1});
+		}
+		SECTION("keyed_channel") {
+			transmitter<keyed_channel<int, order>> transmitter;
+			const connection connection1 = transmitter.get_channel().connect(1, throwing_callback);
+			const connection connection2 = transmitter.get_channel().connect_all(callback);
+
+			CHECK_THROWS_AS(transmitter.send(1, order{1}), callbacks_exception);
+			CHECK(calls == std::vector<int>{1});
+			transmitter.send(2, order{2});
+			CHECK(calls == std::vector<int>{1, 20});
+		}
+	}
+	SECTION("sending with default policy") {
+		transmitter<channel<int>> transmitter;
+		int calls_number = 0;
+		const connection connection1 = transmitter.get_channel().connect([](int) { throw std::runtime_error{"error"}; });
+		const connection connection2 = transmitter.get_channel().connect([&calls_number](int) { ++calls_number; });
+
+		CHECK_THROWS_AS(transmitter.send(1), callbacks_exception);
+		CHECK(calls_number == 1);
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
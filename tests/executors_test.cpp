@@ -1,7 +1,14 @@
 #include <channels/utility/executors.h>
+#include <channels/channel.h>
+#include <channels/connection.h>
+#include <channels/transmitter.h>
 #include "tools/executor.h"
 #include <catch2/catch.hpp>
+#include <array>
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace channels {
 namespace test {
@@ -85,6 +92,93 @@ TEST_CASE("Testing tracking_executor class", "[tracking_executor]") {
 	}
 }
 
+TEST_CASE("Testing thread_pool_executor class", "[thread_pool_executor]") {
+	SECTION("default number of threads") {
+		const thread_pool_executor testing_executor;
+
+		CHECK(testing_executor.get_threads_number() >= 1u);
+	}
+	SECTION("running tasks") {
+		constexpr unsigned tasks_number = 1000;
+		std::atomic<unsigned> calls_number{0};
+		{
+			thread_pool_executor testing_executor{4};
+			CHECK(testing_executor.get_threads_number() == 4u);
+
+			for (unsigned i = 0; i < tasks_number; ++i)
+				execute(&testing_executor, [&calls_number] { ++calls_number; });
+		}
+
+		CHECK(calls_number == tasks_number);
+	}
+	SECTION("adding tasks from worker threads") {
+		constexpr unsigned tasks_number = 100;
+		constexpr unsigned subtasks_number = 100;
+		std::atomic<unsigned> calls_number{0};
+		{
+			thread_pool_executor testing_executor{4};
+
+			for (unsigned i = 0; i < tasks_number; ++i) {
+				execute(&testing_executor, [&testing_executor, &calls_number] {
+					// more subtasks than the capacity of the worker deque
+					for (unsigned j = 0; j < subtasks_number * 3; ++j)
+						execute(&testing_executor, [&calls_number] { ++calls_number; });
+				});
+			}
+		}
+
+		CHECK(calls_number == tasks_number * subtasks_number * 3);
+	}
+	SECTION("running large task") {
+		std::array<unsigned, 64> values{};
+		std::atomic<unsigned> sum{0};
+		values.fill(1);
+		{
+			thread_pool_executor testing_executor{1};
+			execute(&testing_executor, [values, &sum] {
+				for (const unsigned value : values)
+					sum += value;
+			});
+		}
+
+		CHECK(sum == values.size());
+	}
+	SECTION("binding threads to CPU") {
+		std::atomic<unsigned> calls_number{0};
+		{
+			thread_pool_executor testing_executor{2, {0}};
+			execute(&testing_executor, [&calls_number] { ++calls_number; });
+		}
+
+		CHECK(calls_number == 1u);
+	}
+	SECTION("connecting to channel") {
+		transmitter<channel<int>> transmitter;
+		std::atomic<int> sum{0};
+		std::atomic<unsigned> calls_number{0};
+		{
+			thread_pool_executor testing_executor{2};
+			std::vector<connection> connections;
+			for (unsigned i = 0; i < 3; ++i) {
+				connections.push_back(
+					transmitter.get_channel().connect(&testing_executor, [&sum, &calls_number](const int value) {
+						sum += value;
+						++calls_number;
+					}));
+			}
+
+			for (int i = 1; i <= 100; ++i)
+				transmitter.send(i);
+
+			// callback functions of disconnected connections aren't called, so wait for them before disconnecting
+			while (calls_number != 300u)
+				std::this_thread::yield();
+		}
+
+		CHECK(sum == 3 * 5050);
+	}
+}
+
 } // namespace
 } // namespace test
 } // namespace channels
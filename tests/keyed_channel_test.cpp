@@ -0,0 +1,199 @@
+#include <channels/keyed_channel.h>
+#include <channels/error.h>
+#include <channels/transmitter.h>
+#include "tools/executor.h"
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+TEST_CASE("Testing class keyed_channel", "[keyed_channel]") {
+	SECTION("testing method is_valid") {
+		using channel_type = keyed_channel<int>;
+
+		SECTION("for channel without shared_state") {
+			const channel_type channel;
+
+			CHECK_FALSE(channel.is_valid());
+		}
+		SECTION("for channel with shared_state") {
+			const transmitter<channel_type> transmitter;
+			const channel_type& channel = transmitter.get_channel();
+
+			CHECK(channel.is_valid());
+		}
+	}
+	SECTION("connecting callback to invalid channel") {
+		const keyed_channel<int> channel;
+
+		CHECK_THROWS_AS(channel.connect(1, [] {}), channel_error);
+		CHECK_THROWS_AS(channel.connect_all([] {}), channel_error);
+		CHECK_THROWS_AS(channel.get_keys_number(), channel_error);
+	}
+	SECTION("sending values to keys") {
+		using channel_type = keyed_channel<std::string, int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		std::vector<std::pair<std::string, int>> values;
+
+		const connection connection1 =
+			channel.connect("a", [&values](const int value) { values.emplace_back("a", value); });
+		const connection connection2 =
+			channel.connect("b", [&values](const int value) { values.emplace_back("b", value); });
+		const connection connection3 =
+			channel.connect("a", [&values](const int value) { values.emplace_back("a2", value); });
+		CHECK(channel.get_keys_number() == 2u);
+
+		transmitter.send("a", 1);
+		transmitter.send("b", 2);
+		transmitter.send("c", 3);
+		CHECK(values == std::vector<std::pair<std::string, int>>{{"a", 1}, {"a2", 1}, {"b", 2}});
+	}
+	SECTION("connecting callback to all keys") {
+		using channel_type = keyed_channel<int, int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		std::vector<int> order;
+
+		const connection connection1 = channel.connect_all([&order](const int value) { order.push_back(value * 10); });
+		const connection connection2 = channel.connect(1, [&order](const int value) { order.push_back(value); });
+
+		transmitter.send(1, 1);
+		transmitter.send(2, 2);
+		CHECK(order == std::vector<int>{1, 10, 20});
+	}
+	SECTION("connecting callback with executor") {
+		using channel_type = keyed_channel<int, std::string>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		tools::executor executor;
+		std::vector<std::string> values;
+
+		const connection connection1 =
+			channel.connect(1, &executor, [&values](const std::string& value) { values.push_back(value); });
+		const connection connection2 =
+			channel.connect_all(&executor, [&values](const std::string& value) { values.push_back("all:" + value); });
+
+		transmitter.send(1, "one");
+		transmitter.send(2, "two");
+		CHECK(values.empty());
+		executor.run_all_tasks();
+		CHECK(values == std::vector<std::string>{"one", "all:one", "all:two"});
+	}
+	SECTION("disconnecting") {
+		using channel_type = keyed_channel<int, int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		int sum = 0;
+
+		connection connection1 = channel.connect(1, [&sum](const int value) { sum += value; });
+		connection connection2 = channel.connect_all([&sum](const int value) { sum += value * 10; });
+		transmitter.send(1, 1);
+		CHECK(sum == 11);
+
+		connection1.disconnect();
+		transmitter.send(1, 1);
+		CHECK(sum == 21);
+
+		connection2.disconnect();
+		transmitter.send(1, 1);
+		CHECK(sum == 21);
+
+		// the key stays in the table and can be connected again
+		const connection connection3 = channel.connect(1, [&sum](const int value) { sum += value * 100; });
+		transmitter.send(1, 1);
+		CHECK(sum == 121);
+		CHECK(channel.get_keys_number() == 1u);
+	}
+	SECTION("disconnecting from callback") {
+		using channel_type = keyed_channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		int calls_number = 0;
+
+		connection connection;
+		connection = channel.connect(1, [&connection, &calls_number] {
+			++calls_number;
+			connection.disconnect();
+		});
+		transmitter.send(1);
+		transmitter.send(1);
+		CHECK(calls_number == 1);
+		CHECK_FALSE(connection.is_connected());
+	}
+	SECTION("connecting many keys") {
+		using channel_type = keyed_channel<int, int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		constexpr int keys_number = 10000;
+		std::vector<int> values(keys_number);
+
+		std::vector<connection> connections;
+		for (int key = 0; key < keys_number; ++key) {
+			connections.push_back(channel.connect(key, [&values, key](const int value) {
+				values[static_cast<std::size_t>(key)] += value;
+			}));
+		}
+		CHECK(channel.get_keys_number() == static_cast<std::size_t>(keys_number));
+
+		for (int key = 0; key < keys_number; ++key)
+			transmitter.send(key, key);
+		for (int key = 0; key < keys_number; ++key)
+			CHECK(values[static_cast<std::size_t>(key)] == key);
+	}
+	SECTION("sending while other keys are connected") {
+		using channel_type = keyed_channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		constexpr int keys_number = 1000;
+		constexpr int sends_number = 10000;
+		std::atomic<int> calls_number{0};
+
+		const connection connection = channel.connect(0, [&calls_number] { ++calls_number; });
+		std::thread sender{[&transmitter] {
+			for (int i = 0; i < sends_number; ++i)
+				transmitter.send(0);
+		}};
+
+		// the key index grows several times while the sender looks up its key
+		std::vector<channels::connection> connections;
+		for (int key = 1; key <= keys_number; ++key)
+			connections.push_back(channel.connect(key, [] {}));
+		sender.join();
+
+		CHECK(calls_number == sends_number);
+		CHECK(channel.get_keys_number() == static_cast<std::size_t>(keys_number + 1));
+	}
+	SECTION("throwing exceptions from callbacks") {
+		using channel_type = keyed_channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+		int calls_number = 0;
+
+		const connection connection1 = channel.connect(1, [] { throw std::runtime_error{"key"}; });
+		const connection connection2 = channel.connect_all([&calls_number] { ++calls_number; });
+
+		CHECK_THROWS_AS(transmitter.send(1), callbacks_exception);
+		CHECK(calls_number == 1);
+	}
+	SECTION("comparing channels") {
+		using channel_type = keyed_channel<int>;
+		const transmitter<channel_type> transmitter1;
+		const transmitter<channel_type> transmitter2;
+
+		CHECK(transmitter1.get_channel() == transmitter1.get_channel());
+		CHECK(transmitter1.get_channel() != transmitter2.get_channel());
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
@@ -0,0 +1,89 @@
+#include <channels/utility/pipeline.h>
+#include <channels/buffered_channel.h>
+#include <channels/channel.h>
+#include <channels/error.h>
+#include <channels/transmitter.h>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+TEST_CASE("Testing pipeline syntax", "[pipeline]") {
+	SECTION("connecting source channel to destination channel directly") {
+		transmitter<channel<int>> source;
+		const transponder<buffered_channel<int>> destination = source.get_channel() | into<buffered_channel<int>>();
+
+		source.send(1);
+		REQUIRE(destination.get_channel().get_value());
+		CHECK(std::get<0>(*destination.get_channel().get_value()) == 1);
+	}
+	SECTION("composing filters and transformations") {
+		transmitter<channel<std::string>> source;
+		const transponder<buffered_channel<std::size_t>> destination =
+			source.get_channel()
+			| filter([](const std::string& s) { return !s.empty(); })
+			| transform([](const std::string& s) { return s.length(); })
+			| filter([](const std::size_t length) { return length % 2 == 0; })
+			| into<buffered_channel<std::size_t>>();
+
+		std::vector<std::size_t> values;
+		const connection connection =
+			destination.get_channel().connect([&values](const std::size_t value) { values.push_back(value); });
+
+		for (const char* const s : {"", "ab", "abc", "abcd"})
+			source.send(s);
+		CHECK(values == std::vector<std::size_t>{2, 4});
+	}
+	SECTION("unpacking tuples between stages") {
+		transmitter<channel<int>> source;
+		const transponder<buffered_channel<int, std::string>> destination =
+			source.get_channel()
+			| transform([](const int value) { return std::make_tuple(value, std::to_string(value)); })
+			| filter([](const int value, const std::string&) { return value > 0; })
+			| transform([](const int value, const std::string& s) { return std::make_tuple(value * 2, s + "!"); })
+			| into<buffered_channel<int, std::string>>();
+
+		source.send(-1);
+		CHECK_FALSE(destination.get_channel().get_value());
+
+		source.send(21);
+		REQUIRE(destination.get_channel().get_value());
+		CHECK(*destination.get_channel().get_value() == std::make_tuple(42, std::string{"21!"}));
+	}
+	SECTION("passing tuple to destination channel of tuples") {
+		transmitter<channel<int>> source;
+		using channel_type = buffered_channel<std::tuple<int>>;
+		const transponder<channel_type> destination =
+			source.get_channel() | transform([](const int value) { return std::make_tuple(value); }) | into<channel_type>();
+
+		source.send(1);
+		REQUIRE(destination.get_channel().get_value());
+		CHECK(std::get<0>(*destination.get_channel().get_value()) == std::make_tuple(1));
+	}
+	SECTION("transforming to signal without arguments") {
+		transmitter<channel<int>> source;
+		int counter = 0;
+		const transponder<channel<>> destination =
+			source.get_channel() | transform([&counter](const int value) { counter += value; }) | into<channel<>>();
+		int signals_number = 0;
+		const connection connection = destination.get_channel().connect([&signals_number] { ++signals_number; });
+
+		source.send(2);
+		source.send(3);
+		CHECK(counter == 5);
+		CHECK(signals_number == 2);
+	}
+	SECTION("connecting to invalid channel") {
+		CHECK_THROWS_AS(
+			channel<int>{} | filter([](int) { return true; }) | into<channel<int>>(), channel_error);
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
@@ -0,0 +1,186 @@
+#include <channels/queue_channel.h>
+#include <channels/transmitter.h>
+#include "tools/thread_helpers.h"
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+TEST_CASE("Testing class queue_channel", "[queue_channel]") {
+	SECTION("testing method is_valid") {
+		using channel_type = queue_channel<int>;
+
+		SECTION("for channel without shared_state") {
+			const channel_type channel;
+
+			CHECK_FALSE(channel.is_valid());
+		}
+		SECTION("for channel with shared_state") {
+			const transmitter<channel_type> transmitter;
+			const channel_type& channel = transmitter.get_channel();
+
+			CHECK(channel.is_valid());
+		}
+	}
+	SECTION("receiving from invalid channel") {
+		const queue_channel<int> channel;
+		std::tuple<int> value;
+		std::vector<std::tuple<int>> values;
+
+		CHECK_THROWS_AS(channel.get_capacity(), channel_error);
+		CHECK_THROWS_AS(channel.try_receive(value), channel_error);
+		CHECK_THROWS_AS(channel.receive(value), channel_error);
+		CHECK_THROWS_AS(channel.receive_for(value, std::chrono::milliseconds{1}), channel_error);
+		CHECK_THROWS_AS(channel.receive_batch(std::back_inserter(values), 1), channel_error);
+	}
+	SECTION("sending and receiving values") {
+		using channel_type = queue_channel<int, std::string>;
+		transmitter<channel_type> transmitter{4u};
+		const channel_type& channel = transmitter.get_channel();
+		CHECK(channel.get_capacity() == 4u);
+
+		std::tuple<int, std::string> value;
+		CHECK_FALSE(channel.try_receive(value));
+
+		CHECK(transmitter.send(1, "one"));
+		CHECK(transmitter.send(2, "two"));
+		REQUIRE(channel.try_receive(value));
+		CHECK(value == std::make_tuple(1, std::string{"one"}));
+		channel.receive(value);
+		CHECK(value == std::make_tuple(2, std::string{"two"}));
+		CHECK_FALSE(channel.try_receive(value));
+	}
+	SECTION("sending to full queue") {
+		using channel_type = queue_channel<int>;
+		transmitter<channel_type> transmitter{2u};
+		const channel_type& channel = transmitter.get_channel();
+
+		CHECK(transmitter.send(1));
+		CHECK(transmitter.send(2));
+		CHECK_FALSE(transmitter.send(3));
+
+		std::tuple<int> value;
+		REQUIRE(channel.try_receive(value));
+		CHECK(std::get<0>(value) == 1);
+		CHECK(transmitter.send(4));
+	}
+	SECTION("sending and receiving batch") {
+		using channel_type = queue_channel<int>;
+		transmitter<channel_type> transmitter{4u};
+		const channel_type& channel = transmitter.get_channel();
+
+		CHECK(transmitter.send_batch(std::vector<int>{1, 2, 3, 4, 5}) == 4u);
+
+		std::vector<std::tuple<int>> values;
+		CHECK(channel.receive_batch(std::back_inserter(values), 3) == 3u);
+		CHECK(channel.receive_batch(std::back_inserter(values), 3) == 1u);
+		CHECK(channel.receive_batch(std::back_inserter(values), 0) == 0u);
+		CHECK(values == std::vector<std::tuple<int>>{1, 2, 3, 4});
+	}
+	SECTION("receiving with timeout") {
+		using channel_type = queue_channel<int>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		std::tuple<int> value{0};
+		CHECK_FALSE(channel.receive_for(value, std::chrono::milliseconds{10}));
+		CHECK(std::get<0>(value) == 0);
+
+		CHECK(transmitter.send(1));
+		CHECK(channel.receive_for(value, std::chrono::milliseconds{10}));
+		CHECK(std::get<0>(value) == 1);
+	}
+	SECTION("receiving values of move-only type") {
+		using channel_type = queue_channel<std::unique_ptr<int>>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		CHECK(transmitter.send(std::make_unique<int>(5)));
+
+		std::tuple<std::unique_ptr<int>> value;
+		REQUIRE(channel.try_receive(value));
+		REQUIRE(std::get<0>(value));
+		CHECK(*std::get<0>(value) == 5);
+	}
+	SECTION("async sending and receiving") {
+		using channel_type = queue_channel<int>;
+		transmitter<channel_type> transmitter{16u};
+		const channel_type& channel = transmitter.get_channel();
+
+		constexpr int values_number = 10000;
+		constexpr std::size_t consumers_number = 4;
+		std::vector<long long> sums(consumers_number, 0);
+		std::atomic<std::size_t> stopped_consumers_number{0};
+
+		{
+			std::vector<tools::joining_thread> consumers;
+			for (std::size_t i = 0; i < consumers_number; ++i) {
+				consumers.emplace_back([&channel, &sum = sums[i], &stopped_consumers_number] {
+					std::vector<std::tuple<int>> values;
+					for (;;) {
+						values.clear();
+						channel.receive_batch(std::back_inserter(values), 8);
+						for (const std::tuple<int>& value : values) {
+							// a negative value stops the consumer (the values after it are negative too)
+							if (std::get<0>(value) < 0) {
+								++stopped_consumers_number;
+								return;
+							}
+
+							sum += std::get<0>(value);
+						}
+					}
+				});
+			}
+
+			for (int i = 1; i <= values_number; ++i) {
+				while (!transmitter.send(i))
+					std::this_thread::yield();
+			}
+			while (stopped_consumers_number != consumers_number) {
+				(void) transmitter.send(-1);
+				std::this_thread::yield();
+			}
+		}
+
+		long long sum = 0;
+		for (const long long consumer_sum : sums)
+			sum += consumer_sum;
+		CHECK(sum == static_cast<long long>(values_number) * (values_number + 1) / 2);
+	}
+	SECTION("testing comparing functions") {
+		using channel_type = queue_channel<>;
+
+		SECTION("comparing channels without shared state") {
+			CHECK(channel_type{} == channel_type{});
+		}
+		SECTION("comparing equal channels") {
+			transmitter<channel_type> transmitter;
+			const channel_type& channel = transmitter.get_channel();
+
+			CHECK(channel == channel);
+		}
+		SECTION("comparing not equal channels") {
+			transmitter<channel_type> transmitter1;
+			const channel_type& channel1 = transmitter1.get_channel();
+			transmitter<channel_type> transmitter2;
+			const channel_type& channel2 = transmitter2.get_channel();
+
+			CHECK(channel1 != channel2);
+		}
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
@@ -0,0 +1,183 @@
+#include <channels/utility/recorder.h>
+
+#ifdef CHANNELS_HAS_MMAP
+
+#include <channels/buffered_channel.h>
+#include <channels/channel.h>
+#include <channels/error.h>
+#include <channels/error_policy.h>
+#include <channels/transmitter.h>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+struct tick {
+	int value;
+};
+
+} // namespace
+} // namespace test
+
+template<>
+struct error_policy_traits<channel<test::tick>> {
+	using type = policy::nothrow;
+};
+
+namespace test {
+namespace {
+
+struct string_codec {
+	using value_type = std::tuple<std::string>;
+
+	void encode(const value_type& value, std::vector<unsigned char>& buffer) const
+	{
+		const std::string& string = std::get<0>(value);
+		buffer.insert(buffer.end(), string.begin(), string.end());
+	}
+
+	value_type decode(const unsigned char* const data, const std::size_t size) const
+	{
+		return value_type{std::string(reinterpret_cast<const char*>(data), size)}; // NOLINT
+	}
+};
+
+// Removes the log file at the end of the test.
+class temporary_path {
+public:
+	temporary_path()
+		: path_{"/tmp/channels_recorder_test_" + std::to_string(getpid()) + ".log"}
+	{}
+
+	temporary_path(const temporary_path&) = delete;
+	temporary_path& operator=(const temporary_path&) = delete;
+
+	~temporary_path()
+	{
+		std::remove(path_.c_str());
+	}
+
+	const std::string& get() const noexcept
+	{
+		return path_;
+	}
+
+private:
+	std::string path_;
+};
+
+TEST_CASE("Testing classes recorder and replayer", "[recorder]") {
+	const temporary_path path;
+
+	SECTION("recording and replaying values") {
+		using channel_type = channel<int, double>;
+		using codec_type = trivial_codec<int, double>;
+		transmitter<channel_type> source;
+		{
+			recorder<codec_type> recorder{source.get_channel(), path.get(), 1024};
+			source.send(1, 1.5);
+			source.send_batch(std::vector<std::tuple<int, double>>{{2, 2.5}, {3, 3.5}});
+		}
+
+		transmitter<channel_type> destination;
+		std::vector<std::tuple<int, double>> values;
+		const connection connection = destination.get_channel().connect(
+			[&values](const int number, const double value) { values.emplace_back(number, value); });
+
+		replayer<codec_type> replayer{path.get()};
+		CHECK(replayer.replay(destination, replay_pacing::as_fast_as_possible) == 3u);
+		CHECK(values == std::vector<std::tuple<int, double>>{{1, 1.5}, {2, 2.5}, {3, 3.5}});
+
+		// the log can be replayed again
+		CHECK(replayer.replay(destination, replay_pacing::as_fast_as_possible) == 3u);
+		CHECK(values.size() == 6u);
+	}
+	SECTION("replaying with recorded pacing") {
+		using channel_type = buffered_channel<std::string>;
+		transmitter<channel_type> source;
+		source.send("first");
+		{
+			recorder<string_codec> recorder{source.get_channel(), path.get(), 1024};
+			std::this_thread::sleep_for(std::chrono::milliseconds{20});
+			source.send("second");
+		}
+
+		transmitter<channel_type> destination;
+		replayer<string_codec> replayer{path.get()};
+		const auto start_time = std::chrono::steady_clock::now();
+		CHECK(replayer.replay(destination) == 2u);
+		CHECK(std::chrono::steady_clock::now() - start_time >= std::chrono::milliseconds{20});
+		CHECK(*destination.get_channel().get_value() == std::make_tuple(std::string{"second"}));
+	}
+	SECTION("dropping values if log file is full") {
+		using channel_type = channel<int>;
+		transmitter<channel_type> source;
+		{
+			// the file has space only for one record of 12 bytes of the header and 4 bytes of the value
+			recorder<trivial_codec<int>> recorder{source.get_channel(), path.get(), 20};
+			source.send(1);
+			source.send(2);
+		}
+
+		transmitter<channel_type> destination;
+		int last_value = 0;
+		const connection connection =
+			destination.get_channel().connect([&last_value](const int value) { last_value = value; });
+		replayer<trivial_codec<int>> replayer{path.get()};
+		CHECK(replayer.replay(destination, replay_pacing::as_fast_as_possible) == 1u);
+		CHECK(last_value == 1);
+	}
+	SECTION("counting recorded values") {
+		transmitter<channel<int>> source;
+		recorder<trivial_codec<int>> recorder{source.get_channel(), path.get(), 1024};
+		CHECK(recorder.get_recorded_number() == 0u);
+		CHECK(recorder.get_dropped_number() == 0u);
+
+		source.send(1);
+		while (recorder.get_recorded_number() == 0)
+			std::this_thread::yield();
+		CHECK(recorder.get_dropped_number() == 0u);
+	}
+	SECTION("recording channel with nothrow policy") {
+		transmitter<channel<tick>> source;
+		recorder<trivial_codec<tick>> recorder{source.get_channel(), path.get(), 1024};
+
+		source.send(tick{1});
+		while (recorder.get_recorded_number() == 0)
+			std::this_thread::yield();
+		CHECK(recorder.get_dropped_number() == 0u);
+	}
+	SECTION("handling errors") {
+		CHECK_THROWS_AS(replayer<trivial_codec<int>>{path.get()}, std::system_error);
+		CHECK_THROWS_AS(
+			recorder<trivial_codec<int>>(channel<int>{}, path.get(), 1024), channel_error);
+		CHECK_THROWS_AS(
+			recorder<trivial_codec<int>>(channel<int>{}, "/nonexistent/directory/log", 1024), std::system_error);
+
+		{
+			transmitter<channel<int>> source;
+			const recorder<trivial_codec<int>> recorder{source.get_channel(), path.get(), 1024};
+			source.send(1);
+		}
+		transmitter<channel<double>> destination;
+		replayer<trivial_codec<double>> replayer{path.get()};
+		CHECK_THROWS_AS(replayer.replay(destination), std::runtime_error);
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
+
+#endif
@@ -0,0 +1,211 @@
+#include <channels/ring_channel.h>
+#include <channels/transmitter.h>
+#include "tools/thread_helpers.h"
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+TEST_CASE("Testing class ring_channel", "[ring_channel]") {
+	SECTION("testing method is_valid") {
+		using channel_type = ring_channel<int, 4>;
+
+		SECTION("for channel without shared_state") {
+			const channel_type channel;
+
+			CHECK_FALSE(channel.is_valid());
+			CHECK_THROWS_AS(channel.make_reader(), channel_error);
+			CHECK_THROWS_AS(channel.get_max_lag(), channel_error);
+		}
+		SECTION("for channel with shared_state") {
+			const transmitter<channel_type> transmitter;
+			const channel_type& channel = transmitter.get_channel();
+
+			CHECK(channel.is_valid());
+		}
+		SECTION("for reader") {
+			channel_type::reader reader;
+			int value = 0;
+
+			CHECK_FALSE(reader.is_valid());
+			CHECK_THROWS_AS(reader.get_lag(), channel_error);
+			CHECK_THROWS_AS(reader.try_read(value), channel_error);
+		}
+	}
+	SECTION("reading values") {
+		using channel_type = ring_channel<std::string, 4>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		transmitter.send("lost");
+		channel_type::reader reader1 = channel.make_reader();
+		channel_type::reader reader2 = channel.make_reader(wait_strategy::busy_spin);
+
+		std::string value;
+		CHECK_FALSE(reader1.try_read(value));
+
+		transmitter.send("one");
+		transmitter.send("two");
+		CHECK(reader1.get_lag() == 2u);
+		CHECK(channel.get_max_lag() == 2u);
+
+		REQUIRE(reader1.try_read(value));
+		CHECK(value == "one");
+		reader1.read(value);
+		CHECK(value == "two");
+		CHECK(reader1.get_lag() == 0u);
+		CHECK(channel.get_max_lag() == 2u);
+
+		// each reader gets all values
+		std::vector<std::string> values;
+		CHECK(reader2.read_batch(std::back_inserter(values), 10) == 2u);
+		CHECK(values == std::vector<std::string>{"one", "two"});
+		CHECK(channel.get_max_lag() == 0u);
+	}
+	SECTION("reading with timeout") {
+		using channel_type = ring_channel<int, 4>;
+		transmitter<channel_type> transmitter;
+		channel_type::reader reader = transmitter.get_channel().make_reader(wait_strategy::block);
+
+		int value = 0;
+		CHECK_FALSE(reader.read_for(value, std::chrono::milliseconds{10}));
+		CHECK(value == 0);
+
+		transmitter.send(1);
+		CHECK(reader.read_for(value, std::chrono::milliseconds{10}));
+		CHECK(value == 1);
+	}
+	SECTION("moving and destroying reader") {
+		using channel_type = ring_channel<int, 2>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		channel_type::reader reader1 = channel.make_reader();
+		transmitter.send(1);
+		channel_type::reader reader2 = std::move(reader1);
+		CHECK_FALSE(reader1.is_valid()); // NOLINT(bugprone-use-after-move)
+		CHECK(reader2.get_lag() == 1u);
+
+		reader2 = channel_type::reader{};
+		CHECK(channel.get_max_lag() == 0u);
+		// the transmitter isn't blocked by the destroyed reader
+		transmitter.send_batch(std::vector<int>{2, 3, 4, 5});
+	}
+	SECTION("async sending and reading") {
+		using channel_type = ring_channel<int, 8>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		constexpr int values_number = 10000;
+		const std::vector<wait_strategy> strategies{
+			wait_strategy::busy_spin, wait_strategy::yield, wait_strategy::block};
+		std::vector<long long> sums(strategies.size(), 0);
+
+		{
+			std::vector<tools::joining_thread> readers;
+			for (std::size_t i = 0; i < strategies.size(); ++i) {
+				readers.emplace_back(
+					[reader = channel.make_reader(strategies[i]), &sum = sums[i]]() mutable {
+						std::vector<int> values;
+						for (;;) {
+							values.clear();
+							reader.read_batch(std::back_inserter(values), 5);
+							for (const int value : values) {
+								if (value < 0)
+									return;
+
+								sum += value;
+							}
+						}
+					});
+			}
+
+			std::vector<int> batch(100);
+			for (int i = 1; i <= values_number; i += static_cast<int>(batch.size())) {
+				std::iota(batch.begin(), batch.end(), i);
+				transmitter.send_batch(batch);
+			}
+			transmitter.send(-1);
+		}
+
+		const long long expected_sum = static_cast<long long>(values_number) * (values_number + 1) / 2;
+		for (const long long sum : sums)
+			CHECK(sum == expected_sum);
+	}
+	SECTION("making reader while sending batch longer than ring") {
+		using channel_type = ring_channel<int, 4>;
+		transmitter<channel_type> transmitter;
+		const channel_type& channel = transmitter.get_channel();
+
+		// runs the hook when the transmitter writes the value to the slot
+		struct hooked_value {
+			operator int() const // NOLINT(google-explicit-constructor)
+			{
+				if (hook)
+					hook();
+				return value;
+			}
+
+			int value;
+			std::function<void()> hook;
+		};
+
+		channel_type::reader first_reader = channel.make_reader();
+		for (int i = 0; i < 4; ++i)
+			transmitter.send(i);
+		std::vector<int> values;
+		REQUIRE(first_reader.read_batch(std::back_inserter(values), 2) == 2u);
+
+		std::promise<channel_type::reader> second_reader_promise;
+		std::vector<hooked_value> batch;
+		for (int i = 4; i < 12; ++i)
+			batch.push_back(hooked_value{i, {}});
+		// the transmitter stops waiting for the first reader in the middle of the batch
+		batch[1].hook = [&first_reader] { first_reader = channel_type::reader{}; };
+		// the new reader starts from the published values 4..7 while the values 8.. aren't written yet
+		batch[2].hook = [&channel, &second_reader_promise] {
+			second_reader_promise.set_value(channel.make_reader());
+		};
+
+		const tools::joining_thread thread{[&transmitter, &batch] { transmitter.send_batch(batch); }};
+
+		channel_type::reader second_reader = second_reader_promise.get_future().get();
+		// gives the transmitter time to overwrite the slots if it doesn't wait for the new reader
+		std::this_thread::sleep_for(std::chrono::milliseconds{20});
+		values.clear();
+		while (values.size() != batch.size())
+			(void) second_reader.read_batch(std::back_inserter(values), batch.size() - values.size());
+
+		std::vector<int> expected_values(batch.size());
+		std::iota(expected_values.begin(), expected_values.end(), 4);
+		CHECK(values == expected_values);
+	}
+	SECTION("testing comparing functions") {
+		using channel_type = ring_channel<int, 2>;
+
+		SECTION("comparing channels without shared state") {
+			CHECK(channel_type{} == channel_type{});
+		}
+		SECTION("comparing not equal channels") {
+			transmitter<channel_type> transmitter1;
+			transmitter<channel_type> transmitter2;
+
+			CHECK(transmitter1.get_channel() != transmitter2.get_channel());
+		}
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
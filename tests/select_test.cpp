@@ -0,0 +1,130 @@
+#include <channels/buffered_channel.h>
+#include <channels/queue_channel.h>
+#include <channels/select.h>
+#include <channels/transmitter.h>
+#include "tools/thread_helpers.h"
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <tuple>
+
+namespace channels {
+namespace test {
+namespace {
+
+TEST_CASE("Testing class selector", "[selector]") {
+	using queue_channel_type = queue_channel<int>;
+	using buffered_channel_type = buffered_channel<int>;
+
+	SECTION("adding invalid channels") {
+		selector selector;
+
+		CHECK_THROWS_AS(selector.add(queue_channel_type{}), channel_error);
+		CHECK_THROWS_AS(selector.add(buffered_channel_type{}), channel_error);
+		CHECK(selector.get_size() == 0u);
+	}
+	SECTION("selecting queue_channel") {
+		transmitter<queue_channel_type> transmitter;
+		const queue_channel_type& channel = transmitter.get_channel();
+
+		selector selector;
+		CHECK(selector.add(channel) == 0u);
+		CHECK(selector.get_size() == 1u);
+		CHECK(selector.try_select() == selector::npos);
+
+		CHECK(transmitter.send(1));
+		CHECK(selector.try_select() == 0u);
+		// the channel is ready until its queue is empty
+		CHECK(selector.try_select() == 0u);
+
+		std::tuple<int> value;
+		REQUIRE(channel.try_receive(value));
+		CHECK(selector.try_select() == selector::npos);
+	}
+	SECTION("selecting buffered_channel") {
+		transmitter<buffered_channel_type> transmitter;
+		const buffered_channel_type& channel = transmitter.get_channel();
+
+		transmitter.send(1);
+		selector selector;
+		CHECK(selector.add(channel) == 0u);
+		// the value sent before the addition is reported once
+		CHECK(selector.try_select() == 0u);
+		CHECK(selector.try_select() == selector::npos);
+
+		transmitter.send(2);
+		transmitter.send(3);
+		CHECK(selector.try_select() == 0u);
+		CHECK(selector.try_select() == selector::npos);
+	}
+	SECTION("selecting channels in round-robin order") {
+		transmitter<queue_channel_type> transmitter1;
+		transmitter<queue_channel_type> transmitter2;
+		transmitter<buffered_channel_type> transmitter3;
+
+		selector selector;
+		CHECK(selector.add(transmitter1.get_channel()) == 0u);
+		CHECK(selector.add(transmitter2.get_channel()) == 1u);
+		CHECK(selector.add(transmitter3.get_channel()) == 2u);
+
+		CHECK(transmitter1.send(1));
+		CHECK(transmitter2.send(2));
+		transmitter3.send(3);
+
+		CHECK(selector.try_select() == 0u);
+		CHECK(selector.try_select() == 1u);
+		CHECK(selector.try_select() == 2u);
+		CHECK(selector.try_select() == 0u);
+		CHECK(selector.try_select() == 1u);
+		CHECK(selector.try_select() == 0u);
+	}
+	SECTION("selecting with timeout") {
+		transmitter<queue_channel_type> transmitter;
+
+		selector selector;
+		(void) selector.add(transmitter.get_channel());
+		CHECK(selector.select_for(std::chrono::milliseconds{10}) == selector::npos);
+
+		CHECK(transmitter.send(1));
+		CHECK(selector.select_for(std::chrono::milliseconds{10}) == 0u);
+	}
+	SECTION("waking up blocked selector") {
+		transmitter<queue_channel_type> transmitter1;
+		transmitter<buffered_channel_type> transmitter2;
+
+		selector selector;
+		(void) selector.add(transmitter1.get_channel());
+		(void) selector.add(transmitter2.get_channel());
+
+		for (std::size_t index = 0; index < 2; ++index) {
+			const tools::joining_thread sender{[&transmitter1, &transmitter2, index] {
+				std::this_thread::sleep_for(std::chrono::milliseconds{10});
+				// Catch2 assertions aren't thread safe
+				if (index == 0)
+					(void) transmitter1.send(1);
+				else
+					transmitter2.send(2);
+			}};
+
+			CHECK(selector.select() == index);
+			std::tuple<int> value;
+			(void) transmitter1.get_channel().try_receive(value);
+		}
+	}
+	SECTION("testing functions select and try_select") {
+		transmitter<queue_channel_type> transmitter1;
+		transmitter<queue_channel_type> transmitter2;
+		const queue_channel_type& channel1 = transmitter1.get_channel();
+		const queue_channel_type& channel2 = transmitter2.get_channel();
+
+		CHECK(try_select(channel1, channel2) == selector::npos);
+		CHECK(transmitter2.send(1));
+		CHECK(try_select(channel1, channel2) == 1u);
+		CHECK(select(channel1, channel2) == 1u);
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
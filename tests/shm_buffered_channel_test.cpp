@@ -0,0 +1,220 @@
+#include <channels/shm_buffered_channel.h>
+
+#ifdef CHANNELS_HAS_SHARED_MEMORY
+
+#include <channels/transmitter.h>
+#include "tools/thread_helpers.h"
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+struct snapshot {
+	int id;
+	double value;
+};
+
+std::string make_name(const char* const suffix)
+{
+	return "/channels_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+TEST_CASE("Testing class shm_buffered_channel", "[shm_buffered_channel]") {
+	using channel_type = shm_buffered_channel<snapshot>;
+
+	SECTION("testing method is_valid") {
+		SECTION("for channel without shared_state") {
+			const channel_type channel;
+			snapshot value{};
+
+			CHECK_FALSE(channel.is_valid());
+			CHECK_THROWS_AS(channel.read_value(value), channel_error);
+			CHECK_THROWS_AS(channel.get_version(), channel_error);
+		}
+		SECTION("for channel with shared_state") {
+			const std::string name = make_name("valid");
+			const transmitter<channel_type> transmitter{name};
+			const channel_type channel{name};
+
+			CHECK(transmitter.get_channel().is_valid());
+			CHECK(channel.is_valid());
+		}
+	}
+	SECTION("opening channel") {
+		const std::string name = make_name("open");
+
+		CHECK_THROWS_AS(channel_type{name}, channel_error);
+		{
+			const transmitter<channel_type> transmitter{name};
+			CHECK_THROWS_AS(shm_buffered_channel<char>{name}, channel_error);
+		}
+		// the shared memory object is removed with the transmitter
+		CHECK_THROWS_AS(channel_type{name}, channel_error);
+	}
+	SECTION("replacing transmitter") {
+		const std::string name = make_name("replace");
+		auto old_transmitter = std::make_unique<transmitter<channel_type>>(name);
+		{
+			transmitter<channel_type> new_transmitter{name};
+			new_transmitter.send(snapshot{1, 1.5});
+
+			// the replaced transmitter doesn't remove the object of the new one
+			old_transmitter.reset();
+			const channel_type channel{name};
+			snapshot value{};
+			CHECK(channel.read_value(value));
+			CHECK(value.id == 1);
+		}
+		CHECK_THROWS_AS(channel_type{name}, channel_error);
+	}
+	SECTION("reading values") {
+		const std::string name = make_name("read");
+		channel_type channel;
+		{
+			transmitter<channel_type> transmitter{name};
+			channel = channel_type{name};
+
+			snapshot value{0, 0.0};
+			CHECK_FALSE(channel.read_value(value));
+			CHECK(channel.get_version() == 0u);
+
+			transmitter.send(snapshot{1, 1.5});
+			REQUIRE(channel.read_value(value));
+			CHECK(value.id == 1);
+			CHECK(value.value == 1.5);
+			CHECK(channel.get_version() == 1u);
+
+			transmitter.send_batch(std::vector<snapshot>{{2, 2.5}, {3, 3.5}});
+			REQUIRE(channel.read_value(value));
+			CHECK(value.id == 3);
+			CHECK(channel.get_version() == 2u);
+			CHECK(transmitter.get_channel().get_version() == 2u);
+		}
+
+		// the opened channel keeps the last value
+		snapshot value{0, 0.0};
+		REQUIRE(channel.read_value(value));
+		CHECK(value.id == 3);
+	}
+	SECTION("waiting values") {
+		const std::string name = make_name("wait");
+		transmitter<channel_type> transmitter{name};
+		const channel_type channel{name};
+
+		std::uint32_t version = channel.get_version();
+		CHECK_FALSE(channel.wait_update_for(version, std::chrono::milliseconds{10}));
+		CHECK(version == 0u);
+
+		tools::joining_thread sender{[&transmitter] { transmitter.send(snapshot{1, 1.0}); }};
+		channel.wait_update(version);
+		CHECK(version == 1u);
+		CHECK(channel.wait_update_for(version, std::chrono::seconds{0}) == false);
+	}
+	SECTION("closing channel") {
+		const std::string name = make_name("close");
+		auto owner = std::make_unique<transmitter<channel_type>>(name);
+		const channel_type channel{name};
+		CHECK_FALSE(channel.is_closed());
+
+		std::atomic<bool> is_woken_up{false};
+		{
+			tools::joining_thread reader{[&channel, &is_woken_up] {
+				std::uint32_t version = 0;
+				try {
+					channel.wait_update(version);
+				}
+				catch (const channel_error&) {
+					is_woken_up = true;
+				}
+			}};
+			std::this_thread::sleep_for(std::chrono::milliseconds{10});
+			owner.reset();
+		}
+
+		CHECK(is_woken_up);
+		CHECK(channel.is_closed());
+		std::uint32_t version = 0;
+		CHECK_THROWS_AS(channel.wait_update_for(version, std::chrono::seconds{1}), channel_error);
+	}
+	SECTION("detecting died transmitter") {
+		const std::string name = make_name("died");
+
+		const pid_t child = fork();
+		REQUIRE(child != -1);
+		if (child == 0) {
+			// the process exits without destructors like a crashed one, so the channel isn't closed by it
+			transmitter<channel_type> transmitter{name};
+			transmitter.send(snapshot{7, 0.7});
+			_exit(0);
+		}
+
+		int status = 0;
+		REQUIRE(waitpid(child, &status, 0) == child);
+		REQUIRE(WIFEXITED(status));
+
+		const channel_type channel{name};
+		snapshot value{0, 0.0};
+		REQUIRE(channel.read_value(value));
+		CHECK(value.id == 7);
+		CHECK(channel.is_closed());
+		std::uint32_t version = channel.get_version();
+		CHECK_THROWS_AS(channel.wait_update(version), channel_error);
+
+		shm_unlink(name.c_str());
+	}
+	SECTION("reading values in another process") {
+		const std::string name = make_name("process");
+		transmitter<channel_type> transmitter{name};
+
+		const pid_t child = fork();
+		REQUIRE(child != -1);
+		if (child == 0) {
+			int exit_code = 1;
+			try {
+				const channel_type channel{name};
+				std::uint32_t version = 0;
+				snapshot value{0, 0.0};
+				if (channel.wait_update_for(version, std::chrono::seconds{10}) && channel.read_value(value) &&
+					value.id == 42)
+					exit_code = 0;
+			}
+			catch (...) {
+			}
+			_exit(exit_code);
+		}
+
+		transmitter.send(snapshot{42, 4.2});
+		int status = 0;
+		REQUIRE(waitpid(child, &status, 0) == child);
+		CHECK(WIFEXITED(status));
+		CHECK(WEXITSTATUS(status) == 0);
+	}
+	SECTION("testing comparing functions") {
+		SECTION("comparing channels without shared state") {
+			CHECK(channel_type{} == channel_type{});
+		}
+		SECTION("comparing not equal channels") {
+			const std::string name = make_name("compare");
+			const transmitter<channel_type> transmitter{name};
+
+			CHECK(transmitter.get_channel() != channel_type{name});
+		}
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
+
+#endif
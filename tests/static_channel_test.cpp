@@ -0,0 +1,155 @@
+#include <channels/static_channel.h>
+#include <channels/connection.h>
+#include <channels/error.h>
+#include <channels/transmitter.h>
+#include "tools/thread_helpers.h"
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+// it is initialized without dynamic initialization
+transmitter<static_channel<2, int>> static_transmitter;
+
+TEST_CASE("Testing class static_channel", "[static_channel]") {
+	SECTION("constructing slots at compile time") {
+		constexpr detail::static_socket<int> socket{};
+		(void) socket;
+		CHECK(static_channel<4, int>::get_capacity() == 4u);
+	}
+	SECTION("sending to channel in static storage") {
+		int sum = 0;
+		const static_connection connection =
+			static_transmitter.get_channel().connect([&sum](const int value) { sum += value; });
+
+		static_transmitter.send(1);
+		static_transmitter.send(2);
+		CHECK(sum == 3);
+	}
+	SECTION("calling callbacks in order of slots") {
+		transmitter<static_channel<3, int>> transmitter;
+		std::vector<int> values;
+		static_connection first = transmitter.get_channel().connect([&values](const int v) { values.push_back(v); });
+		const static_connection second =
+			transmitter.get_channel().connect([&values](const int v) { values.push_back(v * 10); });
+
+		transmitter.send(1);
+		CHECK(values == std::vector<int>{1, 10});
+
+		// the freed slot is taken by the next connection
+		first.disconnect();
+		CHECK_FALSE(first.is_connected());
+		first = transmitter.get_channel().connect([&values](const int v) { values.push_back(v * 100); });
+		values.clear();
+		transmitter.send(1);
+		CHECK(values == std::vector<int>{100, 10});
+	}
+	SECTION("connecting to full channel") {
+		transmitter<static_channel<1>> transmitter;
+		static_connection connection = transmitter.get_channel().connect([] {});
+
+		CHECK_THROWS_AS((void) transmitter.get_channel().connect([] {}), channel_error);
+		connection.disconnect();
+		connection = transmitter.get_channel().connect([] {});
+		CHECK(connection.is_connected());
+	}
+	SECTION("moving connection") {
+		transmitter<static_channel<1>> transmitter;
+		int calls_number = 0;
+		static_connection connection1 = transmitter.get_channel().connect([&calls_number] { ++calls_number; });
+		static_connection connection2 = std::move(connection1);
+
+		CHECK_FALSE(connection1.is_connected()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+		CHECK(connection2.is_connected());
+		transmitter.send();
+		CHECK(calls_number == 1);
+
+		connection2 = static_connection{};
+		transmitter.send();
+		CHECK(calls_number == 1);
+	}
+	SECTION("disconnecting and connecting from callback") {
+		transmitter<static_channel<2>> transmitter;
+		int counter = 0;
+		static_connection second;
+		static_connection first;
+		first = transmitter.get_channel().connect([&] {
+			++counter;
+			first.disconnect();
+			second = transmitter.get_channel().connect([&counter] { ++counter; });
+		});
+
+		// the first slot is busy until the first callback returns, so the second callback takes the next slot and is
+		// called by the same sending
+		transmitter.send();
+		CHECK(counter == 2);
+		CHECK_FALSE(first.is_connected());
+		REQUIRE(second.is_connected());
+
+		transmitter.send();
+		CHECK(counter == 3);
+	}
+	SECTION("collecting exceptions") {
+		transmitter<static_channel<3, int>> transmitter;
+		int calls_number = 0;
+		const static_connection c1 = transmitter.get_channel().connect([](int) { throw std::runtime_error{"1"}; });
+		const static_connection c2 = transmitter.get_channel().connect([&calls_number](int) { ++calls_number; });
+		const static_connection c3 = transmitter.get_channel().connect([](int) { throw std::runtime_error{"3"}; });
+
+		try {
+			transmitter.send(0);
+			FAIL("transmitter must throw callbacks_exception");
+		}
+		catch (const callbacks_exception& exception) {
+			CHECK(exception.get_exceptions().size() == 2u);
+		}
+		CHECK(calls_number == 1);
+	}
+	SECTION("destroying callbacks") {
+		transmitter<static_channel<2>> transmitter;
+		const auto counter = std::make_shared<int>(0);
+		static_connection connection = transmitter.get_channel().connect([counter] {});
+		CHECK(counter.use_count() == 2);
+
+		connection.disconnect();
+		CHECK(counter.use_count() == 1);
+	}
+	SECTION("sending from several threads while connecting and disconnecting") {
+		transmitter<static_channel<4, int>> transmitter;
+		std::atomic<int> sum{0};
+		const static_connection connection =
+			transmitter.get_channel().connect([&sum](const int value) { sum.fetch_add(value); });
+
+		std::atomic<bool> is_stopped{false};
+		std::vector<tools::joining_thread> threads;
+		for (int i = 0; i < 2; ++i) {
+			threads.emplace_back([&transmitter, &is_stopped] {
+				while (!is_stopped.load())
+					transmitter.send(1);
+			});
+		}
+		// the callbacks can be called after the disconnection while they are being destroyed
+		std::atomic<int> counter{0};
+		{
+			tools::joining_thread connecting{[&transmitter, &counter] {
+				for (int i = 0; i < 1000; ++i) {
+					const static_connection c =
+						transmitter.get_channel().connect([&counter](int) { counter.fetch_add(1); });
+				}
+			}};
+		}
+		is_stopped.store(true);
+		threads.clear();
+		CHECK(sum.load() > 0);
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
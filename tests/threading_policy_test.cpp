@@ -0,0 +1,132 @@
+#include <channels/threading_policy.h>
+#include <channels/buffered_channel.h>
+#include <channels/channel.h>
+#include <channels/keyed_channel.h>
+#include <channels/transmitter.h>
+#include <catch2/catch.hpp>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace channels {
+namespace test {
+namespace {
+
+struct mouse_event {
+	int x;
+};
+
+} // namespace
+} // namespace test
+
+template<>
+struct threading_policy_traits<channel<test::mouse_event>> {
+	using type = policy::single_thread;
+};
+
+template<>
+struct threading_policy_traits<buffered_channel<test::mouse_event>> {
+	using type = policy::single_thread;
+};
+
+template<>
+struct threading_policy_traits<keyed_channel<int, test::mouse_event>> {
+	using type = policy::single_thread;
+};
+
+namespace test {
+namespace {
+
+TEST_CASE("Testing threading policies", "[threading_policy]") {
+	SECTION("checking mutexes selected by policies") {
+		CHECK(std::is_same<detail::policy_mutex_t<policy::multi_thread, std::mutex>, std::mutex>::value);
+		CHECK(std::is_same<detail::policy_mutex_t<policy::single_thread, std::mutex>, detail::null_mutex>::value);
+	}
+	SECTION("sending to single-threaded channel") {
+		transmitter<channel<mouse_event>> transmitter;
+		std::vector<int> values;
+		const connection first = transmitter.get_channel().connect([&values](const mouse_event& event) {
+			values.push_back(event.x);
+		});
+		const connection second = transmitter.get_channel().connect(priority{1}, [&values](const mouse_event& event) {
+			values.push_back(-event.x);
+		});
+
+		transmitter.send(mouse_event{1});
+		CHECK(values == std::vector<int>{-1, 1});
+	}
+	SECTION("connecting and disconnecting from callback of single-threaded channel") {
+		transmitter<channel<mouse_event>> transmitter;
+		int first_calls = 0;
+		int second_calls = 0;
+		connection second;
+		connection first = transmitter.get_channel().connect([&](const mouse_event&) {
+			++first_calls;
+			if (first_calls == 1)
+				second = transmitter.get_channel().connect([&second_calls](const mouse_event&) { ++second_calls; });
+			else if (first_calls == 3)
+				second.disconnect();
+		});
+
+		transmitter.send(mouse_event{1});
+		CHECK(first_calls == 1);
+		CHECK(second_calls == 0);
+
+		transmitter.send(mouse_event{2});
+		CHECK(first_calls == 2);
+		CHECK(second_calls == 1);
+
+		transmitter.send(mouse_event{3});
+		CHECK(first_calls == 3);
+		CHECK(second_calls == 1);
+		CHECK_FALSE(second.is_connected());
+
+		first.disconnect();
+		transmitter.send(mouse_event{4});
+		CHECK(first_calls == 3);
+	}
+	SECTION("handing single-threaded channel to another thread") {
+		transmitter<channel<mouse_event>> transmitter;
+		std::vector<int> values;
+
+		std::thread thread{[&transmitter, &values] {
+			const connection connection = transmitter.get_channel().connect([&values](const mouse_event& event) {
+				values.push_back(event.x);
+			});
+			transmitter.send(mouse_event{1});
+		}};
+		thread.join();
+		CHECK(values == std::vector<int>{1});
+	}
+	SECTION("reading value of single-threaded buffered channel") {
+		transmitter<buffered_channel<mouse_event>> transmitter;
+		int x = 0;
+		const connection connection =
+			transmitter.get_channel().connect([&x](const mouse_event& event) { x = event.x; });
+
+		transmitter.send(mouse_event{5});
+		CHECK(x == 5);
+		REQUIRE(transmitter.get_channel().get_value());
+		CHECK(std::get<0>(*transmitter.get_channel().get_value()).x == 5);
+	}
+	SECTION("sending to single-threaded keyed channel") {
+		transmitter<keyed_channel<int, mouse_event>> transmitter;
+		std::vector<int> values;
+		const connection first = transmitter.get_channel().connect(1, [&values](const mouse_event& event) {
+			values.push_back(event.x);
+		});
+		const connection all = transmitter.get_channel().connect_all([&values](const mouse_event& event) {
+			values.push_back(-event.x);
+		});
+
+		transmitter.send(1, mouse_event{1});
+		transmitter.send(2, mouse_event{2});
+		CHECK(values == std::vector<int>{1, -1, -2});
+	}
+}
+
+} // namespace
+} // namespace test
+} // namespace channels
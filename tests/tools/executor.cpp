@@ -10,12 +10,21 @@ namespace tools {
 void executor::dispatch(task_type task)
 {
 	tasks_.push_back(std::move(task));
+	++tasks_number_;
 }
 
 void executor::run_all_tasks()
 {
-	for (const task_type& task : tasks_)
+	while (!tasks_.empty()) {
+		const task_type task = std::move(tasks_.front());
+		tasks_.pop_front();
 		task();
+	}
+}
+
+std::size_t executor::get_tasks_number() const noexcept
+{
+	return tasks_number_;
 }
 
 // async_executor
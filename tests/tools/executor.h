@@ -2,6 +2,7 @@
 #include "thread_helpers.h"
 #include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -20,10 +21,15 @@ public:
 
 	void dispatch(task_type task);
 
+	// Runs the tasks that haven't been run yet, including the ones dispatched by the running tasks.
 	void run_all_tasks();
 
+	// Returns the number of all dispatched tasks.
+	std::size_t get_tasks_number() const noexcept;
+
 private:
-	std::vector<task_type> tasks_;
+	std::deque<task_type> tasks_;
+	std::size_t tasks_number_ = 0;
 };
 
 template<typename Task>